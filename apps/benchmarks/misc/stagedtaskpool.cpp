@@ -0,0 +1,228 @@
+#include <benchmark/benchmark.h>
+
+#include <components/misc/barrier.hpp>
+#include <components/misc/stagedtaskpool.hpp>
+
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // Roughly the structure of a physics frame: a few simulation steps, each with a serial part before and after
+    // moving all actors, followed by the refresh of the line of sight cache
+    constexpr int sNumSteps = 2;
+    constexpr std::size_t sLOSPerActor = 2;
+
+    struct World
+    {
+        std::vector<float> mActors;
+        std::vector<float> mLOS;
+
+        explicit World(std::size_t numActors)
+            : mActors(numActors, 1.f)
+            , mLOS(numActors * sLOSPerActor, 1.f)
+        {
+        }
+
+        // A few microseconds, like a movement solve
+        void moveActor(std::size_t index)
+        {
+            float value = mActors[index];
+            for (int i = 0; i < 500; ++i)
+                value = std::sqrt(value * value + 1.f) - 0.5f;
+            mActors[index] = value;
+        }
+
+        void refreshLOS(std::size_t index)
+        {
+            float value = mLOS[index];
+            for (int i = 0; i < 100; ++i)
+                value = std::sqrt(value * value + 1.f) - 0.5f;
+            mLOS[index] = value;
+        }
+
+        void serialStep()
+        {
+            benchmark::DoNotOptimize(mActors.data());
+        }
+    };
+
+    // Lockstep simulation where every thread goes through every barrier, as done by the physics scheduler before
+    class BarrierSimulation
+    {
+    public:
+        BarrierSimulation(World& world, int numThreads)
+            : mWorld(world)
+            , mPreStep(numThreads)
+            , mPostStep(numThreads)
+            , mPostSim(numThreads)
+        {
+            for (int i = 0; i < numThreads; ++i)
+                mThreads.emplace_back([this] { run(); });
+        }
+
+        ~BarrierSimulation()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mQuit = true;
+            }
+            mHasJob.notify_all();
+            for (std::thread& thread : mThreads)
+                thread.join();
+        }
+
+        void simulate()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mRemainingSteps = sNumSteps;
+                mNextJob = 0;
+                mNextLOS = 0;
+                ++mFrame;
+            }
+            mHasJob.notify_all();
+            std::unique_lock<std::mutex> lock(mMutex);
+            mDone.wait(lock, [this] { return mFinishedFrame == mFrame; });
+        }
+
+    private:
+        void run()
+        {
+            std::size_t frame = 0;
+            std::unique_lock<std::mutex> lock(mMutex);
+            while (true)
+            {
+                mHasJob.wait(lock, [&] { return mQuit || mFrame != frame; });
+                if (mQuit)
+                    return;
+                frame = mFrame;
+                lock.unlock();
+                simulateFrame();
+                lock.lock();
+            }
+        }
+
+        void simulateFrame()
+        {
+            while (mRemainingSteps)
+            {
+                mPreStep.wait([this] { mWorld.serialStep(); });
+                std::size_t job;
+                while ((job = mNextJob.fetch_add(1, std::memory_order_relaxed)) < mWorld.mActors.size())
+                    mWorld.moveActor(job);
+                mPostStep.wait([this] { --mRemainingSteps; mNextJob = 0; mWorld.serialStep(); });
+            }
+            std::size_t job;
+            while ((job = mNextLOS.fetch_add(1, std::memory_order_relaxed)) < mWorld.mLOS.size())
+                mWorld.refreshLOS(job);
+            mPostSim.wait([this]
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mFinishedFrame = mFrame;
+                mDone.notify_all();
+            });
+        }
+
+        World& mWorld;
+        Misc::Barrier mPreStep;
+        Misc::Barrier mPostStep;
+        Misc::Barrier mPostSim;
+        std::atomic<int> mRemainingSteps {0};
+        std::atomic<std::size_t> mNextJob {0};
+        std::atomic<std::size_t> mNextLOS {0};
+        std::mutex mMutex;
+        std::condition_variable mHasJob;
+        std::condition_variable mDone;
+        std::size_t mFrame = 0;
+        std::size_t mFinishedFrame = 0;
+        bool mQuit = false;
+        std::vector<std::thread> mThreads;
+    };
+
+    enum class Stage
+    {
+        PreStep,
+        Move,
+        PostStep,
+        LOS,
+        Done,
+    };
+
+    std::optional<Misc::StagedTaskPool::Stage> nextStage(World& world, Stage& stage, int& remainingSteps)
+    {
+        switch (stage)
+        {
+            case Stage::PreStep:
+                if (remainingSteps == 0)
+                {
+                    stage = Stage::LOS;
+                    return nextStage(world, stage, remainingSteps);
+                }
+                stage = Stage::Move;
+                return Misc::StagedTaskPool::Stage {1, 1, [&] (std::size_t, std::size_t) { world.serialStep(); }};
+            case Stage::Move:
+                stage = Stage::PostStep;
+                return Misc::StagedTaskPool::Stage {world.mActors.size(), 2, [&] (std::size_t begin, std::size_t end)
+                {
+                    for (std::size_t i = begin; i < end; ++i)
+                        world.moveActor(i);
+                }};
+            case Stage::PostStep:
+                stage = Stage::PreStep;
+                return Misc::StagedTaskPool::Stage {1, 1, [&] (std::size_t, std::size_t) { --remainingSteps; world.serialStep(); }};
+            case Stage::LOS:
+                stage = Stage::Done;
+                return Misc::StagedTaskPool::Stage {world.mLOS.size(), 8, [&] (std::size_t begin, std::size_t end)
+                {
+                    for (std::size_t i = begin; i < end; ++i)
+                        world.refreshLOS(i);
+                }};
+            case Stage::Done:
+                break;
+        }
+        return std::nullopt;
+    }
+
+    void barrierSimulation(benchmark::State& state)
+    {
+        World world(static_cast<std::size_t>(state.range(0)));
+        BarrierSimulation simulation(world, static_cast<int>(state.range(1)));
+        for (auto _ : state)
+            simulation.simulate();
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    void stagedTaskPoolSimulation(benchmark::State& state)
+    {
+        World world(static_cast<std::size_t>(state.range(0)));
+        Misc::StagedTaskPool pool(static_cast<unsigned int>(state.range(1)));
+        for (auto _ : state)
+        {
+            Stage stage = Stage::PreStep;
+            int remainingSteps = sNumSteps;
+            pool.start([&] { return nextStage(world, stage, remainingSteps); });
+            pool.wait();
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    // Number of actors and number of threads
+    void simulationArgs(benchmark::internal::Benchmark* benchmark)
+    {
+        for (int actors : {4, 16, 64, 256})
+            for (int threads : {1, 2, 4, 8})
+                benchmark->Args({actors, threads});
+    }
+} // namespace
+
+BENCHMARK(barrierSimulation)->Apply(simulationArgs)->UseRealTime();
+BENCHMARK(stagedTaskPoolSimulation)->Apply(simulationArgs)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,113 @@
+#include <benchmark/benchmark.h>
+
+#include "apps/openmw/mwdialogue/keywordsearch.hpp"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using KeywordSearch = MWDialogue::KeywordSearch<std::string, int>;
+
+    // About the number of topics of Morrowind with both expansions
+    constexpr std::size_t sNumTopics = 3000;
+
+    const std::vector<std::string> sSyllables = {
+        "ald", "bal", "ca", "dar", "el", "fa", "gul", "hla", "in", "ka", "lo", "mo", "na", "or", "ra", "sa",
+        "tel", "ur", "va", "vi", "wa", "ye", "za", "dwe", "mer", "vos", "ruhn", "ith", "an", "is",
+    };
+
+    template <class Random>
+    std::string generateWord(Random& random)
+    {
+        std::uniform_int_distribution<std::size_t> syllable(0, sSyllables.size() - 1);
+        std::uniform_int_distribution<int> length(1, 4);
+        std::string result;
+        for (int i = length(random); i > 0; --i)
+            result += sSyllables[syllable(random)];
+        return result;
+    }
+
+    // Topics of one to four words, like "background" or "report to caius cosades"
+    template <class Random>
+    std::vector<std::string> generateTopics(std::size_t count, Random& random)
+    {
+        std::uniform_int_distribution<int> words(1, 4);
+        std::vector<std::string> result;
+        while (result.size() < count)
+        {
+            std::string topic = generateWord(random);
+            for (int i = words(random); i > 1; --i)
+                topic += ' ' + generateWord(random);
+            result.push_back(std::move(topic));
+        }
+        std::sort(result.begin(), result.end());
+        result.erase(std::unique(result.begin(), result.end()), result.end());
+        return result;
+    }
+
+    // Words with a topic from time to time, like a dialogue response or a journal page
+    template <class Random>
+    std::string generateText(std::size_t size, const std::vector<std::string>& topics, Random& random)
+    {
+        std::uniform_int_distribution<std::size_t> topic(0, topics.size() - 1);
+        std::uniform_int_distribution<int> kind(0, 9);
+        std::string result;
+        while (result.size() < size)
+        {
+            if (kind(random) == 0)
+                result += topics[topic(random)];
+            else
+                result += generateWord(random);
+            result += kind(random) == 0 ? ". " : " ";
+        }
+        return result;
+    }
+
+    KeywordSearch makeSearch(const std::vector<std::string>& topics)
+    {
+        KeywordSearch search;
+        for (std::size_t i = 0; i < topics.size(); ++i)
+            search.seed(topics[i], static_cast<int>(i));
+        return search;
+    }
+
+    void seedTopics(benchmark::State& state)
+    {
+        std::minstd_rand random;
+        const std::vector<std::string> topics = generateTopics(sNumTopics, random);
+        const std::string text = "a";
+        std::vector<KeywordSearch::Match> matches;
+        for (auto _ : state)
+        {
+            // Includes building the links with the first search
+            KeywordSearch search = makeSearch(topics);
+            search.highlightKeywords(text.begin(), text.end(), matches);
+            benchmark::DoNotOptimize(search);
+        }
+    }
+
+    void highlightKeywords(benchmark::State& state)
+    {
+        std::minstd_rand random;
+        const std::vector<std::string> topics = generateTopics(sNumTopics, random);
+        const std::string text = generateText(static_cast<std::size_t>(state.range(0)), topics, random);
+        const KeywordSearch search = makeSearch(topics);
+        std::vector<KeywordSearch::Match> matches;
+        for (auto _ : state)
+        {
+            matches.clear();
+            search.highlightKeywords(text.begin(), text.end(), matches);
+            benchmark::DoNotOptimize(matches);
+        }
+        state.SetBytesProcessed(state.iterations() * state.range(0));
+    }
+}
+
+BENCHMARK(seedTopics);
+// A dialogue response, a journal page and a whole journal
+BENCHMARK(highlightKeywords)->Arg(512)->Arg(4 * 1024)->Arg(256 * 1024);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,593 @@
+#include <benchmark/benchmark.h>
+
+#include "apps/openmw/mwmechanics/spelllist.hpp"
+#include "apps/openmw/mwworld/esmloader.hpp"
+#include "apps/openmw/mwworld/esmstore.hpp"
+
+#include <components/esm3/cellref.hpp>
+#include <components/esm3/esmreader.hpp>
+#include <components/esm3/esmwriter.hpp>
+#include <components/esm3/loadcell.hpp>
+#include <components/esm3/loadland.hpp>
+#include <components/esm3/savedgame.hpp>
+#include <components/files/collections.hpp>
+#include <components/loadinglistener/loadinglistener.hpp>
+#include <components/misc/stringops.hpp>
+#include <components/to_utf8/to_utf8.hpp>
+
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <optional>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+namespace MWMechanics
+{
+    SpellList::SpellList(const std::string& id, int type) : mId(id), mType(type) {}
+}
+
+namespace
+{
+    std::atomic<std::uint64_t> sNumAllocations {0};
+    std::atomic<std::uint64_t> sAllocatedBytes {0};
+}
+
+// Count all allocations, so that the numbers can be compared between runs. Only the timed parts of each benchmark
+// are reported.
+void* operator new(std::size_t size)
+{
+    sNumAllocations.fetch_add(1, std::memory_order_relaxed);
+    sAllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* result = std::malloc(size == 0 ? 1 : size))
+        return result;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+namespace
+{
+    struct Options
+    {
+        std::vector<boost::filesystem::path> mContentFiles;
+        std::string mEncoding = "win1252";
+        std::string mCell;
+        std::string mSavegame;
+    };
+
+    Options sOptions;
+    Loading::Listener sListener;
+
+    std::int64_t getRss()
+    {
+#ifdef __linux__
+        long pages = 0;
+        long rss = 0;
+        if (FILE* file = std::fopen("/proc/self/statm", "r"))
+        {
+            if (std::fscanf(file, "%ld %ld", &pages, &rss) != 2)
+                rss = 0;
+            std::fclose(file);
+        }
+        return static_cast<std::int64_t>(rss) * sysconf(_SC_PAGESIZE);
+#else
+        return 0;
+#endif
+    }
+
+    std::int64_t getPeakRss()
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) != 0)
+            return 0;
+#ifdef __APPLE__
+        return usage.ru_maxrss;
+#else
+        return static_cast<std::int64_t>(usage.ru_maxrss) * 1024;
+#endif
+#else
+        return 0;
+#endif
+    }
+
+    // Allocations and memory of the measured parts of a benchmark, reported as counters of the JSON output
+    class Measurement
+    {
+    public:
+        void start()
+        {
+            mStartAllocations = sNumAllocations.load(std::memory_order_relaxed);
+            mStartBytes = sAllocatedBytes.load(std::memory_order_relaxed);
+        }
+
+        void stop()
+        {
+            mAllocations += sNumAllocations.load(std::memory_order_relaxed) - mStartAllocations;
+            mBytes += sAllocatedBytes.load(std::memory_order_relaxed) - mStartBytes;
+            mRss = std::max(mRss, getRss());
+        }
+
+        void report(benchmark::State& state) const
+        {
+            using benchmark::Counter;
+            state.counters["allocations"] = Counter(static_cast<double>(mAllocations), Counter::kAvgIterations);
+            state.counters["allocated_bytes"] = Counter(static_cast<double>(mBytes), Counter::kAvgIterations,
+                Counter::OneK::kIs1024);
+            state.counters["rss"] = Counter(static_cast<double>(mRss), Counter::kDefaults, Counter::OneK::kIs1024);
+            state.counters["peak_rss"] = Counter(static_cast<double>(getPeakRss()), Counter::kDefaults,
+                Counter::OneK::kIs1024);
+        }
+
+    private:
+        std::uint64_t mStartAllocations = 0;
+        std::uint64_t mStartBytes = 0;
+        std::uint64_t mAllocations = 0;
+        std::uint64_t mBytes = 0;
+        std::int64_t mRss = 0;
+    };
+
+    // The content files loaded like World::loadContentFiles does
+    struct Content
+    {
+        ToUTF8::Utf8Encoder mEncoder;
+        std::vector<ESM::ESMReader> mReaders;
+        MWWorld::ESMStore mStore;
+
+        Content()
+            : mEncoder(ToUTF8::calculateEncoding(sOptions.mEncoding))
+            , mReaders(sOptions.mContentFiles.size())
+        {
+        }
+
+        void load()
+        {
+            MWWorld::EsmLoader loader(mStore, mReaders, &mEncoder);
+            for (int i = 0; i < static_cast<int>(sOptions.mContentFiles.size()); ++i)
+            {
+                int index = i;
+                loader.load(sOptions.mContentFiles[i], index, &sListener);
+            }
+        }
+    };
+
+    // Records of a saved game. ESMStore reads its own records, the state of all other managers is kept as raw
+    // subrecords.
+    struct Savegame
+    {
+        struct Record
+        {
+            ESM::NAME mName;
+            std::uint32_t mFlags;
+            std::vector<std::pair<ESM::NAME, std::string>> mSubRecords;
+        };
+
+        ESM::SavedGame mProfile;
+        std::vector<Record> mRecords;
+
+        void load(const std::string& path, MWWorld::ESMStore& store)
+        {
+            ESM::ESMReader reader;
+            reader.open(path);
+            if (reader.getFormat() > ESM::SavedGame::sCurrentFormat)
+                throw std::runtime_error("Unsupported saved game format: " + path);
+
+            while (reader.hasMoreRecs())
+            {
+                const ESM::NAME name = reader.getRecName();
+                reader.getRecHeader();
+
+                if (name.toInt() == ESM::REC_SAVE)
+                {
+                    mProfile.load(reader);
+                    continue;
+                }
+
+                if (store.readRecord(reader, name.toInt()))
+                    continue;
+
+                Record& record = mRecords.emplace_back();
+                record.mName = name;
+                record.mFlags = reader.getRecordFlags();
+                while (reader.hasMoreSubs())
+                {
+                    reader.getSubName();
+                    reader.getSubHeader();
+                    auto& [subName, data] = record.mSubRecords.emplace_back();
+                    subName = reader.retSubName();
+                    data.resize(reader.getSubSize());
+                    reader.getExact(data.data(), static_cast<int>(data.size()));
+                }
+            }
+        }
+
+        std::size_t save(const MWWorld::ESMStore& store) const
+        {
+            std::stringstream stream;
+            ESM::ESMWriter writer;
+            for (const boost::filesystem::path& contentFile : sOptions.mContentFiles)
+                writer.addMaster(contentFile.filename().string(), 0);
+            writer.setFormat(ESM::SavedGame::sCurrentFormat);
+            writer.setVersion(0);
+            writer.setType(0);
+            writer.setAuthor("");
+            writer.setDescription("");
+            writer.setRecordCount(1 + store.countSavedGameRecords() + static_cast<int>(mRecords.size()));
+            writer.save(stream);
+
+            writer.startRecord(ESM::REC_SAVE);
+            mProfile.save(writer);
+            writer.endRecord(ESM::REC_SAVE);
+
+            store.write(writer, sListener);
+
+            for (const Record& record : mRecords)
+            {
+                writer.startRecord(record.mName, record.mFlags);
+                for (const auto& [subName, data] : record.mSubRecords)
+                {
+                    writer.startSubRecord(subName);
+                    writer.write(data.data(), data.size());
+                    writer.endRecord(subName);
+                }
+                writer.endRecord(record.mName);
+            }
+
+            writer.close();
+            if (stream.fail())
+                throw std::runtime_error("Failed to write saved game");
+            return static_cast<std::size_t>(stream.tellp());
+        }
+    };
+
+    // Content loaded and set up once, shared by the benchmarks of later phases
+    Content& getContent()
+    {
+        static const std::unique_ptr<Content> content = []
+        {
+            auto result = std::make_unique<Content>();
+            result->load();
+            result->mStore.setUp(true);
+            return result;
+        } ();
+        return *content;
+    }
+
+    const Savegame& getSavegame()
+    {
+        static const std::unique_ptr<Savegame> savegame = []
+        {
+            auto result = std::make_unique<Savegame>();
+            result->load(sOptions.mSavegame, getContent().mStore);
+            return result;
+        } ();
+        return *savegame;
+    }
+
+    bool checkContent(benchmark::State& state)
+    {
+        if (sOptions.mContentFiles.empty())
+        {
+            state.SkipWithError("No content files, use --data and --content");
+            return false;
+        }
+        try
+        {
+            getContent();
+        }
+        catch (const std::exception& e)
+        {
+            state.SkipWithError(e.what());
+            return false;
+        }
+        return true;
+    }
+
+    bool checkSavegame(benchmark::State& state)
+    {
+        if (!checkContent(state))
+            return false;
+        if (sOptions.mSavegame.empty())
+        {
+            state.SkipWithError("No saved game, use --savegame");
+            return false;
+        }
+        try
+        {
+            getSavegame();
+        }
+        catch (const std::exception& e)
+        {
+            state.SkipWithError(e.what());
+            return false;
+        }
+        return true;
+    }
+
+    // The data part of Scene::changePlayerCell: references of the cell, and for an exterior the grid of cells
+    // around it with their land, like CellStore::loadRefs and the terrain storage read them. Rendering and physics
+    // are not included.
+    std::size_t loadCell(Content& content, const ESM::Cell& cell)
+    {
+        std::size_t numReferences = 0;
+        for (std::size_t i = 0; i < cell.mContextList.size(); ++i)
+        {
+            ESM::ESMReader& reader = content.mReaders[cell.mContextList[i].index];
+            cell.restore(reader, static_cast<int>(i));
+
+            ESM::CellRef ref;
+            ref.mRefNum.unset();
+            ESM::MovedCellRef movedRef;
+            movedRef.mRefNum.mIndex = 0;
+            bool deleted = false;
+            bool moved = false;
+            while (ESM::Cell::getNextRef(reader, ref, deleted, movedRef, moved,
+                ESM::Cell::GetNextRefMode::LoadOnlyNotMoved))
+            {
+                if (moved)
+                    continue;
+                Misc::StringUtils::lowerCaseInPlace(ref.mRefID);
+                benchmark::DoNotOptimize(content.mStore.find(ref.mRefID));
+                ++numReferences;
+            }
+        }
+
+        if (cell.isExterior())
+        {
+            if (const ESM::Land* land = content.mStore.get<ESM::Land>().search(cell.getGridX(), cell.getGridY()))
+            {
+                ESM::Land::LandData data;
+                land->loadData(ESM::Land::DATA_VHGT | ESM::Land::DATA_VNML | ESM::Land::DATA_VCLR
+                    | ESM::Land::DATA_VTEX, &data);
+                benchmark::DoNotOptimize(data.mHeights);
+            }
+        }
+
+        return numReferences;
+    }
+
+    std::vector<const ESM::Cell*> findCells(const MWWorld::ESMStore& store)
+    {
+        const MWWorld::Store<ESM::Cell>& cells = store.get<ESM::Cell>();
+        std::vector<const ESM::Cell*> result;
+
+        std::smatch match;
+        static const std::regex exterior("(-?[0-9]+),(-?[0-9]+)");
+        // Without a start cell, a new game puts the player into the exterior at 0, 0
+        const std::string name = sOptions.mCell.empty() ? "0,0" : sOptions.mCell;
+        if (!std::regex_match(name, match, exterior))
+        {
+            if (const ESM::Cell* cell = cells.search(name))
+                result.push_back(cell);
+            return result;
+        }
+
+        // The default exterior cell load distance of 1
+        const int x = std::stoi(match[1]);
+        const int y = std::stoi(match[2]);
+        for (int cellX = x - 1; cellX <= x + 1; ++cellX)
+            for (int cellY = y - 1; cellY <= y + 1; ++cellY)
+                if (const ESM::Cell* cell = cells.search(cellX, cellY))
+                    result.push_back(cell);
+        return result;
+    }
+
+    void loadContent(benchmark::State& state)
+    {
+        if (sOptions.mContentFiles.empty())
+        {
+            state.SkipWithError("No content files, use --data and --content");
+            return;
+        }
+
+        Measurement measurement;
+        for (auto _ : state)
+        {
+            measurement.start();
+            auto content = std::make_unique<Content>();
+            content->load();
+            measurement.stop();
+
+            state.PauseTiming();
+            content.reset();
+            state.ResumeTiming();
+        }
+        measurement.report(state);
+    }
+
+    void setUpStore(benchmark::State& state)
+    {
+        if (!checkContent(state))
+            return;
+
+        Measurement measurement;
+        for (auto _ : state)
+        {
+            state.PauseTiming();
+            auto content = std::make_unique<Content>();
+            content->load();
+            state.ResumeTiming();
+
+            measurement.start();
+            content->mStore.setUp(true);
+            measurement.stop();
+
+            state.PauseTiming();
+            content.reset();
+            state.ResumeTiming();
+        }
+        measurement.report(state);
+    }
+
+    void loadFirstCell(benchmark::State& state)
+    {
+        if (!checkContent(state))
+            return;
+
+        Content& content = getContent();
+        const std::vector<const ESM::Cell*> cells = findCells(content.mStore);
+        if (cells.empty())
+        {
+            state.SkipWithError(("Cell not found: " + sOptions.mCell).c_str());
+            return;
+        }
+
+        Measurement measurement;
+        std::size_t numReferences = 0;
+        for (auto _ : state)
+        {
+            measurement.start();
+            numReferences = 0;
+            for (const ESM::Cell* cell : cells)
+                numReferences += loadCell(content, *cell);
+            measurement.stop();
+        }
+        measurement.report(state);
+        state.counters["cells"] = static_cast<double>(cells.size());
+        state.counters["references"] = static_cast<double>(numReferences);
+    }
+
+    void loadSavegame(benchmark::State& state)
+    {
+        if (!checkSavegame(state))
+            return;
+
+        MWWorld::ESMStore& store = getContent().mStore;
+        Measurement measurement;
+        for (auto _ : state)
+        {
+            state.PauseTiming();
+            store.clearDynamic();
+            auto savegame = std::make_unique<Savegame>();
+            state.ResumeTiming();
+
+            measurement.start();
+            savegame->load(sOptions.mSavegame, store);
+            measurement.stop();
+
+            state.PauseTiming();
+            savegame.reset();
+            state.ResumeTiming();
+        }
+        measurement.report(state);
+    }
+
+    void saveSavegame(benchmark::State& state)
+    {
+        if (!checkSavegame(state))
+            return;
+
+        const Savegame& savegame = getSavegame();
+        const MWWorld::ESMStore& store = getContent().mStore;
+        Measurement measurement;
+        std::size_t size = 0;
+        for (auto _ : state)
+        {
+            measurement.start();
+            size = savegame.save(store);
+            measurement.stop();
+        }
+        measurement.report(state);
+        state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * size));
+    }
+
+    std::optional<int> parseOptions(int argc, char** argv)
+    {
+        namespace bpo = boost::program_options;
+
+        bpo::options_description description("Data options, in addition to the benchmark options");
+        description.add_options()
+            ("help", "print help message")
+            ("data", bpo::value<std::vector<std::string>>()->default_value({}, "")->multitoken()->composing(),
+                "data directories, with increasing priority")
+            ("content", bpo::value<std::vector<std::string>>()->default_value({}, "")->multitoken()->composing(),
+                "content files, in load order")
+            ("encoding", bpo::value<std::string>()->default_value("win1252"), "encoding of the content files")
+            ("cell", bpo::value<std::string>()->default_value(""),
+                "first cell: interior name or exterior grid position as x,y (default 0,0)")
+            ("savegame", bpo::value<std::string>()->default_value(""), "saved game to load and save");
+
+        bpo::variables_map variables;
+        try
+        {
+            bpo::store(bpo::parse_command_line(argc, argv, description), variables);
+            bpo::notify(variables);
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << e.what() << std::endl << description << std::endl;
+            return 1;
+        }
+
+        if (variables.count("help"))
+        {
+            std::cout << description << std::endl;
+            return 0;
+        }
+
+        Files::PathContainer dataDirs;
+        for (const std::string& dir : variables["data"].as<std::vector<std::string>>())
+            dataDirs.emplace_back(dir);
+        const Files::Collections collections(dataDirs, true);
+
+        try
+        {
+            for (const std::string& file : variables["content"].as<std::vector<std::string>>())
+                if (!Misc::StringUtils::ciEndsWith(file, ".omwscripts"))
+                    sOptions.mContentFiles.push_back(collections.getPath(file));
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+
+        sOptions.mEncoding = variables["encoding"].as<std::string>();
+        sOptions.mCell = variables["cell"].as<std::string>();
+        sOptions.mSavegame = variables["savegame"].as<std::string>();
+        return std::nullopt;
+    }
+}
+
+// The phases of starting the engine and loading a game, without a window. Use --benchmark_format=json or
+// --benchmark_out to track the timing, allocation and RSS counters.
+BENCHMARK(loadContent)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(setUpStore)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(loadFirstCell)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(loadSavegame)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(saveSavegame)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+int main(int argc, char** argv)
+{
+    // Removes the benchmark options and leaves the data options
+    benchmark::Initialize(&argc, argv);
+    if (const std::optional<int> result = parseOptions(argc, argv))
+        return *result;
+    benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
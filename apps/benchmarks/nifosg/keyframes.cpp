@@ -0,0 +1,211 @@
+#include <benchmark/benchmark.h>
+
+#include <components/files/constrainedfilestream.hpp>
+#include <components/nif/data.hpp>
+#include <components/nif/niffile.hpp>
+#include <components/nifosg/controller.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using namespace NifOsg;
+
+    struct Tracks
+    {
+        std::vector<Nif::QuaternionKeyMapPtr> mRotations;
+        std::vector<Nif::Vector3KeyMapPtr> mTranslations;
+    };
+
+    template <class KeyMap, class Random, class GenerateValue>
+    std::shared_ptr<KeyMap> generateTrack(std::size_t count, bool evenlySpaced, Random& random, GenerateValue&& generateValue)
+    {
+        std::uniform_real_distribution<float> jitter(0.25f, 1.75f);
+        auto result = std::make_shared<KeyMap>();
+        result->mInterpolationType = Nif::InterpolationType_Linear;
+        std::vector<std::pair<float, typename KeyMap::KeyType>> keys;
+        float time = 0;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            typename KeyMap::KeyType key {};
+            key.mValue = generateValue(random);
+            keys.emplace_back(time, key);
+            time += (evenlySpaced ? 1.f : jitter(random)) / 30.f;
+        }
+        result->setKeys(std::move(keys));
+        return result;
+    }
+
+    // Roughly matches a creature or NPC animation: dozens of bones with a few hundred keys each
+    Tracks generateTracks(bool evenlySpaced)
+    {
+        std::minstd_rand random;
+        std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+        Tracks result;
+        for (std::size_t i = 0; i < 40; ++i)
+        {
+            result.mRotations.push_back(generateTrack<Nif::QuaternionKeyMap>(300, evenlySpaced, random,
+                [&] (auto& r) { osg::Quat q(distribution(r), distribution(r), distribution(r), 1.f); return q / q.length(); }));
+            result.mTranslations.push_back(generateTrack<Nif::Vector3KeyMap>(300, evenlySpaced, random,
+                [&] (auto& r) { return osg::Vec3f(distribution(r), distribution(r), distribution(r)); }));
+        }
+        return result;
+    }
+
+    Tracks loadTracks(const std::string& path)
+    {
+        Nif::NIFFile file(Files::openConstrainedFileStream(path), path);
+        Tracks result;
+        for (std::size_t i = 0; i < file.numRecords(); ++i)
+        {
+            const auto* data = dynamic_cast<const Nif::NiKeyframeData*>(file.getRecord(i));
+            if (data == nullptr)
+                continue;
+            if (data->mRotations && !data->mRotations->empty())
+                result.mRotations.push_back(data->mRotations);
+            if (data->mTranslations && !data->mTranslations->empty())
+                result.mTranslations.push_back(data->mTranslations);
+        }
+        return result;
+    }
+
+    float getDuration(const Tracks& tracks)
+    {
+        float result = 0;
+        for (const auto& track : tracks.mRotations)
+            result = std::max(result, track->mTimes.back());
+        for (const auto& track : tracks.mTranslations)
+            result = std::max(result, track->mTimes.back());
+        return result;
+    }
+
+    // Evaluate every track at every frame, like the keyframe controllers of a playing animation do
+    void evaluate(benchmark::State& state, const Tracks& tracks)
+    {
+        std::vector<QuaternionInterpolator> rotations(tracks.mRotations.begin(), tracks.mRotations.end());
+        std::vector<Vec3Interpolator> translations(tracks.mTranslations.begin(), tracks.mTranslations.end());
+        const float duration = getDuration(tracks);
+        const float step = 1.f / 60.f;
+        float time = 0;
+        for (auto _ : state)
+        {
+            for (const auto& interpolator : rotations)
+                benchmark::DoNotOptimize(interpolator.interpKey(time));
+            for (const auto& interpolator : translations)
+                benchmark::DoNotOptimize(interpolator.interpKey(time));
+            time += step;
+            if (time > duration)
+                time = 0;
+        }
+        state.SetItemsProcessed(state.iterations() * (rotations.size() + translations.size()));
+    }
+
+    // Plain lookups in std::map based key storage as used before, for comparison
+    template <class KeyMap>
+    std::map<float, typename KeyMap::KeyType> toMap(const KeyMap& keys)
+    {
+        std::map<float, typename KeyMap::KeyType> result;
+        for (std::size_t i = 0; i < keys.size(); ++i)
+            result.emplace(keys.mTimes[i], keys.mValues[i]);
+        return result;
+    }
+
+    void evaluateMap(benchmark::State& state, const Tracks& tracks)
+    {
+        std::vector<std::map<float, Nif::QuaternionKey>> rotations;
+        for (const auto& track : tracks.mRotations)
+            rotations.push_back(toMap(*track));
+        std::vector<std::map<float, Nif::Vector3Key>> translations;
+        for (const auto& track : tracks.mTranslations)
+            translations.push_back(toMap(*track));
+        const float duration = getDuration(tracks);
+        const float step = 1.f / 60.f;
+        float time = 0;
+        for (auto _ : state)
+        {
+            for (const auto& keys : rotations)
+            {
+                auto it = keys.lower_bound(time);
+                if (it == keys.begin() || it == keys.end())
+                    continue;
+                auto low = std::prev(it);
+                osg::Quat result;
+                result.slerp((time - low->first) / (it->first - low->first), low->second.mValue, it->second.mValue);
+                benchmark::DoNotOptimize(result);
+            }
+            for (const auto& keys : translations)
+            {
+                auto it = keys.lower_bound(time);
+                if (it == keys.begin() || it == keys.end())
+                    continue;
+                auto low = std::prev(it);
+                const float a = (time - low->first) / (it->first - low->first);
+                benchmark::DoNotOptimize(low->second.mValue + (it->second.mValue - low->second.mValue) * a);
+            }
+            time += step;
+            if (time > duration)
+                time = 0;
+        }
+        state.SetItemsProcessed(state.iterations() * (rotations.size() + translations.size()));
+    }
+
+    void evaluateEvenlySpaced(benchmark::State& state)
+    {
+        evaluate(state, generateTracks(true));
+    }
+
+    void evaluateUnevenlySpaced(benchmark::State& state)
+    {
+        evaluate(state, generateTracks(false));
+    }
+
+    void evaluateMapEvenlySpaced(benchmark::State& state)
+    {
+        evaluateMap(state, generateTracks(true));
+    }
+
+    void evaluateMapUnevenlySpaced(benchmark::State& state)
+    {
+        evaluateMap(state, generateTracks(false));
+    }
+} // namespace
+
+BENCHMARK(evaluateEvenlySpaced);
+BENCHMARK(evaluateUnevenlySpaced);
+BENCHMARK(evaluateMapEvenlySpaced);
+BENCHMARK(evaluateMapUnevenlySpaced);
+
+// Paths to .kf or .nif files passed as arguments are benchmarked as well
+int main(int argc, char** argv)
+{
+    benchmark::Initialize(&argc, argv);
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string path = argv[i];
+        try
+        {
+            auto tracks = std::make_shared<Tracks>(loadTracks(path));
+            std::cout << path << ": " << tracks->mRotations.size() << " rotation and "
+                      << tracks->mTranslations.size() << " translation tracks" << std::endl;
+            benchmark::RegisterBenchmark(("evaluate/" + path).c_str(),
+                [tracks] (benchmark::State& state) { evaluate(state, *tracks); });
+            benchmark::RegisterBenchmark(("evaluateMap/" + path).c_str(),
+                [tracks] (benchmark::State& state) { evaluateMap(state, *tracks); });
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Failed to load " << path << ": " << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
@@ -0,0 +1,54 @@
+#include <benchmark/benchmark.h>
+
+#include <components/to_utf8/to_utf8.hpp>
+
+#include <cstddef>
+#include <random>
+#include <string>
+
+namespace
+{
+    using namespace ToUTF8;
+
+    // Words of ASCII letters with a given share of characters from the upper half of the code page: quotation marks
+    // in an English book, diacritics in a Polish one, most letters of a Russian one
+    std::string generateText(std::size_t size, int nonAsciiPercent)
+    {
+        std::minstd_rand random;
+        std::uniform_int_distribution<int> percent(0, 99);
+        std::uniform_int_distribution<int> ascii('a', 'z');
+        std::uniform_int_distribution<int> nonAscii(0xC0, 0xFF);
+        std::uniform_int_distribution<int> wordLength(2, 10);
+        std::string result;
+        while (result.size() < size)
+        {
+            for (int i = wordLength(random); i > 0 && result.size() < size; --i)
+                result += static_cast<char>(percent(random) < nonAsciiPercent ? nonAscii(random) : ascii(random));
+            if (result.size() < size)
+                result += ' ';
+        }
+        return result;
+    }
+
+    void getUtf8(benchmark::State& state)
+    {
+        const StatelessUtf8Encoder encoder(static_cast<FromType>(state.range(0)));
+        const std::string input = generateText(static_cast<std::size_t>(state.range(1)), static_cast<int>(state.range(2)));
+        std::string buffer;
+        for (auto _ : state)
+            benchmark::DoNotOptimize(encoder.getUtf8(input, BufferAllocationPolicy::UseGrowFactor, buffer));
+        state.SetBytesProcessed(state.iterations() * state.range(1));
+    }
+}
+
+// Arguments are the code page, the input size and the percentage of non-ASCII characters
+BENCHMARK(getUtf8)->ArgNames({"encoding", "size", "nonascii"})
+    // Record ids and names
+    ->Args({WINDOWS_1252, 32, 0})
+    // Dialogue responses and books
+    ->Args({WINDOWS_1252, 4096, 0})
+    ->Args({WINDOWS_1252, 4096, 1})
+    ->Args({WINDOWS_1250, 4096, 10})
+    ->Args({WINDOWS_1251, 4096, 80});
+
+BENCHMARK_MAIN();
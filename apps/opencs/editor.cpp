@@ -1,5 +1,8 @@
 #include "editor.hpp"
 
+#include <iostream>
+#include <string_view>
+
 #include <QApplication>
 #include <QLocalServer>
 #include <QLocalSocket>
@@ -12,6 +15,8 @@
 #include <components/nifosg/nifloader.hpp>
 
 #include "model/doc/document.hpp"
+#include "model/doc/state.hpp"
+#include "model/tools/reportmodel.hpp"
 #include "model/world/data.hpp"
 
 #ifdef _WIN32
@@ -23,15 +28,21 @@ using namespace Fallback;
 CS::Editor::Editor (int argc, char **argv)
 : mConfigVariables(readConfiguration()), mSettingsState (mCfgMgr), mDocumentManager (mCfgMgr),
   mPid(""), mLock(), mMerge (mDocumentManager),
+  mVerifyOnly (false), mVerifiedDocument (nullptr),
   mIpcServerName ("org.openmw.OpenCS"), mServer(nullptr), mClientSocket(nullptr)
 {
     std::pair<Files::PathContainer, std::vector<std::string> > config = readConfig();
 
     mViewManager = new CSVDoc::ViewManager(mDocumentManager);
-    if (argc > 1)
+    for (int i = 1; i < argc; ++i)
     {
-        mFileToLoad = argv[1];
-        mDataDirs = config.first;
+        if (std::string_view(argv[i]) == "--verify")
+            mVerifyOnly = true;
+        else if (mFileToLoad.empty())
+        {
+            mFileToLoad = argv[i];
+            mDataDirs = config.first;
+        }
     }
 
     NifOsg::Loader::setShowMarkers(true);
@@ -49,6 +60,10 @@ CS::Editor::Editor (int argc, char **argv)
     connect (&mDocumentManager, SIGNAL (lastDocumentDeleted()),
         this, SLOT (lastDocumentDeleted()));
 
+    if (mVerifyOnly)
+        connect (&mDocumentManager, SIGNAL (loadingStopped (CSMDoc::Document *, bool, const std::string&)),
+            this, SLOT (verifyLoadingStopped (CSMDoc::Document *, bool, const std::string&)));
+
     connect (mViewManager, SIGNAL (newGameRequest ()), this, SLOT (createGame ()));
     connect (mViewManager, SIGNAL (newAddonRequest ()), this, SLOT (createAddon ()));
     connect (mViewManager, SIGNAL (loadDocumentRequest ()), this, SLOT (loadDocument ()));
@@ -365,6 +380,17 @@ int CS::Editor::run()
 
     QApplication::setQuitOnLastWindowClosed(true);
 
+    if (mVerifyOnly)
+    {
+        if (mFileToLoad.empty())
+        {
+            Log(Debug::Error) << "Error: --verify requires a file to verify";
+            return 1;
+        }
+
+        mVerifyStart = std::chrono::steady_clock::now();
+    }
+
     if (mFileToLoad.empty())
     {
         mStartup.show();
@@ -414,9 +440,60 @@ int CS::Editor::run()
     return QApplication::exec();
 }
 
+bool CS::Editor::isVerifyOnly() const
+{
+    return mVerifyOnly;
+}
+
 void CS::Editor::documentAdded (CSMDoc::Document *document)
 {
-    mViewManager->addView (document);
+    if (!mVerifyOnly)
+    {
+        mViewManager->addView (document);
+        return;
+    }
+
+    const std::chrono::duration<double> loadTime = std::chrono::steady_clock::now() - mVerifyStart;
+    std::cout << "Loaded " << mFileToLoad.filename().string() << " in " << loadTime.count() << " s" << std::endl;
+
+    connect (document, SIGNAL (operationDone (int, bool)), this, SLOT (verificationDone (int, bool)));
+    mVerifiedDocument = document;
+    mVerifyStart = std::chrono::steady_clock::now();
+    mVerifyReport = document->verify();
+}
+
+void CS::Editor::verifyLoadingStopped (CSMDoc::Document *document, bool completed, const std::string& error)
+{
+    if (completed)
+        return;
+
+    Log(Debug::Error) << "Error: failed to load " << mFileToLoad.filename().string() << ": " << error;
+    QApplication::exit (1);
+}
+
+void CS::Editor::verificationDone (int type, bool failed)
+{
+    if (type!=CSMDoc::State_Verifying)
+        return;
+
+    const std::chrono::duration<double> verifyTime = std::chrono::steady_clock::now() - mVerifyStart;
+
+    // The messages are delivered before the done signal, so the report is complete
+    CSMTools::ReportModel *report = mVerifiedDocument->getReport (mVerifyReport);
+
+    for (int i = 0; i < report->rowCount(); ++i)
+    {
+        const CSMDoc::Message& message = report->getMessage (i);
+        std::cout << CSMDoc::Message::toString (message.mSeverity) << ": " << message.mId.toString()
+            << ": " << message.mMessage << '\n';
+    }
+
+    const int errors = report->countErrors();
+    std::cout << "Verified in " << verifyTime.count() << " s using "
+        << CSMPrefs::get()["Reports"]["threads"].toInt() << " threads: " << report->rowCount()
+        << " messages, " << errors << " errors" << std::endl;
+
+    QApplication::exit (failed || errors > 0 ? 1 : 0);
 }
 
 void CS::Editor::documentAboutToBeRemoved (CSMDoc::Document *document)
@@ -1,6 +1,8 @@
 #ifndef CS_EDITOR_H
 #define CS_EDITOR_H
 
+#include <chrono>
+
 #include <boost/interprocess/sync/file_lock.hpp>
 #include <boost/filesystem/fstream.hpp>
 
@@ -19,6 +21,8 @@
 
 #include "model/prefs/state.hpp"
 
+#include "model/world/universalid.hpp"
+
 #include "view/doc/viewmanager.hpp"
 #include "view/doc/startup.hpp"
 #include "view/doc/filedialog.hpp"
@@ -58,6 +62,10 @@ namespace CS
             boost::filesystem::path mFileToLoad;
             Files::PathContainer mDataDirs;
             std::string mEncodingName;
+            bool mVerifyOnly;
+            std::chrono::steady_clock::time_point mVerifyStart;
+            CSMDoc::Document *mVerifiedDocument;
+            CSMWorld::UniversalId mVerifyReport;
 
             boost::program_options::variables_map readConfiguration();
             ///< Calls mCfgMgr.readConfiguration; should be used before initialization of mSettingsState as it depends on the configuration.
@@ -79,6 +87,10 @@ namespace CS
             int run();
             ///< \return error status
 
+            bool isVerifyOnly() const;
+            ///< Was the editor started with --verify? It then verifies the file given on the command
+            /// line, prints the report and the time taken to stdout and quits without opening a view.
+
         private slots:
 
             void createGame();
@@ -103,6 +115,10 @@ namespace CS
 
             void mergeDocument (CSMDoc::Document *document);
 
+            void verifyLoadingStopped (CSMDoc::Document *document, bool completed, const std::string& error);
+
+            void verificationDone (int type, bool failed);
+
         private:
 
             QString mIpcServerName;
@@ -1,10 +1,15 @@
 #include "operation.hpp"
 
+#include <algorithm>
+#include <exception>
+#include <optional>
 #include <string>
 #include <vector>
 
 #include <QTimer>
 
+#include <components/misc/stagedtaskpool.hpp>
+
 #include "../world/universalid.hpp"
 
 #include "stage.hpp"
@@ -22,13 +27,130 @@ void CSMDoc::Operation::prepareStages()
         iter->second = iter->first->setup();
         mTotalSteps += iter->second;
     }
+
+    if (mThreads==0)
+        mPool.reset();
+    else if (!mPool || mPool->getNumThreads()!=mThreads)
+        mPool = std::make_unique<Misc::StagedTaskPool> (mThreads);
+}
+
+void CSMDoc::Operation::executeThreadSafeSteps()
+{
+    // Keep the batches small enough for the progress and abort requests to be handled
+    // several times per second
+    const std::size_t maxSteps = 256 * mThreads;
+
+    struct Range
+    {
+        std::vector<std::pair<Stage *, int> >::iterator mStage;
+        int mBegin;
+        int mSize;
+        std::size_t mFirstResult;
+    };
+
+    std::vector<Range> ranges;
+    std::size_t steps = 0;
+    std::vector<std::pair<Stage *, int> >::iterator stage = mCurrentStage;
+    int step = mCurrentStep;
+
+    while (stage!=mStages.end() && stage->first->isThreadSafe() && steps<maxSteps)
+    {
+        const int size = static_cast<int> (
+            std::min<std::size_t> (stage->second - step, maxSteps - steps));
+
+        if (size>0)
+            ranges.push_back ({stage, step, size, steps});
+
+        steps += size;
+        step += size;
+
+        if (step<stage->second)
+            break;
+
+        ++stage;
+        step = 0;
+    }
+
+    // One result per step, so the messages can be reported in the same order as by a
+    // sequential execution
+    std::vector<Messages> results (steps, Messages (mDefaultSeverity));
+    std::vector<std::exception_ptr> errors (steps);
+    std::size_t nextRange = 0;
+
+    mPool->start ([&] () -> std::optional<Misc::StagedTaskPool::Stage>
+    {
+        if (nextRange==ranges.size())
+            return std::nullopt;
+
+        const Range& range = ranges[nextRange++];
+
+        Misc::StagedTaskPool::Stage poolStage;
+        poolStage.mSize = range.mSize;
+        poolStage.mMinChunkSize = 16;
+        poolStage.mRun = [&results, &errors, range] (std::size_t begin, std::size_t end)
+        {
+            for (std::size_t i = begin; i<end; ++i)
+            {
+                const std::size_t result = range.mFirstResult + i;
+
+                try
+                {
+                    range.mStage->first->perform (range.mBegin + static_cast<int> (i), results[result]);
+                }
+                catch (...)
+                {
+                    errors[result] = std::current_exception();
+                }
+            }
+        };
+
+        return poolStage;
+    });
+
+    mPool->wait();
+
+    const int stepTotal = mCurrentStepTotal;
+    mCurrentStage = stage;
+    mCurrentStep = step;
+    mCurrentStepTotal += static_cast<int> (steps);
+
+    for (const Range& range : ranges)
+        for (int i = 0; i<range.mSize; ++i)
+        {
+            const std::size_t result = range.mFirstResult + i;
+
+            if (errors[result])
+            {
+                // Continue after the failed step and ignore the steps performed in the same batch
+                // after it, like the sequential execution does
+                mCurrentStage = range.mStage;
+                mCurrentStep = range.mBegin + i + 1;
+                mCurrentStepTotal = stepTotal + static_cast<int> (result) + 1;
+
+                try
+                {
+                    std::rethrow_exception (errors[result]);
+                }
+                catch (const std::exception& e)
+                {
+                    emit reportMessage (Message (CSMWorld::UniversalId(), e.what(), "", Message::Severity_SeriousError), mType);
+                    abort();
+                }
+            }
+
+            for (Messages::Iterator iter (results[result].begin()); iter!=results[result].end(); ++iter)
+                emit reportMessage (*iter, mType);
+
+            if (errors[result])
+                return;
+        }
 }
 
 CSMDoc::Operation::Operation (int type, bool ordered, bool finalAlways)
 : mType (type), mStages(std::vector<std::pair<Stage *, int> >()), mCurrentStage(mStages.begin()),
   mCurrentStep(0), mCurrentStepTotal(0), mTotalSteps(0), mOrdered (ordered),
   mFinalAlways (finalAlways), mError(false), mConnected (false), mPrepared (false),
-  mDefaultSeverity (Message::Severity_Error)
+  mDefaultSeverity (Message::Severity_Error), mThreads (0)
 {
     mTimer = new QTimer (this);
 }
@@ -64,6 +186,11 @@ void CSMDoc::Operation::setDefaultSeverity (Message::Severity severity)
     mDefaultSeverity = severity;
 }
 
+void CSMDoc::Operation::setThreads (unsigned int threads)
+{
+    mThreads = threads;
+}
+
 bool CSMDoc::Operation::hasError() const
 {
     return mError;
@@ -96,6 +223,24 @@ void CSMDoc::Operation::executeStage()
         mPrepared = true;
     }
 
+    while (mCurrentStage!=mStages.end() && mCurrentStep>=mCurrentStage->second)
+    {
+        mCurrentStep = 0;
+        ++mCurrentStage;
+    }
+
+    if (mPool && mCurrentStage!=mStages.end() && mCurrentStage->first->isThreadSafe())
+    {
+        executeThreadSafeSteps();
+
+        emit progress (mCurrentStepTotal, mTotalSteps ? mTotalSteps : 1, mType);
+
+        if (mCurrentStage==mStages.end())
+            operationDone();
+
+        return;
+    }
+
     Messages messages (mDefaultSeverity);
 
     while (mCurrentStage!=mStages.end())
@@ -3,6 +3,7 @@
 
 #include <vector>
 #include <map>
+#include <memory>
 
 #include <QObject>
 #include <QTimer>
@@ -15,6 +16,11 @@ namespace CSMWorld
     class UniversalId;
 }
 
+namespace Misc
+{
+    class StagedTaskPool;
+}
+
 namespace CSMDoc
 {
     class Stage;
@@ -36,9 +42,14 @@ namespace CSMDoc
             QTimer *mTimer;
             bool mPrepared;
             Message::Severity mDefaultSeverity;
+            unsigned int mThreads;
+            std::unique_ptr<Misc::StagedTaskPool> mPool;
 
             void prepareStages();
 
+            void executeThreadSafeSteps();
+            ///< Perform a batch of consecutive steps of thread safe stages in mPool.
+
         public:
 
             Operation (int type, bool ordered, bool finalAlways = false);
@@ -55,6 +66,12 @@ namespace CSMDoc
             /// \attention Do no call this function while this Operation is running.
             void setDefaultSeverity (Message::Severity severity);
 
+            /// Number of threads performing the steps of thread safe stages. With 0 threads all
+            /// steps are performed one at a time by the thread of this operation.
+            ///
+            /// \attention Do no call this function while this Operation is running.
+            void setThreads (unsigned int threads);
+
             bool hasError() const;
 
         signals:
@@ -1,3 +1,8 @@
 #include "stage.hpp"
 
 CSMDoc::Stage::~Stage() {}
+
+bool CSMDoc::Stage::isThreadSafe() const
+{
+    return false;
+}
@@ -23,6 +23,11 @@ namespace CSMDoc
 
             virtual void perform (int stage, Messages& messages) = 0;
             ///< Messages resulting from this stage will be appended to \a messages.
+
+            virtual bool isThreadSafe() const;
+            ///< \return May perform be called concurrently for different steps of this stage and
+            /// of other thread safe stages? The steps must then only read the document. The default
+            /// is false.
     };
 }
 
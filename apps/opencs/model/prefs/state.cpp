@@ -112,6 +112,10 @@ void CSMPrefs::State::declare()
     declareEnum ("double-c", "Control Double Click", actionEditAndRemove).addValues (reportValues);
     declareEnum ("double-sc", "Shift Control Double Click", actionNone).addValues (reportValues);
     declareBool("ignore-base-records", "Ignore base records in verifier", false);
+    declareInt ("threads", "Verifier and search threads", 0).
+        setTooltip ("Number of threads checking or searching records in parallel. With 0 threads "
+        "the records are processed one at a time. The reports are the same in both cases.").
+        setRange (0, 64);
 
     declareCategory ("Search & Replace");
     declareInt ("char-before", "Characters before search string", 10).
@@ -80,3 +80,8 @@ void CSMTools::EnchantmentCheckStage::perform (int stage, CSMDoc::Messages& mess
         }
     }
 }
+
+bool CSMTools::EnchantmentCheckStage::isThreadSafe() const
+{
+    return true;
+}
@@ -23,8 +23,7 @@ CSMTools::ReferenceableCheckStage::ReferenceableCheckStage(
     mScripts(scripts),
     mModels(models),
     mIcons(icons),
-    mBodyParts(bodyparts),
-    mPlayerPresent(false)
+    mBodyParts(bodyparts)
 {
     mIgnoreBaseRecords = false;
 }
@@ -236,7 +235,6 @@ void CSMTools::ReferenceableCheckStage::perform (int stage, CSMDoc::Messages& me
 
 int CSMTools::ReferenceableCheckStage::setup()
 {
-    mPlayerPresent = false;
     mIgnoreBaseRecords = CSMPrefs::get()["Reports"]["ignore-base-records"].isTrue();
 
     return mReferencables.getSize() + 1;
@@ -665,10 +663,6 @@ void CSMTools::ReferenceableCheckStage::npcCheck (
     const ESM::NPC& npc = (dynamic_cast<const CSMWorld::Record<ESM::NPC>& >(baseRecord)).get();
     CSMWorld::UniversalId id (CSMWorld::UniversalId::Type_Npc, npc.mId);
 
-    //Detect if player is present
-    if (Misc::StringUtils::ciEqual(npc.mId, "player")) //Happy now, scrawl?
-        mPlayerPresent = true;
-
     // Skip "Base" records (setting!)
     if (mIgnoreBaseRecords && baseRecord.mState == CSMWorld::RecordBase::State_BaseOnly)
         return;
@@ -899,7 +893,11 @@ void CSMTools::ReferenceableCheckStage::staticCheck (
 
 void CSMTools::ReferenceableCheckStage::finalCheck (CSMDoc::Messages& messages)
 {
-    if (!mPlayerPresent)
+    // Looked up here rather than remembered by npcCheck, so the steps stay independent of each other
+    const CSMWorld::RefIdData::LocalIndex player = mReferencables.searchId("player");
+
+    if (player.first==-1 || player.second!=CSMWorld::UniversalId::Type_Npc ||
+        mReferencables.getRecord(player).isDeleted())
         messages.add(CSMWorld::UniversalId::Type_Referenceables, "Player record is missing", "", CSMDoc::Message::Severity_SeriousError);
 }
 
@@ -1052,3 +1050,8 @@ template<typename Tool> void CSMTools::ReferenceableCheckStage::scriptCheck (
             messages.add(someID, "Script '" + someTool.mScript + "' does not exist", "", CSMDoc::Message::Severity_Error);
     }
 }
+
+bool CSMTools::ReferenceableCheckStage::isThreadSafe() const
+{
+    return true;
+}
@@ -24,6 +24,7 @@ namespace CSMTools
 
             void perform(int stage, CSMDoc::Messages& messages) override;
             int setup() override;
+            bool isThreadSafe() const override;
 
         private:
             //CONCRETE CHECKS
@@ -88,7 +89,6 @@ namespace CSMTools
             const CSMWorld::Resources& mModels;
             const CSMWorld::Resources& mIcons;
             const CSMWorld::IdCollection<ESM::BodyPart>& mBodyParts;
-            bool mPlayerPresent;
             bool mIgnoreBaseRecords;
     };
 }
@@ -51,6 +51,8 @@ namespace CSMTools
 
             std::string getHint (int row) const;
 
+            const CSMDoc::Message& getMessage (int row) const;
+
             void clear();
 
             // Return number of messages with Error or SeriousError severity.
@@ -246,6 +246,11 @@ void CSMTools::Search::setPadding (int before, int after)
     mPaddingAfter = after;
 }
 
+bool CSMTools::Search::isThreadSafe() const
+{
+    return mType!=Type_TextRegEx && mType!=Type_IdRegEx;
+}
+
 void CSMTools::Search::replace (CSMDoc::Document& document, CSMWorld::IdTableBase *model,
     const CSMWorld::UniversalId& id, const std::string& messageHint,
     const std::string& replaceText) const
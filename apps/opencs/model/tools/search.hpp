@@ -85,6 +85,9 @@ namespace CSMTools
 
             void setPadding (int before, int after);
 
+            // Can searchRow be called concurrently? QRegExp keeps the state of the last match.
+            bool isThreadSafe() const;
+
             // Configuring *this for the model is not necessary when calling this function.
             void replace (CSMDoc::Document& document, CSMWorld::IdTableBase *model,
                 const CSMWorld::UniversalId& id, const std::string& messageHint,
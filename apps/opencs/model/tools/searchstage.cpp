@@ -27,3 +27,8 @@ void CSMTools::SearchStage::setOperation (const SearchOperation *operation)
 {
     mOperation = operation;
 }
+
+bool CSMTools::SearchStage::isThreadSafe() const
+{
+    return mSearch.isThreadSafe();
+}
@@ -34,3 +34,8 @@ int CSMTools::StartScriptCheckStage::setup()
 
     return mStartScripts.getSize();
 }
+
+bool CSMTools::StartScriptCheckStage::isThreadSafe() const
+{
+    return true;
+}
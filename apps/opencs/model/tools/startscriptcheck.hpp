@@ -23,6 +23,7 @@ namespace CSMTools
 
             void perform(int stage, CSMDoc::Messages& messages) override;
             int setup() override;
+            bool isThreadSafe() const override;
     };
 }
 
@@ -2,6 +2,8 @@
 
 #include <QThreadPool>
 
+#include "../prefs/state.hpp"
+
 #include "../doc/state.hpp"
 #include "../doc/operation.hpp"
 #include "../doc/document.hpp"
@@ -189,7 +191,9 @@ CSMWorld::UniversalId CSMTools::Tools::runVerifier (const CSMWorld::UniversalId&
 
     mActiveReports[CSMDoc::State_Verifying] = reportNumber;
 
-    getVerifier()->start();
+    CSMDoc::OperationHolder *verifier = getVerifier();
+    mVerifierOperation->setThreads (CSMPrefs::get()["Reports"]["threads"].toInt());
+    verifier->start();
 
     return CSMWorld::UniversalId (CSMWorld::UniversalId::Type_VerificationResults, reportNumber);
 }
@@ -212,6 +216,7 @@ void CSMTools::Tools::runSearch (const CSMWorld::UniversalId& searchId, const Se
     }
 
     mSearchOperation->configure (search);
+    mSearchOperation->setThreads (CSMPrefs::get()["Reports"]["threads"].toInt());
 
     mSearch.start();
 }
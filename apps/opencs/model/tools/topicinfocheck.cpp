@@ -406,3 +406,8 @@ bool CSMTools::TopicInfoCheckStage::verifyId(const std::string& name, const CSMW
 
     return true;
 }
+
+bool CSMTools::TopicInfoCheckStage::isThreadSafe() const
+{
+    return true;
+}
@@ -20,6 +20,7 @@
 #include "land.hpp"
 #include "landtexture.hpp"
 #include "ref.hpp"
+#include "rowindex.hpp"
 
 namespace CSMWorld
 {
@@ -87,7 +88,7 @@ namespace CSMWorld
         private:
 
             std::vector<std::unique_ptr<Record<ESXRecordT> > > mRecords;
-            std::map<std::string, int> mIndex;
+            RowIndex<std::string> mIndex; // keyed by lower case ID
             std::vector<Column<ESXRecordT> *> mColumns;
 
             // not implemented
@@ -218,6 +219,9 @@ namespace CSMWorld
         {
             int size = static_cast<int> (newOrder.size());
 
+            if (baseIndex<0 || baseIndex+size>static_cast<int> (mRecords.size()))
+                return false;
+
             // check that all indices are present
             std::vector<int> test (newOrder);
             std::sort (test.begin(), test.end());
@@ -235,11 +239,7 @@ namespace CSMWorld
 
             std::move (buffer.begin(), buffer.end(), mRecords.begin()+baseIndex);
 
-            // adjust index
-            for (std::map<std::string, int>::iterator iter (mIndex.begin()); iter!=mIndex.end();
-                 ++iter)
-                if (iter->second>=baseIndex && iter->second<baseIndex+size)
-                    iter->second = newOrder.at (iter->second-baseIndex)+baseIndex;
+            mIndex.reorderRows (baseIndex, newOrder);
         }
 
         return true;
@@ -334,9 +334,9 @@ namespace CSMWorld
     {
         std::string id = Misc::StringUtils::lowerCase (IdAccessorT().getId (record));
 
-        std::map<std::string, int>::iterator iter = mIndex.find (id);
+        int index = mIndex.searchRow (id);
 
-        if (iter==mIndex.end())
+        if (index==-1)
         {
             std::unique_ptr<Record<ESXRecordT> > record2(new Record<ESXRecordT>);
             record2->mState = Record<ESXRecordT>::State_ModifiedOnly;
@@ -346,7 +346,7 @@ namespace CSMWorld
         }
         else
         {
-            mRecords[iter->second]->setModified (record);
+            mRecords[index]->setModified (record);
         }
     }
 
@@ -424,14 +424,23 @@ namespace CSMWorld
     template<typename ESXRecordT, typename IdAccessorT>
     void  Collection<ESXRecordT, IdAccessorT>::purge()
     {
-        int i = 0;
+        int i = static_cast<int> (mRecords.size());
 
-        while (i<static_cast<int> (mRecords.size()))
+        // Remove runs of erased records starting from the back, so fewer rows have to be moved
+        while (i>0)
         {
-            if (mRecords[i]->isErased())
-                removeRows (i, 1);
-            else
-                ++i;
+            if (!mRecords[i-1]->isErased())
+            {
+                --i;
+                continue;
+            }
+
+            int end = i;
+
+            while (i>0 && mRecords[i-1]->isErased())
+                --i;
+
+            removeRows (i, end-i);
         }
     }
 
@@ -439,26 +448,7 @@ namespace CSMWorld
     void Collection<ESXRecordT, IdAccessorT>::removeRows (int index, int count)
     {
         mRecords.erase (mRecords.begin()+index, mRecords.begin()+index+count);
-
-        typename std::map<std::string, int>::iterator iter = mIndex.begin();
-
-        while (iter!=mIndex.end())
-        {
-            if (iter->second>=index)
-            {
-                if (iter->second>=index+count)
-                {
-                    iter->second -= count;
-                    ++iter;
-                }
-                else
-                {
-                    mIndex.erase (iter++);
-                }
-            }
-            else
-                ++iter;
-        }
+        mIndex.removeRows (index, count);
     }
 
     template<typename ESXRecordT, typename IdAccessorT>
@@ -479,14 +469,7 @@ namespace CSMWorld
     template<typename ESXRecordT, typename IdAccessorT>
     int Collection<ESXRecordT, IdAccessorT>::searchId(std::string_view id) const
     {
-        std::string id2 = Misc::StringUtils::lowerCase(id);
-
-        std::map<std::string, int>::const_iterator iter = mIndex.find (id2);
-
-        if (iter==mIndex.end())
-            return -1;
-
-        return iter->second;
+        return mIndex.searchRow (Misc::StringUtils::lowerCase (id));
     }
 
     template<typename ESXRecordT, typename IdAccessorT>
@@ -515,14 +498,23 @@ namespace CSMWorld
     template<typename ESXRecordT, typename IdAccessorT>
     std::vector<std::string> Collection<ESXRecordT, IdAccessorT>::getIds (bool listDeleted) const
     {
-        std::vector<std::string> ids;
+        std::vector<std::pair<const std::string *, int> > rows; // lower case ID, row
 
-        for (typename std::map<std::string, int>::const_iterator iter = mIndex.begin();
-            iter!=mIndex.end(); ++iter)
+        mIndex.forEach ([&] (const std::string& id, int row)
         {
-            if (listDeleted || !mRecords[iter->second]->isDeleted())
-                ids.push_back (IdAccessorT().getId (mRecords[iter->second]->get()));
-        }
+            if (listDeleted || !mRecords[row]->isDeleted())
+                rows.emplace_back (&id, row);
+        });
+
+        std::sort (rows.begin(), rows.end(),
+            [] (const std::pair<const std::string *, int>& left, const std::pair<const std::string *, int>& right)
+            { return *left.first < *right.first; });
+
+        std::vector<std::string> ids;
+        ids.reserve (rows.size());
+
+        for (const std::pair<const std::string *, int>& row : rows)
+            ids.push_back (IdAccessorT().getId (mRecords[row.second]->get()));
 
         return ids;
     }
@@ -556,16 +548,7 @@ namespace CSMWorld
         else
             mRecords.insert (mRecords.begin()+index, std::move(record2));
 
-        if (index < size-1)
-        {
-            for (std::map<std::string, int>::iterator iter (mIndex.begin()); iter!=mIndex.end(); ++iter)
-            {
-                if (iter->second >= index)
-                    ++(iter->second);
-            }
-        }
-
-        mIndex.insert (std::make_pair (lowerId, index));
+        mIndex.insertRow (index, lowerId);
     }
 
     template<typename ESXRecordT, typename IdAccessorT>
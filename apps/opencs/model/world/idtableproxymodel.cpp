@@ -51,7 +51,8 @@ bool CSMWorld::IdTableProxyModel::filterAcceptsRow (int sourceRow, const QModelI
 
 CSMWorld::IdTableProxyModel::IdTableProxyModel (QObject *parent)
     : QSortFilterProxyModel (parent), 
-      mSourceModel(nullptr)
+      mSourceModel(nullptr),
+      mFilterRefreshQueued(false)
 {
     setSortCaseSensitivity (Qt::CaseInsensitive);
 }
@@ -128,9 +129,24 @@ void CSMWorld::IdTableProxyModel::refreshFilter()
     }
 }
 
-void CSMWorld::IdTableProxyModel::sourceRowsInserted(const QModelIndex &parent, int /*start*/, int end)
+void CSMWorld::IdTableProxyModel::queueRefreshFilter()
+{
+    if (mFilterRefreshQueued)
+        return;
+
+    mFilterRefreshQueued = true;
+    QMetaObject::invokeMethod(this, "queuedRefreshFilter", Qt::QueuedConnection);
+}
+
+void CSMWorld::IdTableProxyModel::queuedRefreshFilter()
 {
+    mFilterRefreshQueued = false;
     refreshFilter();
+}
+
+void CSMWorld::IdTableProxyModel::sourceRowsInserted(const QModelIndex &parent, int /*start*/, int end)
+{
+    queueRefreshFilter();
     if (!parent.isValid())
     {
         emit rowAdded(getRecordId(end).toUtf8().constData());
@@ -139,10 +155,10 @@ void CSMWorld::IdTableProxyModel::sourceRowsInserted(const QModelIndex &parent,
 
 void CSMWorld::IdTableProxyModel::sourceRowsRemoved(const QModelIndex &/*parent*/, int /*start*/, int /*end*/)
 {
-    refreshFilter();
+    queueRefreshFilter();
 }
 
 void CSMWorld::IdTableProxyModel::sourceDataChanged(const QModelIndex &/*topLeft*/, const QModelIndex &/*bottomRight*/)
 {
-    refreshFilter();
+    queueRefreshFilter();
 }
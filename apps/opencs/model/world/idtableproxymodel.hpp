@@ -25,6 +25,8 @@ namespace CSMWorld
             typedef std::map<Columns::ColumnId, std::vector<std::pair<int,std::string>> > EnumColumnCache;
             mutable EnumColumnCache mEnumColumnCache;
 
+            bool mFilterRefreshQueued;
+
         protected:
 
             IdTableBase *mSourceModel;
@@ -53,6 +55,10 @@ namespace CSMWorld
 
             QString getRecordId(int sourceRow) const;
 
+            void queueRefreshFilter();
+            ///< Refresh the filter once control returns to the event loop. Bulk changes of the source
+            /// model emit a signal for every row, this way the filter is applied only once to all rows.
+
         protected slots:
 
             virtual void sourceRowsInserted(const QModelIndex &parent, int start, int end);
@@ -61,6 +67,10 @@ namespace CSMWorld
 
             virtual void sourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight);
 
+        private slots:
+
+            void queuedRefreshFilter();
+
         signals:
 
             void rowAdded(const std::string &id);
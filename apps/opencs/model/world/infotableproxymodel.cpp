@@ -73,13 +73,13 @@ int CSMWorld::InfoTableProxyModel::getFirstInfoRow(int currentRow) const
 
 void CSMWorld::InfoTableProxyModel::sourceRowsRemoved(const QModelIndex &/*parent*/, int /*start*/, int /*end*/)
 {
-    refreshFilter();
+    queueRefreshFilter();
     mFirstRowCache.clear();
 }
 
 void CSMWorld::InfoTableProxyModel::sourceRowsInserted(const QModelIndex &parent, int /*start*/, int end)
 {
-    refreshFilter();
+    queueRefreshFilter();
 
     if (!parent.isValid())
     {
@@ -92,7 +92,7 @@ void CSMWorld::InfoTableProxyModel::sourceRowsInserted(const QModelIndex &parent
 
 void CSMWorld::InfoTableProxyModel::sourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight)
 {
-    refreshFilter();
+    queueRefreshFilter();
 
     if (mLastAddedSourceRow != -1 && 
         topLeft.row() <= mLastAddedSourceRow && bottomRight.row() >= mLastAddedSourceRow)
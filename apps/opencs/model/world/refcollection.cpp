@@ -241,34 +241,14 @@ int CSMWorld::RefCollection::getIntIndex (unsigned int id) const
 
 int CSMWorld::RefCollection::searchId (unsigned int id) const
 {
-    std::map<unsigned int, int>::const_iterator iter = mRefIndex.find(id);
-
-    if (iter == mRefIndex.end())
-        return -1;
-
-    return iter->second;
+    return mRefIndex.searchRow(id);
 }
 
 void CSMWorld::RefCollection::removeRows (int index, int count)
 {
     Collection<CellRef, IdAccessor<CellRef> >::removeRows(index, count); // erase records only
 
-    std::map<unsigned int, int>::iterator iter = mRefIndex.begin();
-    while (iter != mRefIndex.end())
-    {
-        if (iter->second>=index)
-        {
-            if (iter->second >= index+count)
-            {
-                iter->second -= count;
-                ++iter;
-            }
-            else
-                mRefIndex.erase(iter++);
-        }
-        else
-            ++iter;
-    }
+    mRefIndex.removeRows(index, count);
 }
 
 void  CSMWorld::RefCollection::appendBlankRecord (const std::string& id, UniversalId::Type type)
@@ -308,7 +288,7 @@ void CSMWorld::RefCollection::appendRecord (std::unique_ptr<RecordBase> record,
 {
     int index = getAppendIndex(/*id*/"", type); // for CellRef records id is ignored
 
-    mRefIndex.insert(std::make_pair(static_cast<Record<CellRef>*>(record.get())->get().mIdNum, index));
+    mRefIndex.insertRow(index, static_cast<Record<CellRef>*>(record.get())->get().mIdNum);
 
     Collection<CellRef, IdAccessor<CellRef> >::insertRecord(std::move(record), index, type); // add records only
 }
@@ -316,19 +296,9 @@ void CSMWorld::RefCollection::appendRecord (std::unique_ptr<RecordBase> record,
 void CSMWorld::RefCollection::insertRecord (std::unique_ptr<RecordBase> record, int index,
     UniversalId::Type type)
 {
-    int size = getAppendIndex(/*id*/"", type); // for CellRef records id is ignored
     unsigned int idNum = static_cast<Record<CellRef>*>(record.get())->get().mIdNum;
 
     Collection<CellRef, IdAccessor<CellRef> >::insertRecord(std::move(record), index, type); // add records only
 
-    if (index < size-1)
-    {
-        for (std::map<unsigned int, int>::iterator iter(mRefIndex.begin()); iter != mRefIndex.end(); ++iter)
-        {
-            if (iter->second >= index)
-                ++(iter->second);
-        }
-    }
-
-    mRefIndex.insert(std::make_pair(idNum, index));
+    mRefIndex.insertRow(index, idNum);
 }
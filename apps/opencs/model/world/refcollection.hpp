@@ -9,6 +9,7 @@
 #include "collection.hpp"
 #include "ref.hpp"
 #include "record.hpp"
+#include "rowindex.hpp"
 
 namespace CSMWorld
 {
@@ -26,7 +27,7 @@ namespace CSMWorld
     class RefCollection : public Collection<CellRef>
     {
             Collection<Cell>& mCells;
-            std::map<unsigned int, int> mRefIndex; // CellRef index keyed by CSMWorld::CellRef::mIdNum
+            RowIndex<unsigned int> mRefIndex; // CellRef index keyed by CSMWorld::CellRef::mIdNum
 
             int mNextId;
 
@@ -0,0 +1,155 @@
+#ifndef CSM_WOLRD_ROWINDEX_H
+#define CSM_WOLRD_ROWINDEX_H
+
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace CSMWorld
+{
+    /// \brief Index of the rows of a collection by a unique key
+    ///
+    /// Keys are hashed to handles, which stay the same while rows are inserted, removed or
+    /// reordered, and the handles are mapped to rows. Changing rows therefore only renumbers
+    /// the handles of the moved rows (a plain array walk, like the one moving the records
+    /// themselves) instead of updating every entry of the key index.
+    template<typename KeyT, typename HashT = std::hash<KeyT> >
+    class RowIndex
+    {
+            typedef std::unordered_map<KeyT, int, HashT> Handles;
+
+            Handles mHandles; // handle of each key
+            std::vector<int> mRowHandles; // handle of each row
+            std::vector<int> mHandleRows; // row of each handle, -1 for unused handles
+            std::vector<const KeyT *> mHandleKeys; // key of each handle, nullptr if not indexed
+            std::vector<int> mFreeHandles;
+
+            void updateRows (int begin, int end);
+
+        public:
+
+            int getSize() const;
+            ///< \return number of rows
+
+            int searchRow (const KeyT& key) const;
+            ///< \return row of \a key or -1
+
+            bool insertRow (int row, const KeyT& key);
+            ///< Insert a row with \a key before \a row.
+            ///
+            /// \return Was \a key indexed? If another row already has \a key, that row keeps it
+            /// and the new row can't be searched.
+
+            void removeRows (int row, int count);
+
+            void reorderRows (int baseRow, const std::vector<int>& newOrder);
+            ///< Reorder the rows [baseRow, baseRow+newOrder.size()) according to the indices
+            /// given in \a newOrder (baseRow+newOrder[0] specifies the new index of row baseRow).
+            ///
+            /// Does nothing if the rows aren't indexed, e.g. for a collection that keeps its own
+            /// index instead.
+
+            template<typename FunctionT>
+            void forEach (FunctionT&& function) const;
+            ///< Call \a function with the key and row of each indexed row, in no particular order.
+    };
+
+    template<typename KeyT, typename HashT>
+    void RowIndex<KeyT, HashT>::updateRows (int begin, int end)
+    {
+        for (int row = begin; row<end; ++row)
+            mHandleRows[mRowHandles[row]] = row;
+    }
+
+    template<typename KeyT, typename HashT>
+    int RowIndex<KeyT, HashT>::getSize() const
+    {
+        return static_cast<int> (mRowHandles.size());
+    }
+
+    template<typename KeyT, typename HashT>
+    int RowIndex<KeyT, HashT>::searchRow (const KeyT& key) const
+    {
+        typename Handles::const_iterator iter = mHandles.find (key);
+
+        if (iter==mHandles.end())
+            return -1;
+
+        return mHandleRows[iter->second];
+    }
+
+    template<typename KeyT, typename HashT>
+    bool RowIndex<KeyT, HashT>::insertRow (int row, const KeyT& key)
+    {
+        int handle;
+
+        if (mFreeHandles.empty())
+        {
+            handle = static_cast<int> (mHandleRows.size());
+            mHandleRows.push_back (-1);
+            mHandleKeys.push_back (nullptr);
+        }
+        else
+        {
+            handle = mFreeHandles.back();
+            mFreeHandles.pop_back();
+        }
+
+        mRowHandles.insert (mRowHandles.begin()+row, handle);
+        updateRows (row, getSize());
+
+        std::pair<typename Handles::iterator, bool> result = mHandles.insert (std::make_pair (key, handle));
+
+        // Keys of unordered_map nodes don't move when the table is rehashed
+        if (result.second)
+            mHandleKeys[handle] = &result.first->first;
+
+        return result.second;
+    }
+
+    template<typename KeyT, typename HashT>
+    void RowIndex<KeyT, HashT>::removeRows (int row, int count)
+    {
+        for (int i = row; i<row+count; ++i)
+        {
+            const int handle = mRowHandles[i];
+
+            if (const KeyT *key = mHandleKeys[handle])
+                mHandles.erase (mHandles.find (*key));
+
+            mHandleKeys[handle] = nullptr;
+            mHandleRows[handle] = -1;
+            mFreeHandles.push_back (handle);
+        }
+
+        mRowHandles.erase (mRowHandles.begin()+row, mRowHandles.begin()+row+count);
+        updateRows (row, getSize());
+    }
+
+    template<typename KeyT, typename HashT>
+    void RowIndex<KeyT, HashT>::reorderRows (int baseRow, const std::vector<int>& newOrder)
+    {
+        if (baseRow<0 || baseRow+static_cast<int> (newOrder.size())>getSize())
+            return;
+
+        std::vector<int> buffer (newOrder.size());
+
+        for (std::size_t i = 0; i<newOrder.size(); ++i)
+            buffer[newOrder[i]] = mRowHandles[baseRow+i];
+
+        std::copy (buffer.begin(), buffer.end(), mRowHandles.begin()+baseRow);
+        updateRows (baseRow, baseRow+static_cast<int> (newOrder.size()));
+    }
+
+    template<typename KeyT, typename HashT>
+    template<typename FunctionT>
+    void RowIndex<KeyT, HashT>::forEach (FunctionT&& function) const
+    {
+        for (typename Handles::const_iterator iter (mHandles.begin()); iter!=mHandles.end(); ++iter)
+            function (iter->first, mHandleRows[iter->second]);
+    }
+}
+
+#endif
@@ -15,6 +15,7 @@
 
 #include <components/debug/debuglog.hpp>
 #include <components/debug/gldebug.hpp>
+#include <components/debug/trace.hpp>
 
 #include <components/misc/rng.hpp>
 
@@ -26,6 +27,8 @@
 
 #include <components/resource/resourcesystem.hpp>
 #include <components/resource/scenemanager.hpp>
+#include <components/resource/imagemanager.hpp>
+#include <components/resource/imageresidency.hpp>
 #include <components/resource/stats.hpp>
 
 #include <components/compiler/extensions0.hpp>
@@ -86,12 +89,14 @@ namespace
     struct UserStats
     {
         const std::string mLabel;
+        const std::string mName;
         const std::string mBegin;
         const std::string mEnd;
         const std::string mTaken;
 
         UserStats(const std::string& label, const std::string& prefix)
             : mLabel(label),
+              mName(prefix),
               mBegin(prefix + "_time_begin"),
               mEnd(prefix + "_time_end"),
               mTaken(prefix + "_time_taken")
@@ -180,7 +185,8 @@ namespace
     {
         public:
             ScopedProfile(osg::Timer_t frameStart, unsigned int frameNumber, const osg::Timer& timer, osg::Stats& stats)
-                : mScopeStart(timer.tick()),
+                : mZone(UserStatsValue<sType>::sValue.mName.c_str()),
+                  mScopeStart(timer.tick()),
                   mFrameStart(frameStart),
                   mFrameNumber(frameNumber),
                   mTimer(timer),
@@ -204,6 +210,7 @@ namespace
             }
 
         private:
+            const Debug::TraceZone mZone;
             const osg::Timer_t mScopeStart;
             const osg::Timer_t mFrameStart;
             const unsigned int mFrameNumber;
@@ -326,7 +333,10 @@ bool OMW::Engine::frame(float frametime)
 
         // Should be called after input manager update and before any change to the game world.
         // It applies to the game world queued changes from the previous frame.
-        mLuaManager->synchronizedUpdate();
+        {
+            const Debug::TraceZone zone("luasync");
+            mLuaManager->synchronizedUpdate();
+        }
 
         // update game state
         {
@@ -735,6 +745,12 @@ void OMW::Engine::prepareEngine (Settings::Manager & settings)
         Settings::Manager::getString("texture mipmap", "General"),
         Settings::Manager::getInt("anisotropy", "General")
     );
+    Resource::ImageResidency& imageResidency = mResourceSystem->getImageManager()->getResidency();
+    imageResidency.setEnabled(Settings::Manager::getBool("texture streaming", "General"));
+    imageResidency.setBaseSize(std::max(Settings::Manager::getInt("texture streaming base size", "General"), 4));
+    imageResidency.setBudget(static_cast<std::size_t>(std::max(Settings::Manager::getInt("texture streaming budget", "General"), 0)) * 1024 * 1024);
+    if (imageResidency.isEnabled())
+        mViewer->getCamera()->getGraphicsContext()->add(new Resource::ApplyImageResidencyOperation(imageResidency));
     mEnvironment.setResourceSystem(*mResourceSystem);
 
     int numThreads = Settings::Manager::getInt("preload num threads", "Cells");
@@ -899,7 +915,7 @@ public:
     explicit LuaWorker(Engine* engine) : mEngine(engine)
     {
         if (Settings::Manager::getInt("lua num threads", "Lua") > 0)
-            mThread = std::thread([this]{ threadBody(); });
+            mThread = std::thread([this]{ Debug::setTraceThreadName("Lua"); threadBody(); });
     };
 
     void allowUpdate()
@@ -991,6 +1007,13 @@ void OMW::Engine::go()
 
     Settings::ShaderManager::get().load((mCfgMgr.getUserConfigPath() / "shaders.yaml").string());
 
+    Debug::setTraceThreadName("Main");
+    if (const auto path = std::getenv("OPENMW_TRACE_FILE"))
+    {
+        Debug::enableTrace(path);
+        Log(Debug::Info) << "Trace will be written to " << path << " by the WriteTrace console command and on exit";
+    }
+
     MWClass::registerClasses();
 
     // Create encoder
@@ -1064,6 +1087,8 @@ void OMW::Engine::go()
     const std::chrono::steady_clock::duration maxSimulationInterval(std::chrono::milliseconds(200));
     while (!mViewer->done() && !mStateManager->hasQuitRequest())
     {
+        const Debug::TraceZone frameZone("frame");
+
         const double dt = std::chrono::duration_cast<std::chrono::duration<double>>(std::min(
             frameRateLimiter.getLastFrameDuration(),
             maxSimulationInterval
@@ -1078,16 +1103,28 @@ void OMW::Engine::go()
         }
         else
         {
-            mViewer->eventTraversal();
-            mViewer->updateTraversal();
+            {
+                const Debug::TraceZone zone("eventtraversal");
+                mViewer->eventTraversal();
+            }
+            {
+                const Debug::TraceZone zone("updatetraversal");
+                mViewer->updateTraversal();
+            }
 
             mWorld->updateWindowManager();
 
             luaWorker.allowUpdate();  // if there is a separate Lua thread, it starts the update now
 
-            mViewer->renderingTraversals();
+            {
+                const Debug::TraceZone zone("renderingtraversals");
+                mViewer->renderingTraversals();
+            }
 
-            luaWorker.finishUpdate();
+            {
+                const Debug::TraceZone zone("luafinish");
+                luaWorker.finishUpdate();
+            }
 
             bool guiActive = mWindowManager->isGuiMode();
             if (!guiActive)
@@ -1107,11 +1144,24 @@ void OMW::Engine::go()
             }
         }
 
+        const Debug::TraceZone zone("frameratelimit");
         frameRateLimiter.limit();
     }
 
     luaWorker.join();
 
+    if (Debug::isTraceEnabled())
+    {
+        try
+        {
+            Debug::writeTrace();
+        }
+        catch (const std::exception& e)
+        {
+            Log(Debug::Error) << e.what();
+        }
+    }
+
     // Save user settings
     settings.saveUser(settingspath);
     Settings::ShaderManager::get().save();
@@ -21,6 +21,39 @@
 
 #include "selectwrapper.hpp"
 
+namespace
+{
+    MWDialogue::InfoIndex::Speaker makeSpeaker (const MWWorld::Ptr& actor)
+    {
+        MWDialogue::InfoIndex::Speaker speaker;
+        speaker.mId = Misc::StringUtils::lowerCase (actor.getCellRef().getRefId());
+        speaker.mIsCreature = (actor.getType() != ESM::NPC::sRecordId);
+        if (!speaker.mIsCreature)
+        {
+            const ESM::NPC* npc = actor.get<ESM::NPC>()->mBase;
+            speaker.mFaction = Misc::StringUtils::lowerCase (actor.getClass().getPrimaryFaction (actor));
+            speaker.mClass = Misc::StringUtils::lowerCase (npc->mClass);
+            speaker.mRace = Misc::StringUtils::lowerCase (npc->mRace);
+        }
+        return speaker;
+    }
+}
+
+std::vector<const ESM::DialInfo *> MWDialogue::Filter::getCandidates (const ESM::Dialogue& dialogue) const
+{
+    const MWWorld::Store<ESM::Dialogue>& dialogues =
+        MWBase::Environment::get().getWorld()->getStore().get<ESM::Dialogue>();
+
+    if (const InfoIndex* index = dialogues.getInfoIndex (dialogue))
+        return index->getCandidates (mSpeaker);
+
+    std::vector<const ESM::DialInfo *> infos;
+    infos.reserve (dialogue.mInfo.size());
+    for (const ESM::DialInfo& info : dialogue.mInfo)
+        infos.push_back (&info);
+    return infos;
+}
+
 bool MWDialogue::Filter::testActor (const ESM::DialInfo& info) const
 {
     bool isCreature = (mActor.getType() != ESM::NPC::sRecordId);
@@ -606,7 +639,7 @@ bool MWDialogue::Filter::hasFactionRankReputationRequirements (const MWWorld::Pt
 }
 
 MWDialogue::Filter::Filter (const MWWorld::Ptr& actor, int choice, bool talkedToPlayer)
-: mActor (actor), mChoice (choice), mTalkedToPlayer (talkedToPlayer)
+: mActor (actor), mChoice (choice), mTalkedToPlayer (talkedToPlayer), mSpeaker (makeSpeaker (actor))
 {}
 
 const ESM::DialInfo* MWDialogue::Filter::search (const ESM::Dialogue& dialogue, const bool fallbackToInfoRefusal) const
@@ -622,10 +655,10 @@ const ESM::DialInfo* MWDialogue::Filter::search (const ESM::Dialogue& dialogue,
 std::vector<const ESM::DialInfo *> MWDialogue::Filter::listAll (const ESM::Dialogue& dialogue) const
 {
     std::vector<const ESM::DialInfo *> infos;
-    for (ESM::Dialogue::InfoContainer::const_iterator iter = dialogue.mInfo.begin(); iter!=dialogue.mInfo.end(); ++iter)
+    for (const ESM::DialInfo* info : getCandidates (dialogue))
     {
-        if (testActor (*iter))
-            infos.push_back(&*iter);
+        if (testActor (*info))
+            infos.push_back(info);
     }
     return infos;
 }
@@ -638,13 +671,12 @@ std::vector<const ESM::DialInfo *> MWDialogue::Filter::list (const ESM::Dialogue
     bool infoRefusal = false;
 
     // Iterate over topic responses to find a matching one
-    for (ESM::Dialogue::InfoContainer::const_iterator iter = dialogue.mInfo.begin();
-        iter!=dialogue.mInfo.end(); ++iter)
+    for (const ESM::DialInfo* info : getCandidates (dialogue))
     {
-        if (testActor (*iter) && testPlayer (*iter) && testSelectStructs (*iter))
+        if (testActor (*info) && testPlayer (*info) && testSelectStructs (*info))
         {
-            if (testDisposition (*iter, invertDisposition)) {
-                infos.push_back(&*iter);
+            if (testDisposition (*info, invertDisposition)) {
+                infos.push_back(info);
                 if (!searchAll)
                     break;
             }
@@ -663,10 +695,9 @@ std::vector<const ESM::DialInfo *> MWDialogue::Filter::list (const ESM::Dialogue
 
         const ESM::Dialogue& infoRefusalDialogue = *dialogues.find ("Info Refusal");
 
-        for (ESM::Dialogue::InfoContainer::const_iterator iter = infoRefusalDialogue.mInfo.begin();
-            iter!=infoRefusalDialogue.mInfo.end(); ++iter)
-            if (testActor (*iter) && testPlayer (*iter) && testSelectStructs (*iter) && testDisposition(*iter, invertDisposition)) {
-                infos.push_back(&*iter);
+        for (const ESM::DialInfo* info : getCandidates (infoRefusalDialogue))
+            if (testActor (*info) && testPlayer (*info) && testSelectStructs (*info) && testDisposition(*info, invertDisposition)) {
+                infos.push_back(info);
                 if (!searchAll)
                     break;
             }
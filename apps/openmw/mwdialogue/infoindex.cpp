@@ -0,0 +1,80 @@
+#include "infoindex.hpp"
+
+#include <algorithm>
+
+#include <components/esm3/loaddial.hpp>
+#include <components/misc/stringops.hpp>
+
+namespace MWDialogue
+{
+    namespace
+    {
+        const std::vector<std::uint32_t>* findBucket(const std::unordered_map<std::string, std::vector<std::uint32_t>>& buckets,
+            const std::string& key)
+        {
+            if (key.empty())
+                return nullptr;
+            const auto it = buckets.find(key);
+            if (it == buckets.end())
+                return nullptr;
+            return &it->second;
+        }
+    }
+
+    InfoIndex::InfoIndex(const ESM::Dialogue& dialogue)
+    {
+        mInfos.reserve(dialogue.mInfo.size());
+        for (const ESM::DialInfo& info : dialogue.mInfo)
+        {
+            const std::uint32_t index = static_cast<std::uint32_t>(mInfos.size());
+            mInfos.push_back(&info);
+
+            // Same precedence as Filter::testActor, an info with an actor ID is only tested for that actor
+            if (!info.mActor.empty())
+                mByActor[Misc::StringUtils::lowerCase(info.mActor)].push_back(index);
+            else if (info.mFactionLess)
+                mFactionLess.push_back(index);
+            else if (!info.mFaction.empty())
+                mByFaction[Misc::StringUtils::lowerCase(info.mFaction)].push_back(index);
+            else if (!info.mClass.empty())
+                mByClass[Misc::StringUtils::lowerCase(info.mClass)].push_back(index);
+            else if (!info.mRace.empty())
+                mByRace[Misc::StringUtils::lowerCase(info.mRace)].push_back(index);
+            else
+                mUnconditional.push_back(index);
+        }
+    }
+
+    std::vector<const ESM::DialInfo*> InfoIndex::getCandidates(const Speaker& speaker) const
+    {
+        std::vector<const Bucket*> buckets;
+        buckets.push_back(findBucket(mByActor, speaker.mId));
+        // Creatures only use the infos specific to their ID
+        if (!speaker.mIsCreature)
+        {
+            buckets.push_back(speaker.mFaction.empty() ? &mFactionLess : findBucket(mByFaction, speaker.mFaction));
+            buckets.push_back(findBucket(mByClass, speaker.mClass));
+            buckets.push_back(findBucket(mByRace, speaker.mRace));
+            buckets.push_back(&mUnconditional);
+        }
+
+        std::vector<std::uint32_t> indices;
+        std::size_t numBuckets = 0;
+        for (const Bucket* bucket : buckets)
+        {
+            if (bucket == nullptr || bucket->empty())
+                continue;
+            indices.insert(indices.end(), bucket->begin(), bucket->end());
+            ++numBuckets;
+        }
+        // Each bucket is sorted and every info is in a single bucket
+        if (numBuckets > 1)
+            std::sort(indices.begin(), indices.end());
+
+        std::vector<const ESM::DialInfo*> result;
+        result.reserve(indices.size());
+        for (std::uint32_t index : indices)
+            result.push_back(mInfos[index]);
+        return result;
+    }
+}
@@ -0,0 +1,56 @@
+#ifndef GAME_MWDIALOGUE_INFOINDEX_H
+#define GAME_MWDIALOGUE_INFOINDEX_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ESM
+{
+    struct DialInfo;
+    struct Dialogue;
+}
+
+namespace MWDialogue
+{
+    /// @brief Infos of a dialogue bucketed by the speaker conditions that don't depend on the game state: actor ID,
+    ///     faction, class and race. Filter only tests the infos that can apply to the current speaker instead of
+    ///     scanning the whole dialogue.
+    class InfoIndex
+    {
+        public:
+            struct Speaker
+            {
+                /// All lower case, faction, class and race are empty for creatures
+                std::string mId;
+                std::string mFaction;
+                std::string mClass;
+                std::string mRace;
+                bool mIsCreature = false;
+            };
+
+            explicit InfoIndex(const ESM::Dialogue& dialogue);
+
+            /// @return the infos that may be spoken by the speaker, in the order of the dialogue. Their remaining
+            ///     conditions (rank, gender, player, select structs) still have to be tested.
+            std::vector<const ESM::DialInfo*> getCandidates(const Speaker& speaker) const;
+
+            std::size_t getSize() const { return mInfos.size(); }
+
+        private:
+            using Bucket = std::vector<std::uint32_t>;
+            using Buckets = std::unordered_map<std::string, Bucket>;
+
+            std::vector<const ESM::DialInfo*> mInfos;
+            Buckets mByActor;
+            // Infos for any actor are put in the first bucket matching one of their conditions
+            Buckets mByFaction;
+            Bucket mFactionLess;
+            Buckets mByClass;
+            Buckets mByRace;
+            Bucket mUnconditional;
+    };
+}
+
+#endif
@@ -1,17 +1,22 @@
 #ifndef GAME_MWDIALOGUE_KEYWORDSEARCH_H
 #define GAME_MWDIALOGUE_KEYWORDSEARCH_H
 
-#include <cctype>
-#include <map>
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <stdexcept>
+#include <utility>
 #include <vector>
-#include <algorithm>    // std::reverse
 
 #include <components/misc/stringops.hpp>
 
 namespace MWDialogue
 {
 
+/// @brief Finds keywords in a text, case insensitive for ASCII letters.
+/// @par Keywords are matched with an Aho-Corasick automaton: the text is read once, whatever the number of keywords.
+///     Seeding more keywords extends the trie, the suffix links are updated on the next search.
+/// @note Searching is not thread safe if keywords were seeded since the last search.
 template <typename string_t, typename value_t>
 class KeywordSearch
 {
@@ -26,46 +31,70 @@ public:
         value_t mValue;
     };
 
+    KeywordSearch ()
+    {
+        clear ();
+    }
+
     void seed (string_t keyword, value_t value)
     {
         if (keyword.empty())
             return;
-        seed_impl  (std::move(keyword), std::move (value), 0, mRoot);
+
+        std::uint32_t node = sRoot;
+        for (auto ch : keyword)
+        {
+            const unsigned char symbol = toSymbol (ch);
+            std::uint32_t next = findChild (node, symbol);
+            if (next == sNone)
+            {
+                next = static_cast<std::uint32_t> (mNodes.size ());
+                Node& child = mNodes.emplace_back ();
+                child.mSymbol = symbol;
+                child.mNextSibling = mNodes[node].mFirstChild;
+                mNodes[node].mFirstChild = next;
+                if (node == sRoot)
+                    mRootChildren[symbol] = next;
+            }
+            node = next;
+        }
+
+        Node& entry = mNodes[node];
+        if (entry.mKeyword != sNone)
+        {
+            if (mKeywords[entry.mKeyword].first == keyword)
+                throw std::runtime_error ("duplicate keyword inserted");
+            // Same keyword with a different letter case, the last one wins
+            mKeywords[entry.mKeyword] = std::make_pair (std::move (keyword), std::move (value));
+            return;
+        }
+
+        entry.mKeyword = static_cast<std::uint32_t> (mKeywords.size ());
+        mKeywords.emplace_back (std::move (keyword), std::move (value));
+        mLinksValid = false;
     }
 
     void clear ()
     {
-        mRoot.mChildren.clear ();
-        mRoot.mKeyword.clear ();
+        mNodes.assign (1, Node ());
+        mRootChildren.fill (sNone);
+        mKeywords.clear ();
+        mLinksValid = true;
     }
 
-    bool containsKeyword (const string_t& keyword, value_t& value)
+    bool containsKeyword (const string_t& keyword, value_t& value) const
     {
-        typename Entry::childen_t::iterator current;
-        typename Entry::childen_t::iterator next;
-
-        current = mRoot.mChildren.find (Misc::StringUtils::toLower (*keyword.begin()));
-        if (current == mRoot.mChildren.end())
-            return false;
-        else if (current->second.mKeyword.size() && Misc::StringUtils::ciEqual(current->second.mKeyword, keyword))
+        std::uint32_t node = sRoot;
+        for (auto ch : keyword)
         {
-            value = current->second.mValue;
-            return true;
-        }
-
-        for (Point i = ++keyword.begin(); i != keyword.end(); ++i)
-        {
-            next = current->second.mChildren.find(Misc::StringUtils::toLower (*i));
-            if (next == current->second.mChildren.end())
+            node = findChild (node, toSymbol (ch));
+            if (node == sNone)
                 return false;
-            if (Misc::StringUtils::ciEqual(next->second.mKeyword, keyword))
-            {
-                value = next->second.mValue;
-                return true;
-            }
-            current = next;
         }
-        return false;
+        if (node == sRoot || mNodes[node].mKeyword == sNone)
+            return false;
+        value = mKeywords[mNodes[node].mKeyword].second;
+        return true;
     }
 
 
@@ -76,115 +105,76 @@ public:
 
     void highlightKeywords (Point beg, Point end, std::vector<Match>& out) const
     {
+        updateLinks ();
+
         std::vector<Match> matches;
+        std::uint32_t node = sRoot;
         for (Point i = beg; i != end; ++i)
         {
-            // check first character
-            typename Entry::childen_t::const_iterator candidate = mRoot.mChildren.find (Misc::StringUtils::toLower (*i));
-
-            // no match, on to next character
-            if (candidate == mRoot.mChildren.end ())
-                continue;
-
-            // see how far the match goes
-            Point j = i;
-
-            // some keywords might be longer variations of other keywords, so we definitely need a list of candidates
-            // the first element in the pair is length of the match, i.e. depth from the first character on
-            std::vector< typename std::pair<int, typename Entry::childen_t::const_iterator> > candidates;
-
-            while ((j + 1) != end)
+            const unsigned char symbol = toSymbol (*i);
+            while (true)
             {
-                typename Entry::childen_t::const_iterator next = candidate->second.mChildren.find (Misc::StringUtils::toLower (*++j));
-
-                if (next == candidate->second.mChildren.end ())
+                const std::uint32_t next = findChild (node, symbol);
+                if (next != sNone)
                 {
-                    if (candidate->second.mKeyword.size() > 0)
-                        candidates.push_back(std::make_pair((j-i), candidate));
+                    node = next;
                     break;
                 }
-
-                candidate = next;
-
-                if (candidate->second.mKeyword.size() > 0)
-                    candidates.push_back(std::make_pair((j-i), candidate));
+                if (node == sRoot)
+                    break;
+                node = mNodes[node].mSuffix;
             }
 
-            if (candidates.empty())
-                continue; // didn't match enough to disambiguate, on to next character
-
-            // shorter candidates will be added to the vector first. however, we want to check against longer candidates first
-            std::reverse(candidates.begin(), candidates.end());
-
-            for (typename std::vector< std::pair<int, typename Entry::childen_t::const_iterator> >::iterator it = candidates.begin();
-                 it != candidates.end(); ++it)
+            // The keywords ending here, from the longest to the shortest
+            std::uint32_t output = mNodes[node].mKeyword != sNone ? node : mNodes[node].mOutput;
+            for (; output != sNone; output = mNodes[output].mOutput)
             {
-                candidate = it->second;
-                // try to match the rest of the keyword
-                Point k = i + it->first;
-                typename string_t::const_iterator t = candidate->second.mKeyword.begin () + (k - i);
-
-
-                while (k != end && t != candidate->second.mKeyword.end ())
-                {
-                    if (Misc::StringUtils::toLower (*k) != Misc::StringUtils::toLower (*t))
-                        break;
-
-                    ++k, ++t;
-                }
-
-                // didn't match full keyword, try the next candidate
-                if (t != candidate->second.mKeyword.end ())
-                    continue;
-
-                // found a keyword, but there might still be longer keywords that start somewhere _within_ this keyword
-                // we will resolve these overlapping keywords later, choosing the longest one in case of conflict
-                Match match;
-                match.mValue = candidate->second.mValue;
-                match.mBeg = i;
-                match.mEnd = k;
-                matches.push_back(match);
-                break;
+                const auto& [keyword, value] = mKeywords[mNodes[output].mKeyword];
+                matches.push_back (Match {i + 1 - keyword.size (), i + 1, value});
             }
         }
 
-        // resolve overlapping keywords
-        while (!matches.empty())
+        // Only keep the longest keyword starting at each position
+        std::sort (matches.begin (), matches.end (), [] (const Match& left, const Match& right)
+        {
+            return left.mBeg < right.mBeg || (left.mBeg == right.mBeg && left.mEnd > right.mEnd);
+        });
+        matches.erase (std::unique (matches.begin (), matches.end (),
+            [] (const Match& left, const Match& right) { return left.mBeg == right.mBeg; }), matches.end ());
+
+        // resolve overlapping keywords: repeatedly take the longest keyword of the first chain of overlapping keywords
+        // and drop everything it overlaps. Matches are sorted by their beginning, so only those beginning before the
+        // end of the taken keyword have to be checked.
+        std::vector<bool> removed (matches.size (), false);
+        const auto nextRemaining = [&] (std::size_t index)
         {
-            int longestKeywordSize = 0;
-            typename std::vector<Match>::iterator longestKeyword = matches.begin();
-            for (typename std::vector<Match>::iterator it = matches.begin(); it != matches.end(); ++it)
+            while (index < matches.size () && removed[index])
+                ++index;
+            return index;
+        };
+        for (std::size_t first = nextRemaining (0); first < matches.size (); first = nextRemaining (first))
+        {
+            std::size_t longestKeyword = first;
+            for (std::size_t it = first; ; )
             {
-                int size = it->mEnd - it->mBeg;
-                if (size > longestKeywordSize)
-                {
-                    longestKeywordSize = size;
+                if (matches[it].mEnd - matches[it].mBeg > matches[longestKeyword].mEnd - matches[longestKeyword].mBeg)
                     longestKeyword = it;
-                }
-
-                typename std::vector<Match>::iterator next = it;
-                ++next;
 
-                if (next == matches.end())
-                    break;
-
-                if (it->mEnd <= next->mBeg)
-                {
+                const std::size_t next = nextRemaining (it + 1);
+                if (next == matches.size () || matches[it].mEnd <= matches[next].mBeg)
                     break; // no overlap
-                }
+                it = next;
             }
 
-            Match keyword = *longestKeyword;
-            matches.erase(longestKeyword);
-            out.push_back(keyword);
+            const Match& keyword = matches[longestKeyword];
+            out.push_back (keyword);
             // erase anything that overlaps with the keyword we just added to the output
-            for (typename std::vector<Match>::iterator it = matches.begin(); it != matches.end();)
+            for (std::size_t it = first; it < matches.size () && matches[it].mBeg < keyword.mEnd; ++it)
             {
-                if (it->mBeg < keyword.mEnd && it->mEnd > keyword.mBeg)
-                    it = matches.erase(it);
-                else
-                    ++it;
+                if (it != longestKeyword && matches[it].mEnd > keyword.mBeg)
+                    removed[it] = true;
             }
+            removed[longestKeyword] = true;
         }
 
         std::sort(out.begin(), out.end(), sortMatches);
@@ -192,54 +182,83 @@ public:
 
 private:
 
-    struct Entry
-    {
-        typedef std::map <wchar_t, Entry> childen_t;
+    static constexpr std::uint32_t sRoot = 0;
+    static constexpr std::uint32_t sNone = ~std::uint32_t (0);
 
-        string_t mKeyword;
-        value_t mValue;
-        childen_t mChildren;
+    // The children of a node are a list of siblings, so that all nodes are in a single array
+    struct Node
+    {
+        std::uint32_t mFirstChild = sNone;
+        std::uint32_t mNextSibling = sNone;
+        // Longest proper suffix of this node that is also in the trie
+        std::uint32_t mSuffix = sRoot;
+        // Longest proper suffix of this node that is a keyword
+        std::uint32_t mOutput = sNone;
+        // Index in mKeywords
+        std::uint32_t mKeyword = sNone;
+        unsigned char mSymbol = 0;
     };
 
-    void seed_impl (string_t keyword, value_t value, size_t depth, Entry  & entry)
+    template <class Char>
+    static unsigned char toSymbol (Char ch)
     {
-        int ch = Misc::StringUtils::toLower (keyword.at (depth));
+        return static_cast<unsigned char> (Misc::StringUtils::toLower (static_cast<char> (ch)));
+    }
 
-        typename Entry::childen_t::iterator j = entry.mChildren.find (ch);
+    std::uint32_t findChild (std::uint32_t node, unsigned char symbol) const
+    {
+        // Most characters of a text fail back to the root, which has a table of its children
+        if (node == sRoot)
+            return mRootChildren[symbol];
+        for (std::uint32_t child = mNodes[node].mFirstChild; child != sNone; child = mNodes[child].mNextSibling)
+        {
+            if (mNodes[child].mSymbol == symbol)
+                return child;
+        }
+        return sNone;
+    }
+
+    void updateLinks () const
+    {
+        if (mLinksValid)
+            return;
 
-        if (j == entry.mChildren.end ())
+        // Breadth first, so that the links of the shorter suffixes are known
+        std::vector<std::uint32_t> queue;
+        queue.reserve (mNodes.size ());
+        for (std::uint32_t child = mNodes[sRoot].mFirstChild; child != sNone; child = mNodes[child].mNextSibling)
         {
-            entry.mChildren [ch].mValue = std::move (value);
-            entry.mChildren [ch].mKeyword = std::move (keyword);
+            mNodes[child].mSuffix = sRoot;
+            mNodes[child].mOutput = sNone;
+            queue.push_back (child);
         }
-        else
+        for (std::size_t i = 0; i < queue.size (); ++i)
         {
-            if (j->second.mKeyword.size () > 0)
+            const std::uint32_t node = queue[i];
+            for (std::uint32_t child = mNodes[node].mFirstChild; child != sNone; child = mNodes[child].mNextSibling)
             {
-                if (keyword == j->second.mKeyword)
-                    throw std::runtime_error ("duplicate keyword inserted");
-
-                value_t pushValue = j->second.mValue;
-                string_t pushKeyword = j->second.mKeyword;
-
-                if (depth >= pushKeyword.size ())
-                    throw std::runtime_error ("unexpected");
-
-                if (depth+1 < pushKeyword.size())
+                const unsigned char symbol = mNodes[child].mSymbol;
+                std::uint32_t suffix = mNodes[node].mSuffix;
+                std::uint32_t target = findChild (suffix, symbol);
+                while (target == sNone && suffix != sRoot)
                 {
-                    seed_impl (std::move (pushKeyword), std::move (pushValue), depth+1, j->second);
-                    j->second.mKeyword.clear ();
+                    suffix = mNodes[suffix].mSuffix;
+                    target = findChild (suffix, symbol);
                 }
+                const std::uint32_t childSuffix = target == sNone ? sRoot : target;
+                mNodes[child].mSuffix = childSuffix;
+                mNodes[child].mOutput = mNodes[childSuffix].mKeyword != sNone ? childSuffix : mNodes[childSuffix].mOutput;
+                queue.push_back (child);
             }
-            if (depth+1 == keyword.size())
-                j->second.mKeyword = value;
-            else // depth+1 < keyword.size()
-                seed_impl (std::move (keyword), std::move (value), depth+1, j->second);
         }
 
+        mLinksValid = true;
     }
 
-    Entry mRoot;
+    mutable std::vector<Node> mNodes;
+    std::array<std::uint32_t, 256> mRootChildren;
+    std::vector<std::pair<string_t, value_t>> mKeywords;
+    mutable bool mLinksValid;
 };
 
 }
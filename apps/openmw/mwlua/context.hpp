@@ -21,6 +21,9 @@ namespace MWLua
         LuaManager* mLuaManager;
         LuaUtil::LuaState* mLua;
         LuaUtil::UserdataSerializer* mSerializer;
+        // Serializers of the receivers of global and local events
+        LuaUtil::UserdataSerializer* mGlobalSerializer;
+        LuaUtil::UserdataSerializer* mLocalSerializer;
         LuaUtil::L10nManager* mL10n;
         WorldView* mWorldView;
         LocalEventQueue* mLocalEventQueue;
@@ -46,6 +46,31 @@ namespace MWLua
             });
         };
 
+        api["getScriptStats"] = [lua = context.mLua] ()
+        {
+            const LuaUtil::ScriptsConfiguration& conf = lua->getConfiguration();
+            const std::vector<LuaUtil::LuaState::ScriptStats>& stats = lua->getScriptStats();
+            sol::table res = lua->newTable();
+            for (std::size_t i = 0; i < stats.size() && i < conf.size(); ++i)
+            {
+                if (stats[i].mCalls == 0)
+                    continue;
+                sol::table scriptStats = lua->newTable();
+                scriptStats["time"] = stats[i].mTime;
+                scriptStats["calls"] = stats[i].mCalls;
+                scriptStats["allocated"] = stats[i].mAllocatedBytes;
+                res[conf[i].mScriptPath] = scriptStats;
+            }
+            return res;
+        };
+
+        api["getLuaMemoryUsage"] = [lua = context.mLua] () { return lua->getMemoryUsage(); };
+
+        api["resetScriptStats"] = [context] ()
+        {
+            context.mLuaManager->addAction([lua = context.mLua] { lua->resetScriptStats(); });
+        };
+
         return LuaUtil::makeReadOnly(api);
     }
 }
@@ -12,30 +12,34 @@ namespace MWLua
 {
 
     template <typename Event>
-    void saveEvent(ESM::ESMWriter& esm, const ObjectId& dest, const Event& event)
+    void saveEvent(ESM::ESMWriter& esm, const ObjectId& dest, const Event& event, const LuaUtil::UserdataSerializer* serializer)
     {
         esm.writeHNString("LUAE", event.mEventName);
         dest.save(esm, true);
-        if (!event.mEventData.empty())
-            saveLuaBinaryData(esm, event.mEventData);
+        std::string data = LuaUtil::serialize(event.mEventData, serializer);
+        if (!data.empty())
+            saveLuaBinaryData(esm, data);
     }
 
     void loadEvents(sol::state& lua, ESM::ESMReader& esm, GlobalEventQueue& globalEvents, LocalEventQueue& localEvents,
-                    const std::map<int, int>& contentFileMapping, const LuaUtil::UserdataSerializer* serializer)
+                    const std::map<int, int>& contentFileMapping, const LuaUtil::UserdataSerializer* globalSerializer,
+                    const LuaUtil::UserdataSerializer* localSerializer)
     {
         while (esm.isNextSub("LUAE"))
         {
             std::string name = esm.getHString();
             ObjectId dest;
             dest.load(esm, true);
-            std::string data = loadLuaBinaryData(esm);
+            std::string binaryData = loadLuaBinaryData(esm);
+            sol::object data;
             try
             {
-                data = LuaUtil::serialize(LuaUtil::deserialize(lua, data, serializer), serializer);
+                data = LuaUtil::deserialize(lua, binaryData, dest.isSet() ? localSerializer : globalSerializer);
             }
             catch (std::exception& e)
             {
                 Log(Debug::Error) << "loadEvent: invalid event data: " << e.what();
+                continue;
             }
             if (dest.isSet())
             {
@@ -49,15 +53,16 @@ namespace MWLua
         }
     }
 
-    void saveEvents(ESM::ESMWriter& esm, const GlobalEventQueue& globalEvents, const LocalEventQueue& localEvents)
+    void saveEvents(ESM::ESMWriter& esm, const GlobalEventQueue& globalEvents, const LocalEventQueue& localEvents,
+                    const LuaUtil::UserdataSerializer* serializer)
     {
         ObjectId globalId;
         globalId.unset();  // Used as a marker of a global event.
 
         for (const GlobalEvent& e : globalEvents)
-            saveEvent(esm, globalId, e);
+            saveEvent(esm, globalId, e, serializer);
         for (const LocalEvent& e : localEvents)
-            saveEvent(esm, e.mDest, e);
+            saveEvent(esm, e.mDest, e, serializer);
     }
 
 }
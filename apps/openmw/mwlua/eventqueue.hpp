@@ -21,23 +21,26 @@ namespace sol
 
 namespace MWLua
 {
+    // Event data is kept as a deep copy made by `LuaUtil::copy` for the receiver. It is serialized only when saved.
     struct GlobalEvent
     {
         std::string mEventName;
-        std::string mEventData;
+        sol::object mEventData;
     };
     struct LocalEvent
     {
         ObjectId mDest;
         std::string mEventName;
-        std::string mEventData;
+        sol::object mEventData;
     };
     using GlobalEventQueue = std::vector<GlobalEvent>;
     using LocalEventQueue = std::vector<LocalEvent>;
 
     void loadEvents(sol::state& lua, ESM::ESMReader& esm, GlobalEventQueue&, LocalEventQueue&,
-                    const std::map<int, int>& contentFileMapping, const LuaUtil::UserdataSerializer* serializer);
-    void saveEvents(ESM::ESMWriter& esm, const GlobalEventQueue&, const LocalEventQueue&);
+                    const std::map<int, int>& contentFileMapping, const LuaUtil::UserdataSerializer* globalSerializer,
+                    const LuaUtil::UserdataSerializer* localSerializer);
+    void saveEvents(ESM::ESMWriter& esm, const GlobalEventQueue&, const LocalEventQueue&,
+                    const LuaUtil::UserdataSerializer* serializer);
 }
 
 #endif // MWLUA_EVENTQUEUE_H
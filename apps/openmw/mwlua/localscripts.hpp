@@ -69,10 +69,27 @@ namespace MWLua
         void receiveEngineEvent(const EngineEvent&);
 
         void applyStatsCache();
+
+        // `onUpdate` can be skipped if Lua exceeds its frame budget. The skipped time is added to `dt` of the next call.
+        void update(float dt)
+        {
+            ScriptsContainer::update(dt + mDeferredUpdateTime);
+            mDeferredUpdateTime = 0;
+        }
+        void deferUpdate(float dt) { mDeferredUpdateTime += dt; }
+        bool isUpdateDeferred() const { return mDeferredUpdateTime > 0; }
+
+        // Index of the Lua state the scripts run in (see `[Lua] lua local script shards`), 0 is the main state.
+        std::size_t getShard() const { return mShard; }
+        void setShard(std::size_t shard) { mShard = shard; }
+
     protected:
         SelfObject mData;
 
     private:
+        float mDeferredUpdateTime = 0;
+        std::size_t mShard = 0;
+
         EngineHandlerList mOnActiveHandlers{"onActive"};
         EngineHandlerList mOnInactiveHandlers{"onInactive"};
         EngineHandlerList mOnConsumeHandlers{"onConsume"};
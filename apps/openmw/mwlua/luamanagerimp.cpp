@@ -1,6 +1,12 @@
 #include "luamanagerimp.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <exception>
 #include <filesystem>
+#include <iterator>
+
+#include <osg/Stats>
 
 #include <components/debug/debuglog.hpp>
 
@@ -12,6 +18,8 @@
 
 #include <components/lua/utilpackage.hpp>
 
+#include <components/misc/hash.hpp>
+
 #include <components/lua_ui/util.hpp>
 
 #include "../mwbase/windowmanager.hpp"
@@ -28,6 +36,38 @@
 namespace MWLua
 {
 
+    namespace
+    {
+        // Lua objects can not be shared between Lua states, event data is passed to another state in serialized form.
+        sol::object transferEventData(LuaUtil::LuaState& to, const sol::object& data,
+            const LuaUtil::UserdataSerializer* serializer, const LuaUtil::UserdataSerializer* deserializer)
+        {
+            return LuaUtil::deserialize(to.sol(), LuaUtil::serialize(data, serializer), deserializer);
+        }
+    }
+
+    thread_local LuaManager::Shard* LuaManager::sCurrentShard = nullptr;
+
+    LuaManager::Shard::Shard(const VFS::Manager* vfs, const LuaUtil::ScriptsConfiguration* conf)
+        : mLua(vfs, conf)
+        , mL10n(vfs, &mLua)
+    {
+    }
+
+    void LuaManager::GlobalStorageListener::valueChanged(std::string_view section, std::string_view key,
+                                                         const sol::object& value) const
+    {
+        for (const std::unique_ptr<Shard>& shard : mShards)
+            shard->mGlobalStorage.setSingleValue(section, key, value);
+    }
+
+    void LuaManager::GlobalStorageListener::sectionReplaced(std::string_view section,
+                                                            const sol::optional<sol::table>& values) const
+    {
+        for (const std::unique_ptr<Shard>& shard : mShards)
+            shard->mGlobalStorage.setSectionValues(section, values);
+    }
+
     LuaManager::LuaManager(const VFS::Manager* vfs, const std::string& libsDir)
         : mLua(vfs, &mConfiguration)
         , mUiResourceManager(vfs)
@@ -36,6 +76,14 @@ namespace MWLua
         Log(Debug::Info) << "Lua version: " << LuaUtil::getLuaVersion();
         mLua.addInternalLibSearchPath(libsDir);
 
+        const int numShards = Settings::Manager::getInt("lua local script shards", "Lua");
+        for (int i = 0; i < numShards; ++i)
+        {
+            mShards.push_back(std::make_unique<Shard>(vfs, &mConfiguration));
+            mShards.back()->mLua.addInternalLibSearchPath(libsDir);
+        }
+        mShardFrames.resize(mShards.size() + 1);
+
         mGlobalSerializer = createUserdataSerializer(false, mWorldView.getObjectRegistry());
         mLocalSerializer = createUserdataSerializer(true, mWorldView.getObjectRegistry());
         mGlobalLoader = createUserdataSerializer(false, mWorldView.getObjectRegistry(), &mContentFileMapping);
@@ -44,6 +92,17 @@ namespace MWLua
         mGlobalScripts.setSerializer(mGlobalSerializer.get());
     }
 
+    LuaManager::~LuaManager()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mShardMutex);
+            mStopShards = true;
+        }
+        mShardsHaveWork.notify_all();
+        for (std::thread& thread : mShardThreads)
+            thread.join();
+    }
+
     void LuaManager::initConfiguration()
     {
         mConfiguration.init(MWBase::Environment::get().getWorld()->getStore().getLuaScriptsCfg());
@@ -63,6 +122,8 @@ namespace MWLua
         context.mLocalEventQueue = &mLocalEvents;
         context.mGlobalEventQueue = &mGlobalEvents;
         context.mSerializer = mGlobalSerializer.get();
+        context.mGlobalSerializer = mGlobalSerializer.get();
+        context.mLocalSerializer = mLocalSerializer.get();
 
         Context localContext = context;
         localContext.mIsGlobal = false;
@@ -99,10 +160,48 @@ namespace MWLua
         mPostprocessingPackage = initPostprocessingPackage(localContext);
         mDebugPackage = initDebugPackage(localContext);
 
+        for (const std::unique_ptr<Shard>& shard : mShards)
+            initShard(*shard, localContext, preferredLocales);
+        if (!mShards.empty())
+        {
+            mGlobalStorage.setListener(&mGlobalStorageListener);
+            Log(Debug::Info) << "Local Lua scripts are distributed across " << mShards.size() + 1 << " Lua states";
+        }
+        for (std::size_t i = 1; i <= mShards.size(); ++i)
+            mShardThreads.emplace_back([this, i, generation = mShardGeneration] { runShardThread(i, generation); });
+
         initConfiguration();
         mInitialized = true;
     }
 
+    void LuaManager::initShard(Shard& shard, Context context, const std::vector<std::string>& preferredLocales)
+    {
+        LuaUtil::LuaState& lua = shard.mLua;
+        context.mLua = &lua;
+        context.mL10n = &shard.mL10n;
+        context.mLocalEventQueue = &shard.mLocalEvents;
+        context.mGlobalEventQueue = &shard.mGlobalEvents;
+        // Global events are converted to their final form when they are moved to the main state
+        context.mGlobalSerializer = mLocalSerializer.get();
+
+        shard.mL10n.init();
+        shard.mL10n.setPreferredLocales(preferredLocales);
+
+        initObjectBindingsForLocalScripts(context);
+        initCellBindingsForLocalScripts(context);
+        LocalScripts::initializeSelfPackage(context);
+        LuaUtil::LuaStorage::initLuaBindings(lua.sol());
+
+        lua.addCommonPackage("openmw.async", getAsyncPackageInitializer(context));
+        lua.addCommonPackage("openmw.util", LuaUtil::initUtilPackage(lua.sol()));
+        lua.addCommonPackage("openmw.core", initCorePackage(context));
+        lua.addCommonPackage("openmw.types", initTypesPackage(context));
+
+        shard.mNearbyPackage = initNearbyPackage(context);
+        shard.mSettingsPackage = initGlobalSettingsPackage(context);
+        shard.mStoragePackage = initLocalStoragePackage(context, &shard.mGlobalStorage);
+    }
+
     void LuaManager::loadPermanentStorage(const std::string& userConfigPath)
     {
         auto globalPath = std::filesystem::path(userConfigPath) / "global_storage.bin";
@@ -126,7 +225,10 @@ namespace MWLua
         if (mPlayer.isEmpty())
             return;  // The game is not started yet.
 
-        float frameDuration = MWBase::Environment::get().getFrameDuration();
+        mUpdateStart = std::chrono::steady_clock::now();
+        const LuaUtil::LuaState::ScriptStats totalStats = getTotalStats();
+
+        mFrameDuration = MWBase::Environment::get().getFrameDuration();
         ObjectRegistry* objectRegistry = mWorldView.getObjectRegistry();
 
         MWWorld::Ptr newPlayerPtr = MWBase::Environment::get().getWorld()->getPlayerPtr();
@@ -144,57 +246,51 @@ namespace MWLua
         std::vector<LocalEvent> localEvents = std::move(mLocalEvents);
         mGlobalEvents = std::vector<GlobalEvent>();
         mLocalEvents = std::vector<LocalEvent>();
+        for (const std::unique_ptr<Shard>& shard : mShards)
+        {
+            for (GlobalEvent& e : shard->mGlobalEvents)
+                globalEvents.push_back({std::move(e.mEventName),
+                    transferEventData(mLua, e.mEventData, mLocalSerializer.get(), mGlobalSerializer.get())});
+            shard->mGlobalEvents.clear();
+        }
+
+        for (LocalScripts* scripts : mActiveLocalScripts)
+            mShardFrames[scripts->getShard()].mActiveScripts.push_back(scripts);
+
+        // Without shards local timers and events are processed here, in the same order as global ones.
+        // Otherwise updateShard processes them in parallel after the queued callbacks.
+        const bool serialLocalScripts = mShards.empty();
 
         if (!mWorldView.isPaused())
         {  // Update time and process timers
-            double simulationTime = mWorldView.getSimulationTime() + frameDuration;
+            double simulationTime = mWorldView.getSimulationTime() + mFrameDuration;
             mWorldView.setSimulationTime(simulationTime);
-            double gameTime = mWorldView.getGameTime();
-
-            mGlobalScripts.processTimers(simulationTime, gameTime);
-            for (LocalScripts* scripts : mActiveLocalScripts)
-                scripts->processTimers(simulationTime, gameTime);
+            mGlobalScripts.processTimers(simulationTime, mWorldView.getGameTime());
+            if (serialLocalScripts)
+                processLocalTimers(mShardFrames[0]);
         }
 
         // Receive events
         for (GlobalEvent& e : globalEvents)
             mGlobalScripts.receiveEvent(e.mEventName, e.mEventData);
-        for (LocalEvent& e : localEvents)
-        {
-            LObject obj(e.mDest, objectRegistry);
-            LocalScripts* scripts = obj.isValid() ? obj.ptr().getRefData().getLuaScripts() : nullptr;
-            if (scripts)
-                scripts->receiveEvent(e.mEventName, e.mEventData);
-            else
-                Log(Debug::Debug) << "Ignored event " << e.mEventName << " to L" << idToString(e.mDest)
-                                  << ". Object not found or has no attached scripts";
-        }
+        distributeLocalEvents(std::move(localEvents), 0);
+        for (std::size_t i = 0; i < mShards.size(); ++i)
+            distributeLocalEvents(std::move(mShards[i]->mLocalEvents), i + 1);
+        if (serialLocalScripts)
+            receiveLocalEvents(mShardFrames[0]);
 
         // Run queued callbacks
         for (CallbackWithData& c : mQueuedCallbacks)
             c.mCallback(c.mArg);
         mQueuedCallbacks.clear();
 
-        // Engine handlers in local scripts
-        for (const LocalEngineEvent& e : mLocalEngineEvents)
+        // Local scripts
+        distributeLocalEngineEvents();
+        updateShards();
+        for (const std::unique_ptr<Shard>& shard : mShards)
         {
-            LObject obj(e.mDest, objectRegistry);
-            if (!obj.isValid())
-            {
-                if (luaDebug)
-                    Log(Debug::Verbose) << "Can not call engine handlers: object" << idToString(e.mDest) << " is not found";
-                continue;
-            }
-            LocalScripts* scripts = obj.ptr().getRefData().getLuaScripts();
-            if (scripts)
-                scripts->receiveEngineEvent(e.mEvent);
-        }
-        mLocalEngineEvents.clear();
-
-        if (!mWorldView.isPaused())
-        {
-            for (LocalScripts* scripts : mActiveLocalScripts)
-                scripts->update(frameDuration);
+            std::move(shard->mActionQueue.begin(), shard->mActionQueue.end(), std::back_inserter(mActionQueue));
+            shard->mActionQueue.clear();
         }
 
         // Engine handlers in global scripts
@@ -220,7 +316,212 @@ namespace MWLua
         mActorAddedEvents.clear();
 
         if (!mWorldView.isPaused())
-            mGlobalScripts.update(frameDuration);
+            mGlobalScripts.update(mFrameDuration);
+
+        const LuaUtil::LuaState::ScriptStats newTotalStats = getTotalStats();
+        mFrameStats.mCalls = newTotalStats.mCalls - totalStats.mCalls;
+        mFrameStats.mAllocatedBytes = newTotalStats.mAllocatedBytes - totalStats.mAllocatedBytes;
+        mFrameStats.mTime = newTotalStats.mTime - totalStats.mTime;
+    }
+
+    void LuaManager::distributeLocalEvents(LocalEventQueue&& events, std::size_t sourceShard)
+    {
+        ObjectRegistry* objectRegistry = mWorldView.getObjectRegistry();
+        for (LocalEvent& e : events)
+        {
+            LObject obj(e.mDest, objectRegistry);
+            LocalScripts* scripts = obj.isValid() ? obj.ptr().getRefData().getLuaScripts() : nullptr;
+            if (!scripts)
+            {
+                Log(Debug::Debug) << "Ignored event " << e.mEventName << " to L" << idToString(e.mDest)
+                                  << ". Object not found or has no attached scripts";
+                continue;
+            }
+            const std::size_t shard = scripts->getShard();
+            if (shard != sourceShard)
+                e.mEventData = transferEventData(getShardLua(shard), e.mEventData, mLocalSerializer.get(), mLocalSerializer.get());
+            mShardFrames[shard].mEvents.emplace_back(scripts, std::move(e));
+        }
+        events.clear();
+    }
+
+    void LuaManager::distributeLocalEngineEvents()
+    {
+        static const bool luaDebug = Settings::Manager::getBool("lua debug", "Lua");
+        ObjectRegistry* objectRegistry = mWorldView.getObjectRegistry();
+        for (LocalEngineEvent& e : mLocalEngineEvents)
+        {
+            LObject obj(e.mDest, objectRegistry);
+            if (!obj.isValid())
+            {
+                if (luaDebug)
+                    Log(Debug::Verbose) << "Can not call engine handlers: object" << idToString(e.mDest) << " is not found";
+                continue;
+            }
+            LocalScripts* scripts = obj.ptr().getRefData().getLuaScripts();
+            if (scripts)
+                mShardFrames[scripts->getShard()].mEngineEvents.emplace_back(scripts, std::move(e.mEvent));
+        }
+        mLocalEngineEvents.clear();
+    }
+
+    void LuaManager::updateShards()
+    {
+        if (!mShardThreads.empty())
+        {
+            {
+                std::lock_guard<std::mutex> lock(mShardMutex);
+                mBusyShards = mShardThreads.size();
+                ++mShardGeneration;
+            }
+            mShardsHaveWork.notify_all();
+        }
+
+        // The other shards must be finished before leaving even if the main one fails
+        std::exception_ptr error;
+        try
+        {
+            updateShard(0);
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+
+        if (!mShardThreads.empty())
+        {
+            std::unique_lock<std::mutex> lock(mShardMutex);
+            mShardsDone.wait(lock, [this] { return mBusyShards == 0; });
+        }
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    void LuaManager::runShardThread(std::size_t shard, unsigned int generation)
+    {
+        sCurrentShard = mShards[shard - 1].get();
+        std::unique_lock<std::mutex> lock(mShardMutex);
+        while (true)
+        {
+            mShardsHaveWork.wait(lock, [&] { return mStopShards || mShardGeneration != generation; });
+            if (mStopShards)
+                return;
+            generation = mShardGeneration;
+
+            lock.unlock();
+            try
+            {
+                updateShard(shard);
+            }
+            catch (const std::exception& e)
+            {
+                Log(Debug::Error) << "Error in Lua shard " << shard << ": " << e.what();
+            }
+            lock.lock();
+
+            if (--mBusyShards == 0)
+                mShardsDone.notify_one();
+        }
+    }
+
+    void LuaManager::updateShard(std::size_t shard)
+    {
+        ShardFrame& frame = mShardFrames[shard];
+        const bool paused = mWorldView.isPaused();
+
+        if (!mShards.empty())
+        {  // Otherwise already done by `update`
+            if (!paused)
+                processLocalTimers(frame);
+            receiveLocalEvents(frame);
+        }
+
+        for (const auto& [scripts, event] : frame.mEngineEvents)
+            scripts->receiveEngineEvent(event);
+        frame.mEngineEvents.clear();
+
+        if (!paused)
+            updateLocalScripts(frame, mFrameDuration);
+        else
+            frame.mNumDeferredUpdates = 0;
+        frame.mActiveScripts.clear();
+    }
+
+    void LuaManager::processLocalTimers(ShardFrame& frame)
+    {
+        const double simulationTime = mWorldView.getSimulationTime();
+        const double gameTime = mWorldView.getGameTime();
+        for (LocalScripts* scripts : frame.mActiveScripts)
+            scripts->processTimers(simulationTime, gameTime);
+    }
+
+    void LuaManager::receiveLocalEvents(ShardFrame& frame)
+    {
+        for (auto& [scripts, e] : frame.mEvents)
+            scripts->receiveEvent(e.mEventName, e.mEventData);
+        frame.mEvents.clear();
+    }
+
+    void LuaManager::updateLocalScripts(ShardFrame& frame, float frameDuration)
+    {
+        static const float frameBudget = Settings::Manager::getFloat("frame budget", "Lua");
+        frame.mNumDeferredUpdates = 0;
+        if (frameBudget <= 0)
+        {
+            for (LocalScripts* scripts : frame.mActiveScripts)
+                scripts->update(frameDuration);
+            return;
+        }
+
+        // Scripts of the player are never deferred, the ones deferred in the previous frames go next,
+        // so that every script is eventually updated.
+        LocalScripts* playerScripts = mPlayer.getRefData().getLuaScripts();
+        frame.mUpdateOrder.assign(frame.mActiveScripts.begin(), frame.mActiveScripts.end());
+        std::stable_partition(frame.mUpdateOrder.begin(), frame.mUpdateOrder.end(),
+            [&] (LocalScripts* scripts) { return scripts == playerScripts || scripts->isUpdateDeferred(); });
+
+        const auto deadline = mUpdateStart + std::chrono::duration<float, std::milli>(frameBudget);
+        bool overBudget = false;
+        for (LocalScripts* scripts : frame.mUpdateOrder)
+        {
+            if (scripts != playerScripts && !overBudget)
+                overBudget = std::chrono::steady_clock::now() > deadline;
+            if (scripts != playerScripts && overBudget)
+            {
+                scripts->deferUpdate(frameDuration);
+                ++frame.mNumDeferredUpdates;
+            }
+            else
+                scripts->update(frameDuration);
+        }
+    }
+
+    LuaUtil::LuaState::ScriptStats LuaManager::getTotalStats() const
+    {
+        LuaUtil::LuaState::ScriptStats result = mLua.getTotalStats();
+        for (const std::unique_ptr<Shard>& shard : mShards)
+        {
+            const LuaUtil::LuaState::ScriptStats& stats = shard->mLua.getTotalStats();
+            result.mTime += stats.mTime;
+            result.mCalls += stats.mCalls;
+            result.mAllocatedBytes += stats.mAllocatedBytes;
+        }
+        return result;
+    }
+
+    void LuaManager::reportStats(unsigned int frameNumber, osg::Stats& stats) const
+    {
+        std::size_t memoryUsage = mLua.getMemoryUsage();
+        for (const std::unique_ptr<Shard>& shard : mShards)
+            memoryUsage += shard->mLua.getMemoryUsage();
+        std::size_t numDeferredUpdates = 0;
+        for (const ShardFrame& frame : mShardFrames)
+            numDeferredUpdates += frame.mNumDeferredUpdates;
+
+        stats.setAttribute(frameNumber, "Lua Calls", mFrameStats.mCalls);
+        stats.setAttribute(frameNumber, "Lua Allocated KiB", mFrameStats.mAllocatedBytes / 1024.0);
+        stats.setAttribute(frameNumber, "Lua Memory KiB", memoryUsage / 1024.0);
+        stats.setAttribute(frameNumber, "Lua Deferred", numDeferredUpdates);
     }
 
     void LuaManager::synchronizedUpdate()
@@ -282,6 +583,30 @@ namespace MWLua
         }
         mGlobalStorage.clearTemporaryAndRemoveCallbacks();
         mPlayerStorage.clearTemporaryAndRemoveCallbacks();
+        for (ShardFrame& frame : mShardFrames)
+        {
+            frame.mActiveScripts.clear();
+            frame.mEvents.clear();
+            frame.mEngineEvents.clear();
+            frame.mUpdateOrder.clear();
+            frame.mNumDeferredUpdates = 0;
+        }
+        if (mShards.empty())
+            return;
+        // The copies of global storage don't know which sections are temporary
+        const sol::table globalSections = mGlobalStorage.getAllSections(true);
+        for (const std::unique_ptr<Shard>& shard : mShards)
+        {
+            shard->mGlobalEvents.clear();
+            shard->mLocalEvents.clear();
+            shard->mActionQueue.clear();
+            shard->mGlobalStorage.clearTemporaryAndRemoveCallbacks();
+            for (const auto& [section, _] : shard->mGlobalStorage.getAllSections(true))
+            {
+                if (globalSections[section] == sol::nil)
+                    shard->mGlobalStorage.setSectionValues(section.as<std::string_view>(), sol::nullopt);
+            }
+        }
     }
 
     void LuaManager::setupPlayer(const MWWorld::Ptr& ptr)
@@ -322,6 +647,11 @@ namespace MWLua
     {
         mWorldView.objectAddedToScene(ptr);  // assigns generated RefNum if it is not set yet.
 
+        // The inventory of a container is created on first access with a seed from the world PRNG. With shards the
+        // order of the first accesses from local scripts depends on the threads, so it is created here instead.
+        if (!mShards.empty() && ptr.getType() == ESM::REC_CONT)
+            ptr.getClass().getContainerStore(ptr);
+
         LocalScripts* localScripts = ptr.getRefData().getLuaScripts();
         if (!localScripts)
         {
@@ -395,13 +725,34 @@ namespace MWLua
         localScripts->addCustomScript(scriptId);
     }
 
+    std::size_t LuaManager::selectShard(const MWWorld::Ptr& ptr, ESM::LuaScriptCfg::Flags flag) const
+    {
+        if (mShards.empty() || flag == ESM::LuaScriptCfg::sPlayer)
+            return 0;
+        // Depends only on the object, so that the order of events and actions doesn't depend on the history of the session
+        const ObjectId id = getId(ptr);
+        std::size_t hash = id.mIndex;
+        Misc::hashCombine(hash, id.mContentFile);
+        return hash % (mShards.size() + 1);
+    }
+
     LocalScripts* LuaManager::createLocalScripts(const MWWorld::Ptr& ptr, ESM::LuaScriptCfg::Flags flag)
     {
         assert(mInitialized);
         assert(flag != ESM::LuaScriptCfg::sGlobal);
         assert(ptr.getType() != ESM::REC_STAT);
+        const std::size_t shard = selectShard(ptr, flag);
         std::shared_ptr<LocalScripts> scripts;
-        if (flag == ESM::LuaScriptCfg::sPlayer)
+        if (shard != 0)
+        {
+            Shard& data = *mShards[shard - 1];
+            scripts = std::make_shared<LocalScripts>(&data.mLua, LObject(getId(ptr), mWorldView.getObjectRegistry()), flag);
+            scripts->addPackage("openmw.settings", data.mSettingsPackage);
+            scripts->addPackage("openmw.storage", data.mStoragePackage);
+            scripts->addPackage("openmw.nearby", data.mNearbyPackage);
+            scripts->setShard(shard);
+        }
+        else if (flag == ESM::LuaScriptCfg::sPlayer)
         {
             assert(ptr.getCellRef().getRefId() == "player");
             scripts = std::make_shared<PlayerScripts>(&mLua, LObject(getId(ptr), mWorldView.getObjectRegistry()));
@@ -419,7 +770,8 @@ namespace MWLua
             scripts->addPackage("openmw.settings", mLocalSettingsPackage);
             scripts->addPackage("openmw.storage", mLocalStoragePackage);
         }
-        scripts->addPackage("openmw.nearby", mNearbyPackage);
+        if (shard == 0)
+            scripts->addPackage("openmw.nearby", mNearbyPackage);
         scripts->setSerializer(mLocalSerializer.get());
 
         MWWorld::RefData& refData = ptr.getRefData();
@@ -435,7 +787,19 @@ namespace MWLua
         ESM::LuaScripts globalScripts;
         mGlobalScripts.save(globalScripts);
         globalScripts.save(writer);
-        saveEvents(writer, mGlobalEvents, mLocalEvents);
+        if (mShards.empty())
+            saveEvents(writer, mGlobalEvents, mLocalEvents, mGlobalSerializer.get());
+        else
+        {
+            GlobalEventQueue globalEvents = mGlobalEvents;
+            LocalEventQueue localEvents = mLocalEvents;
+            for (const std::unique_ptr<Shard>& shard : mShards)
+            {
+                globalEvents.insert(globalEvents.end(), shard->mGlobalEvents.begin(), shard->mGlobalEvents.end());
+                localEvents.insert(localEvents.end(), shard->mLocalEvents.begin(), shard->mLocalEvents.end());
+            }
+            saveEvents(writer, globalEvents, localEvents, mGlobalSerializer.get());
+        }
 
         writer.endRecord(ESM::REC_LUAM);
     }
@@ -448,7 +812,7 @@ namespace MWLua
         mWorldView.load(reader);
         ESM::LuaScripts globalScripts;
         globalScripts.load(reader);
-        loadEvents(mLua.sol(), reader, mGlobalEvents, mLocalEvents, mContentFileMapping, mGlobalLoader.get());
+        loadEvents(mLua.sol(), reader, mGlobalEvents, mLocalEvents, mContentFileMapping, mGlobalLoader.get(), mLocalLoader.get());
 
         mGlobalScripts.setSerializer(mGlobalLoader.get());
         mGlobalScripts.load(globalScripts);
@@ -493,6 +857,13 @@ namespace MWLua
         mUiResourceManager.clear();
         mLua.dropScriptCache();
         initConfiguration();
+        // Script ids can change with the configuration
+        mLua.resetScriptStats();
+        for (const std::unique_ptr<Shard>& shard : mShards)
+        {
+            shard->mLua.dropScriptCache();
+            shard->mLua.resetScriptStats();
+        }
 
         {  // Reload global scripts
             ESM::LuaScripts data;
@@ -575,7 +946,13 @@ namespace MWLua
 
     void LuaManager::addAction(std::function<void()> action, std::string_view name)
     {
-        mActionQueue.push_back(std::make_unique<FunctionAction>(&mLua, std::move(action), name));
+        LuaUtil::LuaState* lua = sCurrentShard ? &sCurrentShard->mLua : &mLua;
+        getActionQueue().push_back(std::make_unique<FunctionAction>(lua, std::move(action), name));
+    }
+
+    std::vector<std::unique_ptr<LuaManager::Action>>& LuaManager::getActionQueue()
+    {
+        return sCurrentShard ? sCurrentShard->mActionQueue : mActionQueue;
     }
 
 }
@@ -1,8 +1,13 @@
 #ifndef MWLUA_LUAMANAGERIMP_H
 #define MWLUA_LUAMANAGERIMP_H
 
+#include <chrono>
+#include <condition_variable>
 #include <map>
+#include <mutex>
 #include <set>
+#include <thread>
+#include <vector>
 
 #include <components/lua/l10n.hpp>
 #include <components/lua/luastate.hpp>
@@ -15,6 +20,7 @@
 #include "../mwbase/luamanager.hpp"
 
 #include "object.hpp"
+#include "context.hpp"
 #include "eventqueue.hpp"
 #include "globalscripts.hpp"
 #include "localscripts.hpp"
@@ -28,6 +34,7 @@ namespace MWLua
     {
     public:
         LuaManager(const VFS::Manager* vfs, const std::string& libsDir);
+        ~LuaManager();
 
         // Called by engine.cpp when the environment is fully initialized.
         void init();
@@ -84,8 +91,10 @@ namespace MWLua
             std::string mCallerTraceback;
         };
 
+        // Can be called from any Lua state. Actions of the local script shards are applied after the actions of the main
+        // state, in the order of the shards.
         void addAction(std::function<void()> action, std::string_view name = "");
-        void addAction(std::unique_ptr<Action>&& action) { mActionQueue.push_back(std::move(action)); }
+        void addAction(std::unique_ptr<Action>&& action) { getActionQueue().push_back(std::move(action)); }
         void addTeleportPlayerAction(std::unique_ptr<Action>&& action) { mTeleportPlayerAction = std::move(action); }
 
         // Saving
@@ -102,6 +111,8 @@ namespace MWLua
 
         void handleConsoleCommand(const std::string& consoleMode, const std::string& command, const MWWorld::Ptr& selectedPtr) override;
 
+        void reportStats(unsigned int frameNumber, osg::Stats& stats) const override;
+
         // Used to call Lua callbacks from C++
         void queueCallback(LuaUtil::Callback callback, sol::object arg)
         {
@@ -122,8 +133,81 @@ namespace MWLua
         bool isProcessingInputEvents() const { return mProcessingInputEvents; }
 
     private:
+        // Additional Lua state for the local scripts of a part of the objects (see `[Lua] lua local script shards`).
+        // Local scripts of different shards run in parallel and can interact only through events.
+        struct Shard
+        {
+            Shard(const VFS::Manager* vfs, const LuaUtil::ScriptsConfiguration* conf);
+
+            LuaUtil::LuaState mLua;
+            LuaUtil::L10nManager mL10n;
+            // Read only copy of LuaManager::mGlobalStorage, updated by GlobalStorageListener.
+            LuaUtil::LuaStorage mGlobalStorage{mLua.sol()};
+            // Sent by the scripts of the shard. Moved to the receivers in the beginning of the next update.
+            GlobalEventQueue mGlobalEvents;
+            LocalEventQueue mLocalEvents;
+            std::vector<std::unique_ptr<Action>> mActionQueue;
+            sol::table mNearbyPackage;
+            sol::table mSettingsPackage;
+            sol::table mStoragePackage;
+        };
+
+        struct LocalEngineEvent
+        {
+            ObjectId mDest;
+            LocalScripts::EngineEvent mEvent;
+        };
+
+        // Work of one frame for the local scripts of one Lua state. Index 0 is the main state.
+        struct ShardFrame
+        {
+            std::vector<LocalScripts*> mActiveScripts;
+            std::vector<std::pair<LocalScripts*, LocalEvent>> mEvents;
+            std::vector<std::pair<LocalScripts*, LocalScripts::EngineEvent>> mEngineEvents;
+            std::vector<LocalScripts*> mUpdateOrder;
+            std::size_t mNumDeferredUpdates = 0;
+        };
+
+        class GlobalStorageListener final : public LuaUtil::LuaStorage::Listener
+        {
+        public:
+            explicit GlobalStorageListener(const std::vector<std::unique_ptr<Shard>>& shards) : mShards(shards) {}
+            void valueChanged(std::string_view section, std::string_view key, const sol::object& value) const override;
+            void sectionReplaced(std::string_view section, const sol::optional<sol::table>& values) const override;
+
+        private:
+            const std::vector<std::unique_ptr<Shard>>& mShards;
+        };
+
         void initConfiguration();
+        void initShard(Shard& shard, Context context, const std::vector<std::string>& preferredLocales);
         LocalScripts* createLocalScripts(const MWWorld::Ptr& ptr, ESM::LuaScriptCfg::Flags);
+        std::size_t selectShard(const MWWorld::Ptr& ptr, ESM::LuaScriptCfg::Flags flag) const;
+        LuaUtil::LuaState& getShardLua(std::size_t shard) { return shard == 0 ? mLua : mShards[shard - 1]->mLua; }
+
+        std::vector<std::unique_ptr<Action>>& getActionQueue();
+
+        // Moves local events and engine events to the frames of the shards of their receivers.
+        void distributeLocalEvents(LocalEventQueue&& events, std::size_t sourceShard);
+        void distributeLocalEngineEvents();
+
+        // Runs timers, event handlers (unless already run by `update`), engine handlers and `onUpdate` of the local
+        // scripts of every shard.
+        // The main state is processed by the calling thread, the other shards by their own threads.
+        void updateShards();
+        void updateShard(std::size_t shard);
+        // @param generation The value of mShardGeneration when the thread was started, so that the work of an update
+        // that begins before the thread gets to wait isn't missed.
+        void runShardThread(std::size_t shard, unsigned int generation);
+
+        void processLocalTimers(ShardFrame& frame);
+        void receiveLocalEvents(ShardFrame& frame);
+
+        // Calls `onUpdate` of the active local scripts. If `[Lua] frame budget` is exceeded, the remaining scripts are
+        // updated in the next frames.
+        void updateLocalScripts(ShardFrame& frame, float frameDuration);
+
+        LuaUtil::LuaState::ScriptStats getTotalStats() const;
 
         bool mInitialized = false;
         bool mGlobalScriptsStarted = false;
@@ -145,6 +229,24 @@ namespace MWLua
 
         GlobalScripts mGlobalScripts{&mLua};
         std::set<LocalScripts*> mActiveLocalScripts;
+        LuaUtil::LuaState::ScriptStats mFrameStats;
+
+        std::vector<std::unique_ptr<Shard>> mShards;
+        std::vector<ShardFrame> mShardFrames;
+        GlobalStorageListener mGlobalStorageListener{mShards};
+        float mFrameDuration = 0;
+        std::chrono::steady_clock::time_point mUpdateStart;
+
+        // Threads of the shards, except the main one
+        std::vector<std::thread> mShardThreads;
+        std::mutex mShardMutex;
+        std::condition_variable mShardsHaveWork;
+        std::condition_variable mShardsDone;
+        unsigned int mShardGeneration = 0;
+        std::size_t mBusyShards = 0;
+        bool mStopShards = false;
+        // The shard processed by the current thread, nullptr for the main state
+        static thread_local Shard* sCurrentShard;
         WorldView mWorldView;
 
         bool mPlayerChanged = false;
@@ -171,11 +273,6 @@ namespace MWLua
         };
         std::vector<CallbackWithData> mQueuedCallbacks;
 
-        struct LocalEngineEvent
-        {
-            ObjectId mDest;
-            LocalScripts::EngineEvent mEvent;
-        };
         std::vector<LocalEngineEvent> mLocalEngineEvents;
 
         // Queued actions that should be done in main thread. Processed by applyQueuedChanges().
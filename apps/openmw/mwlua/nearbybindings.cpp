@@ -1,5 +1,7 @@
 #include "luabindings.hpp"
 
+#include <mutex>
+
 #include <components/lua/luastate.hpp>
 
 #include "../mwbase/environment.hpp"
@@ -73,6 +75,9 @@ namespace MWLua
                 radius = options->get<sol::optional<float>>("radius").value_or(0);
             }
             const MWPhysics::RayCastingInterface* rayCasting = MWBase::Environment::get().getWorld()->getRayCasting();
+            // Local scripts can run in several threads (see `[Lua] lua local script shards`)
+            static std::mutex mutex;
+            std::lock_guard<std::mutex> lock(mutex);
             if (radius <= 0)
                 return rayCasting->castRay(from, to, ignore, std::vector<MWWorld::Ptr>(), collisionType);
             else
@@ -55,6 +55,7 @@ namespace MWLua
 
     void ObjectRegistry::update()
     {
+        std::lock_guard<std::mutex> lock(mMutex);
         if (mChanged)
         {
             mUpdateCounter++;
@@ -64,6 +65,7 @@ namespace MWLua
 
     void ObjectRegistry::clear()
     {
+        std::lock_guard<std::mutex> lock(mMutex);
         mObjectMapping.clear();
         mChanged = false;
         mUpdateCounter = 0;
@@ -73,6 +75,7 @@ namespace MWLua
     MWWorld::Ptr ObjectRegistry::getPtr(ObjectId id, bool local)
     {
         MWWorld::Ptr ptr;
+        std::lock_guard<std::mutex> lock(mMutex);
         auto it = mObjectMapping.find(id);
         if (it != mObjectMapping.end())
             ptr = it->second;
@@ -90,6 +93,8 @@ namespace MWLua
 
     ObjectId ObjectRegistry::registerPtr(const MWWorld::Ptr& ptr)
     {
+        // Also protects the RefNum of the object, which is assigned here if the object doesn't have one yet
+        std::lock_guard<std::mutex> lock(mMutex);
         ObjectId id = ptr.getCellRef().getOrAssignRefNum(mLastAssignedId);
         mChanged = true;
         mObjectMapping[id] = ptr;
@@ -99,6 +104,7 @@ namespace MWLua
     ObjectId ObjectRegistry::deregisterPtr(const MWWorld::Ptr& ptr)
     {
         ObjectId id = getId(ptr);
+        std::lock_guard<std::mutex> lock(mMutex);
         mChanged = true;
         mObjectMapping.erase(id);
         return id;
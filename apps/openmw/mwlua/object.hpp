@@ -3,6 +3,7 @@
 
 #include <typeindex>
 #include <map>
+#include <mutex>
 
 #include <sol/sol.hpp>
 
@@ -21,6 +22,7 @@ namespace MWLua
     bool isMarker(const MWWorld::Ptr& ptr);
 
     // Holds a mapping ObjectId -> MWWord::Ptr.
+    // Objects can be registered and looked up concurrently by the local scripts of different Lua states.
     class ObjectRegistry
     {
     public:
@@ -45,8 +47,9 @@ namespace MWLua
         friend class Object;
         friend class LuaManager;
 
+        std::mutex mMutex;
         bool mChanged = false;
-        int64_t mUpdateCounter = 0;
+        int64_t mUpdateCounter = 0;  // Changed only by `update`, which isn't called while scripts are running.
         std::map<ObjectId, MWWorld::Ptr> mObjectMapping;
         ObjectId mLastAssignedId;
     };
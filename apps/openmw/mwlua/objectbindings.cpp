@@ -173,7 +173,8 @@ namespace MWLua
             objectT[sol::meta_function::to_string] = &ObjectT::toString;
             objectT["sendEvent"] = [context](const ObjectT& dest, std::string eventName, const sol::object& eventData)
             {
-                context.mLocalEventQueue->push_back({dest.id(), std::move(eventName), LuaUtil::serialize(eventData, context.mSerializer)});
+                context.mLocalEventQueue->push_back({dest.id(), std::move(eventName),
+                    LuaUtil::copy(context.mLua->sol(), eventData, context.mSerializer, context.mLocalSerializer)});
             };
 
             objectT["activateBy"] = [context](const ObjectT& o, const ObjectT& actor)
@@ -285,6 +286,7 @@ namespace MWLua
                     throw std::runtime_error(std::string("Incorrect type argument in inventory:getAll: " + LuaUtil::toString(*type)));
 
                 const MWWorld::Ptr& ptr = inventory.mObj.ptr();
+                auto lock = worldView->lockObjectData();
                 MWWorld::ContainerStore& store = ptr.getClass().getContainerStore(ptr);
                 ObjectIdList list = std::make_shared<std::vector<ObjectId>>();
                 auto it = store.begin(mask);
@@ -297,9 +299,10 @@ namespace MWLua
                 return ObjectList<ObjectT>{list};
             };
 
-            inventoryT["countOf"] = [](const InventoryT& inventory, const std::string& recordId)
+            inventoryT["countOf"] = [worldView=context.mWorldView](const InventoryT& inventory, const std::string& recordId)
             {
                 const MWWorld::Ptr& ptr = inventory.mObj.ptr();
+                auto lock = worldView->lockObjectData();
                 MWWorld::ContainerStore& store = ptr.getClass().getContainerStore(ptr);
                 return store.count(recordId);
             };
@@ -59,6 +59,7 @@ namespace
     template<class G>
     sol::object getValue(const MWLua::Context& context, const StatObject& obj, SelfObject::CachedStat::Setter setter, int index, std::string_view prop, G getter)
     {
+        auto lock = context.mWorldView->lockObjectData();
         return std::visit([&] (auto&& variant)
         {
             using T = std::decay_t<decltype(variant)>;
@@ -127,6 +128,7 @@ namespace MWLua
             const auto& ptr = getObject(mObject)->ptr();
             if(!ptr.getClass().isNpc())
                 return sol::nil;
+            auto lock = context.mWorldView->lockObjectData();
             return sol::make_object(context.mLua->sol(), ptr.getClass().getNpcStats(ptr).getLevelProgress());
         }
 
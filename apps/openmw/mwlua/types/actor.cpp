@@ -140,9 +140,10 @@ namespace MWLua
             {"Ammunition", MWWorld::InventoryStore::Slot_Ammunition}
         }));
 
-        actor["stance"] = [](const Object& o)
+        actor["stance"] = [context](const Object& o)
         {
             const MWWorld::Class& cls = o.ptr().getClass();
+            auto lock = context.mWorldView->lockObjectData();
             if (cls.isActor())
                 return cls.getCreatureStats(o.ptr()).getDrawState();
             else
@@ -190,6 +191,7 @@ namespace MWLua
             if (!ptr.getClass().hasInventoryStore(ptr))
                 return equipment;
 
+            auto lock = context.mWorldView->lockObjectData();
             MWWorld::InventoryStore& store = ptr.getClass().getInventoryStore(ptr);
             for (int slot = 0; slot < MWWorld::InventoryStore::Slots; ++slot)
             {
@@ -207,6 +209,7 @@ namespace MWLua
             sol::table equipment(context.mLua->sol(), sol::create);
             if (!ptr.getClass().hasInventoryStore(ptr))
                 return sol::nil;
+            auto lock = context.mWorldView->lockObjectData();
             MWWorld::InventoryStore& store = ptr.getClass().getInventoryStore(ptr);
             auto it = store.getSlot(slot);
             if (it == store.end())
@@ -215,11 +218,12 @@ namespace MWLua
             return o.getObject(context.mLua->sol(), getId(*it));
         };
         actor["equipment"] = sol::overload(getAllEquipment, getEquipmentFromSlot);
-        actor["hasEquipped"] = [](const Object& o, const Object& item)
+        actor["hasEquipped"] = [context](const Object& o, const Object& item)
         {
             const MWWorld::Ptr& ptr = o.ptr();
             if (!ptr.getClass().hasInventoryStore(ptr))
                 return false;
+            auto lock = context.mWorldView->lockObjectData();
             MWWorld::InventoryStore& store = ptr.getClass().getInventoryStore(ptr);
             return store.isEquipped(item.ptr());
         };
@@ -6,6 +6,7 @@
 #include "../mwbase/environment.hpp"
 #include "../mwbase/world.hpp"
 
+#include <mutex>
 #include <set>
 
 namespace ESM
@@ -46,6 +47,10 @@ namespace MWLua
 
         ObjectRegistry* getObjectRegistry() { return &mObjectRegistry; }
 
+        // Local scripts can run in several threads (see `[Lua] lua local script shards`). Stats, inventories and
+        // AI of the objects are created on first access, so the bindings must hold this lock while using them.
+        std::unique_lock<std::mutex> lockObjectData() { return std::unique_lock<std::mutex>(mObjectDataMutex); }
+
         void objectUnloaded(const MWWorld::Ptr& ptr) { mObjectRegistry.deregisterPtr(ptr); }
 
         void objectAddedToScene(const MWWorld::Ptr& ptr);
@@ -78,6 +83,7 @@ namespace MWLua
         void removeFromGroup(ObjectGroup& group, const MWWorld::Ptr& ptr);
 
         ObjectRegistry mObjectRegistry;
+        std::mutex mObjectDataMutex;
         ObjectGroup mActivatorsInScene;
         ObjectGroup mActorsInScene;
         ObjectGroup mContainersInScene;
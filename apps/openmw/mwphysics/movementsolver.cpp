@@ -80,6 +80,22 @@ namespace MWPhysics
         const btCollisionObject * mMe;
     };
 
+    // Bounds of all the sweeps the movement solver may do for an actor moving by distance. Larger movements, e.g. stepping
+    // up several times in a single frame, are still handled correctly but don't benefit from the gathered candidates.
+    static SweepCandidates gatherSweepCandidates(const ActorFrameData& actor, float distance, const btCollisionWorld* collisionWorld)
+    {
+        btTransform transform = actor.mCollisionObject->getWorldTransform();
+        transform.setOrigin(Misc::Convert::toBullet(actor.mPosition));
+        btVector3 aabbMin, aabbMax;
+        actor.mCollisionObject->getCollisionShape()->getAabb(transform, aabbMin, aabbMax);
+
+        const float margin = 4 * sCollisionMargin + 2 * sGroundOffset;
+        const float horizontal = distance + sMinStep2 + margin;
+        const float vertical = distance + Constants::sStepSizeUp + sStepSizeDown + margin;
+        const btVector3 extent(horizontal, horizontal, vertical);
+        return SweepCandidates(actor.mCollisionObject, aabbMin - extent, aabbMax + extent, collisionWorld);
+    }
+
     osg::Vec3f MovementSolver::traceDown(const MWWorld::Ptr &ptr, const osg::Vec3f& position, Actor* actor, btCollisionWorld* collisionWorld, float maxHeight)
     {
         osg::Vec3f offset = actor->getCollisionObjectPosition() - ptr.getRefData().getPosition().asVec3();
@@ -174,7 +190,10 @@ namespace MWPhysics
             velocity *= 1.f-(fStromWalkMult * (angleDegrees/180.f));
         }
 
-        Stepper stepper(collisionWorld, actor.mCollisionObject);
+        // The sweeps below stay close to the starting position, query the broadphase once for all of them
+        const SweepCandidates candidates = gatherSweepCandidates(actor, velocity.length() * time, collisionWorld);
+
+        Stepper stepper(candidates, actor.mCollisionObject);
         osg::Vec3f origVelocity = velocity;
         osg::Vec3f newPosition = actor.mPosition;
         /*
@@ -206,7 +225,7 @@ namespace MWPhysics
             if((newPosition - nextpos).length2() > 0.0001)
             {
                 // trace to where character would go if there were no obstructions
-                tracer.doTrace(actor.mCollisionObject, newPosition, nextpos, collisionWorld, actor.mIsOnGround);
+                tracer.doTrace(actor.mCollisionObject, newPosition, nextpos, candidates, actor.mIsOnGround);
 
                 // check for obstructions
                 if(tracer.mFraction >= 1.0f)
@@ -303,7 +322,7 @@ namespace MWPhysics
                             // version of surface rejection for acute crevices/seams
                             auto averageNormal = bestNormal + origPlaneNormal;
                             averageNormal.normalize();
-                            tracer.doTrace(actor.mCollisionObject, newPosition, newPosition + averageNormal*(sCollisionMargin*2.0), collisionWorld);
+                            tracer.doTrace(actor.mCollisionObject, newPosition, newPosition + averageNormal*(sCollisionMargin*2.0), candidates);
                             newPosition = (newPosition + tracer.mEndPos)/2.0;
 
                             usedSeamLogic = true;
@@ -318,7 +337,7 @@ namespace MWPhysics
                 // but this is along the collision normal
                 if(!usedSeamLogic)
                 {
-                    tracer.doTrace(actor.mCollisionObject, newPosition, newPosition + planeNormal*(sCollisionMargin*2.0), collisionWorld);
+                    tracer.doTrace(actor.mCollisionObject, newPosition, newPosition + planeNormal*(sCollisionMargin*2.0), candidates);
                     newPosition = (newPosition + tracer.mEndPos)/2.0;
                 }
 
@@ -357,7 +376,7 @@ namespace MWPhysics
             osg::Vec3f from = newPosition;
             auto dropDistance = 2*sGroundOffset + (actor.mIsOnGround ? sStepSizeDown : 0);
             osg::Vec3f to = newPosition - osg::Vec3f(0,0,dropDistance);
-            tracer.doTrace(actor.mCollisionObject, from, to, collisionWorld, actor.mIsOnGround);
+            tracer.doTrace(actor.mCollisionObject, from, to, candidates, actor.mIsOnGround);
             if(tracer.mFraction < 1.0f)
             {
                 if (!isActor(tracer.mHitObject))
@@ -375,7 +394,7 @@ namespace MWPhysics
                         else
                         {
                             newPosition.z() = tracer.mEndPos.z();
-                            tracer.doTrace(actor.mCollisionObject, newPosition, newPosition + osg::Vec3f(0, 0, 2*sGroundOffset), collisionWorld);
+                            tracer.doTrace(actor.mCollisionObject, newPosition, newPosition + osg::Vec3f(0, 0, 2*sGroundOffset), candidates);
                             newPosition = (newPosition+tracer.mEndPos)/2.0;
                         }
                     }
@@ -2,12 +2,14 @@
 
 #include <BulletCollision/BroadphaseCollision/btDbvtBroadphase.h>
 #include <BulletCollision/CollisionShapes/btCollisionShape.h>
+#include <LinearMath/btAabbUtil2.h>
 
 #include <osg/Stats>
 
 #include "components/debug/debuglog.hpp"
-#include <components/misc/barrier.hpp>
+#include "components/debug/trace.hpp"
 #include "components/misc/convert.hpp"
+#include <components/misc/hash.hpp>
 #include "components/settings/settings.hpp"
 #include "../mwmechanics/actorutil.hpp"
 #include "../mwmechanics/movement.hpp"
@@ -24,6 +26,17 @@
 
 namespace
 {
+    /// Collision types that block line of sight between actors
+    constexpr int sLOSCollisionMask = MWPhysics::CollisionType_World | MWPhysics::CollisionType_HeightMap | MWPhysics::CollisionType_Door;
+
+    /// Cached line of sight is kept while both actors move less than this distance
+    constexpr float sLOSPositionTolerance = 4.f;
+
+    osg::Vec3f getEyePosition(const MWPhysics::Actor* actor)
+    {
+        return actor->getCollisionObjectPosition() + osg::Vec3f(0, 0, actor->getHalfExtents().z() * 0.9);
+    }
+
     /// @brief A scoped lock that is either exclusive or inexistent depending on configuration
     template<class Mutex>
     class MaybeExclusiveLock
@@ -311,14 +324,12 @@ namespace MWPhysics
           , mCollisionWorld(collisionWorld)
           , mDebugDrawer(debugDrawer)
           , mNumThreads(Config::computeNumThreads())
-          , mNumJobs(0)
           , mRemainingSteps(0)
           , mLOSCacheExpiry(Settings::Manager::getInt("lineofsight keep inactive cache", "Physics"))
-          , mFrameCounter(0)
           , mAdvanceSimulation(false)
-          , mQuit(false)
-          , mNextJob(0)
-          , mNextLOS(0)
+          , mSimulationStage(SimulationStage::Done)
+          , mNumLOSQueries(0)
+          , mNumLOSRaycasts(0)
           , mFrameNumber(0)
           , mTimer(osg::Timer::instance())
           , mPrevStepCount(1)
@@ -330,35 +341,16 @@ namespace MWPhysics
           , mTimeEnd(0)
           , mFrameStart(0)
     {
-        if (mNumThreads >= 1)
-        {
-            for (int i = 0; i < mNumThreads; ++i)
-                mThreads.emplace_back([&] { worker(); } );
-        }
-        else
-        {
+        if (mNumThreads == 0)
             mLOSCacheExpiry = 0;
-        }
-
-        mPreStepBarrier = std::make_unique<Misc::Barrier>(mNumThreads);
 
-        mPostStepBarrier = std::make_unique<Misc::Barrier>(mNumThreads);
-
-        mPostSimBarrier = std::make_unique<Misc::Barrier>(mNumThreads);
+        mPool = std::make_unique<Misc::StagedTaskPool>(mNumThreads, "Physics");
     }
 
     PhysicsTaskScheduler::~PhysicsTaskScheduler()
     {
         waitForWorkers();
-        {
-            MaybeExclusiveLock lock(mSimulationMutex, mNumThreads);
-            mQuit = true;
-            mNumJobs = 0;
-            mRemainingSteps = 0;
-            mHasJob.notify_all();
-        }
-        for (auto& thread : mThreads)
-            thread.join();
+        mPool.reset();
     }
 
     std::tuple<int, float> PhysicsTaskScheduler::calculateStepConfig(float timeAccum) const
@@ -409,12 +401,9 @@ namespace MWPhysics
 
     void PhysicsTaskScheduler::applyQueuedMovements(float & timeAccum, std::vector<Simulation>&& simulations, osg::Timer_t frameStart, unsigned int frameNumber, osg::Stats& stats)
     {
-        waitForWorkers();
-
         // This function run in the main thread.
-        // While the mSimulationMutex is held, background physics threads can't run.
-
-        MaybeExclusiveLock lock(mSimulationMutex, mNumThreads);
+        // Background physics threads don't run until the simulation is started again.
+        waitForWorkers();
 
         double timeStart = mTimer->tick();
 
@@ -443,10 +432,13 @@ namespace MWPhysics
         mPhysicsDt = newDelta;
         mSimulations = std::move(simulations);
         mAdvanceSimulation = (mRemainingSteps != 0);
-        ++mFrameCounter;
-        mNumJobs = mSimulations.size();
-        mNextLOS.store(0, std::memory_order_relaxed);
-        mNextJob.store(0, std::memory_order_release);
+        mSimulationStage = SimulationStage::PreStep;
+        {
+            // Changes done later, including the ones in afterPreStep, are taken into account in the next frame
+            MaybeExclusiveLock lock(mLOSChangesMutex, mNumThreads);
+            mFrameLOSChanges.clear();
+            std::swap(mFrameLOSChanges, mLOSChanges);
+        }
 
         if (mAdvanceSimulation)
             mWorldFrameData = std::make_unique<WorldFrameData>();
@@ -456,15 +448,16 @@ namespace MWPhysics
 
         if (mNumThreads == 0)
         {
-            doSimulation();
+            mPool->start([this] { return nextSimulationStage(); });
             syncWithMainThread();
+            reportLOSStats(frameNumber, stats);
             if(mAdvanceSimulation)
                 mBudget.update(mTimer->delta_s(timeStart, mTimer->tick()), numSteps, mBudgetCursor);
             return;
         }
 
         mAsyncStartTime = mTimer->tick();
-        mHasJob.notify_all();
+        mPool->start([this] { return nextSimulationStage(); });
         if (mAdvanceSimulation)
             mBudget.update(mTimer->delta_s(timeStart, mTimer->tick()), 1, mBudgetCursor);
     }
@@ -472,7 +465,6 @@ namespace MWPhysics
     void PhysicsTaskScheduler::resetSimulation(const ActorMap& actors)
     {
         waitForWorkers();
-        MaybeExclusiveLock lock(mSimulationMutex, mNumThreads);
         mBudget.reset(mDefaultPhysicsDt);
         mAsyncBudget.reset(0.0f);
         mSimulations.clear();
@@ -534,6 +526,7 @@ namespace MWPhysics
     {
         MaybeExclusiveLock lock(mCollisionWorldMutex, mNumThreads);
         collisionObject->getBroadphaseHandle()->m_collisionFilterMask = collisionFilterMask;
+        addLOSChange(collisionObject);
     }
 
     void PhysicsTaskScheduler::addCollisionObject(btCollisionObject* collisionObject, int collisionFilterGroup, int collisionFilterMask)
@@ -541,12 +534,14 @@ namespace MWPhysics
         mCollisionObjects.insert(collisionObject);
         MaybeExclusiveLock lock(mCollisionWorldMutex, mNumThreads);
         mCollisionWorld->addCollisionObject(collisionObject, collisionFilterGroup, collisionFilterMask);
+        addLOSChange(collisionObject);
     }
 
     void PhysicsTaskScheduler::removeCollisionObject(btCollisionObject* collisionObject)
     {
         mCollisionObjects.erase(collisionObject);
         MaybeExclusiveLock lock(mCollisionWorldMutex, mNumThreads);
+        addLOSChange(collisionObject);
         mCollisionWorld->removeCollisionObject(collisionObject);
     }
 
@@ -563,41 +558,87 @@ namespace MWPhysics
         }
     }
 
+    std::size_t PhysicsTaskScheduler::LOSKeyHash::operator()(const std::array<const Actor*, 2>& actors) const
+    {
+        std::size_t seed = 0;
+        Misc::hashCombine(seed, actors[0]);
+        Misc::hashCombine(seed, actors[1]);
+        return seed;
+    }
+
     bool PhysicsTaskScheduler::getLineOfSight(const std::shared_ptr<Actor>& actor1, const std::shared_ptr<Actor>& actor2)
     {
         MaybeExclusiveLock lock(mLOSCacheMutex, mNumThreads);
+        mNumLOSQueries.fetch_add(1, std::memory_order_relaxed);
 
         auto req = LOSRequest(actor1, actor2);
-        auto result = std::find(mLOSCache.begin(), mLOSCache.end(), req);
-        if (result == mLOSCache.end())
+        auto it = mLOSCacheIndex.find(req.mRawActors);
+        // The positions are stored in the order of the sorted actors, to compare them with the actors of the cache
+        if (it == mLOSCacheIndex.end())
         {
-            req.mResult = hasLineOfSight(actor1.get(), actor2.get());
+            updateLineOfSight(req, req.mRawActors[0], req.mRawActors[1]);
+            mLOSCacheIndex.emplace(req.mRawActors, mLOSCache.size());
             mLOSCache.push_back(req);
             return req.mResult;
         }
-        result->mAge = 0;
-        return result->mResult;
+        LOSRequest& cached = mLOSCache[it->second];
+        // If an actor was destroyed, another one can have the same address
+        if (cached.mActors[0].expired() || cached.mActors[1].expired())
+        {
+            cached = req;
+            updateLineOfSight(cached, cached.mRawActors[0], cached.mRawActors[1]);
+            return cached.mResult;
+        }
+        cached.mAge = 0;
+        cached.mStale = false;
+        return cached.mResult;
     }
 
-    void PhysicsTaskScheduler::refreshLOSCache()
+    void PhysicsTaskScheduler::refreshLOSCache(std::size_t begin, std::size_t end)
     {
         MaybeSharedLock lock(mLOSCacheMutex, mNumThreads);
-        int job = 0;
-        int numLOS = mLOSCache.size();
-        while ((job = mNextLOS.fetch_add(1, std::memory_order_relaxed)) < numLOS)
+        for (std::size_t i = begin; i < end; ++i)
         {
-            auto& req = mLOSCache[job];
+            auto& req = mLOSCache[i];
             auto actorPtr1 = req.mActors[0].lock();
             auto actorPtr2 = req.mActors[1].lock();
 
             if (req.mAge++ > mLOSCacheExpiry || !actorPtr1 || !actorPtr2)
                 req.mStale = true;
-            else
-                req.mResult = hasLineOfSight(actorPtr1.get(), actorPtr2.get());
+            else if (needsLineOfSightUpdate(req, actorPtr1.get(), actorPtr2.get()))
+                updateLineOfSight(req, actorPtr1.get(), actorPtr2.get());
         }
 
     }
 
+    void PhysicsTaskScheduler::rebuildLOSCacheIndex()
+    {
+        mLOSCacheIndex.clear();
+        for (std::size_t i = 0; i < mLOSCache.size(); ++i)
+            mLOSCacheIndex.emplace(mLOSCache[i].mRawActors, i);
+    }
+
+    void PhysicsTaskScheduler::addLOSChange(const btCollisionObject* collisionObject)
+    {
+        const btBroadphaseProxy* proxy = collisionObject->getBroadphaseHandle();
+        if (proxy == nullptr || (proxy->m_collisionFilterGroup & sLOSCollisionMask) == 0)
+            return;
+        MaybeExclusiveLock lock(mLOSChangesMutex, mNumThreads);
+        mLOSChanges.emplace_back(proxy->m_aabbMin, proxy->m_aabbMax);
+    }
+
+    void PhysicsTaskScheduler::reportLOSStats(unsigned int frameNumber, osg::Stats& stats)
+    {
+        const unsigned int numQueries = mNumLOSQueries.exchange(0, std::memory_order_relaxed);
+        const unsigned int numRaycasts = mNumLOSRaycasts.exchange(0, std::memory_order_relaxed);
+        if (!stats.collectStats("resource"))
+            return;
+        stats.setAttribute(frameNumber, "Physics LOS Queries", numQueries);
+        stats.setAttribute(frameNumber, "Physics LOS Raycasts", numRaycasts);
+        MaybeSharedLock lock(mLOSCacheMutex, mNumThreads);
+        stats.setAttribute(frameNumber, "Physics LOS Cache", mLOSCache.size());
+    }
+
     void PhysicsTaskScheduler::updateAabbs()
     {
         MaybeExclusiveLock lock(mUpdateAabbMutex, mNumThreads);
@@ -621,8 +662,11 @@ namespace MWPhysics
         }
         else if (const auto object = std::dynamic_pointer_cast<Object>(ptr))
         {
+            // Both the old and the new bounds can change line of sight
+            addLOSChange(object->getCollisionObject());
             object->commitPositionChange();
             mCollisionWorld->updateSingleAabb(object->getCollisionObject());
+            addLOSChange(object->getCollisionObject());
         }
         else if (const auto projectile = std::dynamic_pointer_cast<Projectile>(ptr))
         {
@@ -631,22 +675,6 @@ namespace MWPhysics
         }
     }
 
-    void PhysicsTaskScheduler::worker()
-    {
-        std::size_t lastFrame = 0;
-        std::shared_lock lock(mSimulationMutex);
-        while (!mQuit)
-        {
-            if (lastFrame == mFrameCounter)
-            {
-                mHasJob.wait(lock, [&] { return mQuit || lastFrame != mFrameCounter; });
-                lastFrame = mFrameCounter;
-            }
-
-            doSimulation();
-        }
-    }
-
     void PhysicsTaskScheduler::updateActorsPositions()
     {
         const Visitors::UpdatePosition impl{mCollisionWorld};
@@ -655,41 +683,107 @@ namespace MWPhysics
             std::visit(vis, sim);
     }
 
-    bool PhysicsTaskScheduler::hasLineOfSight(const Actor* actor1, const Actor* actor2)
+    void PhysicsTaskScheduler::updateLineOfSight(LOSRequest& req, const Actor* actor1, const Actor* actor2)
     {
-        btVector3 pos1  = Misc::Convert::toBullet(actor1->getCollisionObjectPosition() + osg::Vec3f(0,0,actor1->getHalfExtents().z() * 0.9)); // eye level
-        btVector3 pos2  = Misc::Convert::toBullet(actor2->getCollisionObjectPosition() + osg::Vec3f(0,0,actor2->getHalfExtents().z() * 0.9));
+        req.mPositions = {getEyePosition(actor1), getEyePosition(actor2)};
+        const btVector3 pos1 = Misc::Convert::toBullet(req.mPositions[0]);
+        const btVector3 pos2 = Misc::Convert::toBullet(req.mPositions[1]);
 
         btCollisionWorld::ClosestRayResultCallback resultCallback(pos1, pos2);
         resultCallback.m_collisionFilterGroup = CollisionType_AnyPhysical;
-        resultCallback.m_collisionFilterMask = CollisionType_World|CollisionType_HeightMap|CollisionType_Door;
+        resultCallback.m_collisionFilterMask = sLOSCollisionMask;
 
+        mNumLOSRaycasts.fetch_add(1, std::memory_order_relaxed);
         MaybeLock lockColWorld(mCollisionWorldMutex, mNumThreads);
         mCollisionWorld->rayTest(pos1, pos2, resultCallback);
 
-        return !resultCallback.hasHit();
+        req.mResult = !resultCallback.hasHit();
     }
 
-    void PhysicsTaskScheduler::doSimulation()
+    bool PhysicsTaskScheduler::needsLineOfSightUpdate(const LOSRequest& req, const Actor* actor1, const Actor* actor2) const
     {
-        while (mRemainingSteps)
+        constexpr float maxDistance2 = sLOSPositionTolerance * sLOSPositionTolerance;
+        if ((getEyePosition(actor1) - req.mPositions[0]).length2() > maxDistance2
+            || (getEyePosition(actor2) - req.mPositions[1]).length2() > maxDistance2)
+            return true;
+
+        if (mFrameLOSChanges.empty())
+            return false;
+        const btVector3 pos1 = Misc::Convert::toBullet(req.mPositions[0]);
+        const btVector3 pos2 = Misc::Convert::toBullet(req.mPositions[1]);
+        btVector3 min = pos1;
+        min.setMin(pos2);
+        btVector3 max = pos1;
+        max.setMax(pos2);
+        return std::any_of(mFrameLOSChanges.begin(), mFrameLOSChanges.end(),
+            [&] (const std::pair<btVector3, btVector3>& bounds)
+            {
+                return TestAabbAgainstAabb2(min, max, bounds.first, bounds.second);
+            });
+    }
+
+    std::optional<Misc::StagedTaskPool::Stage> PhysicsTaskScheduler::nextSimulationStage()
+    {
+        // Movement solves and line of sight refreshes are split between the threads, the rest is serial.
+        // Stages with few items are processed by a single thread without waking the others.
+        switch (mSimulationStage)
         {
-            mPreStepBarrier->wait([this] { afterPreStep(); });
-            int job = 0;
-            const Visitors::Move impl{mPhysicsDt, mCollisionWorld, *mWorldFrameData};
-            const Visitors::WithLockedPtr<Visitors::Move, MaybeLock> vis{impl, mCollisionWorldMutex, mNumThreads};
-            while ((job = mNextJob.fetch_add(1, std::memory_order_relaxed)) < mNumJobs)
-                std::visit(vis, mSimulations[job]);
-
-            mPostStepBarrier->wait([this] { afterPostStep(); });
+            case SimulationStage::PreStep:
+                if (mRemainingSteps == 0)
+                {
+                    mSimulationStage = SimulationStage::LineOfSight;
+                    return nextSimulationStage();
+                }
+                mSimulationStage = SimulationStage::Move;
+                return Misc::StagedTaskPool::Stage {1, 1, [this] (std::size_t, std::size_t)
+                {
+                    const Debug::TraceZone zone("physicsprestep");
+                    afterPreStep();
+                }};
+            case SimulationStage::Move:
+                mSimulationStage = SimulationStage::PostStep;
+                return Misc::StagedTaskPool::Stage {mSimulations.size(), 2, [this] (std::size_t begin, std::size_t end)
+                {
+                    const Debug::TraceZone zone("physicsmove");
+                    const Visitors::Move impl{mPhysicsDt, mCollisionWorld, *mWorldFrameData};
+                    const Visitors::WithLockedPtr<Visitors::Move, MaybeLock> vis{impl, mCollisionWorldMutex, mNumThreads};
+                    for (std::size_t i = begin; i < end; ++i)
+                        std::visit(vis, mSimulations[i]);
+                }};
+            case SimulationStage::PostStep:
+                mSimulationStage = SimulationStage::PreStep;
+                return Misc::StagedTaskPool::Stage {1, 1, [this] (std::size_t, std::size_t)
+                {
+                    const Debug::TraceZone zone("physicspoststep");
+                    afterPostStep();
+                }};
+            case SimulationStage::LineOfSight:
+            {
+                mSimulationStage = SimulationStage::PostSim;
+                // Requests added meanwhile are already up to date
+                MaybeSharedLock lock(mLOSCacheMutex, mNumThreads);
+                return Misc::StagedTaskPool::Stage {mLOSCache.size(), 8, [this] (std::size_t begin, std::size_t end)
+                {
+                    const Debug::TraceZone zone("physicslineofsight");
+                    refreshLOSCache(begin, end);
+                }};
+            }
+            case SimulationStage::PostSim:
+                mSimulationStage = SimulationStage::Done;
+                return Misc::StagedTaskPool::Stage {1, 1, [this] (std::size_t, std::size_t)
+                {
+                    const Debug::TraceZone zone("physicspostsim");
+                    afterPostSim();
+                }};
+            case SimulationStage::Done:
+                break;
         }
-
-        refreshLOSCache();
-        mPostSimBarrier->wait([this] { afterPostSim(); });
+        return std::nullopt;
     }
 
     void PhysicsTaskScheduler::updateStats(osg::Timer_t frameStart, unsigned int frameNumber, osg::Stats& stats)
     {
+        reportLOSStats(frameNumber, stats);
         if (!stats.collectStats("engine"))
             return;
         if (mFrameNumber == frameNumber - 1)
@@ -720,7 +814,7 @@ namespace MWPhysics
     void PhysicsTaskScheduler::releaseSharedStates()
     {
         waitForWorkers();
-        std::scoped_lock lock(mSimulationMutex, mUpdateAabbMutex);
+        std::scoped_lock lock(mUpdateAabbMutex);
         mSimulations.clear();
         mUpdateAabb.clear();
     }
@@ -743,23 +837,21 @@ namespace MWPhysics
             --mRemainingSteps;
             updateActorsPositions();
         }
-        mNextJob.store(0, std::memory_order_release);
     }
 
     void PhysicsTaskScheduler::afterPostSim()
     {
         {
             MaybeExclusiveLock lock(mLOSCacheMutex, mNumThreads);
+            const std::size_t size = mLOSCache.size();
             mLOSCache.erase(
                     std::remove_if(mLOSCache.begin(), mLOSCache.end(),
                         [](const LOSRequest& req) { return req.mStale; }),
                     mLOSCache.end());
+            if (mLOSCache.size() != size)
+                rebuildLOSCacheIndex();
         }
         mTimeEnd = mTimer->tick();
-
-        std::unique_lock lock(mWorkersDoneMutex);
-        ++mWorkersFrameCounter;
-        mWorkersDone.notify_all();
     }
 
     void PhysicsTaskScheduler::syncWithMainThread()
@@ -769,18 +861,12 @@ namespace MWPhysics
             std::visit(vis, sim);
     }
 
-    // Attempt to acquire unique lock on mSimulationMutex while not all worker
-    // threads are holding shared lock but will have to may lead to a deadlock because
-    // C++ standard does not guarantee priority for exclusive and shared locks
-    // for std::shared_mutex. For example microsoft STL implementation points out
-    // for the absence of such priority:
-    // https://docs.microsoft.com/en-us/windows/win32/sync/slim-reader-writer--srw--locks
+    // The simulation state is not locked while the simulation runs in the background,
+    // it has to be finished before the main thread can access it.
     void PhysicsTaskScheduler::waitForWorkers()
     {
         if (mNumThreads == 0)
             return;
-        std::unique_lock lock(mWorkersDoneMutex);
-        if (mFrameCounter != mWorkersFrameCounter)
-            mWorkersDone.wait(lock);
+        mPool->wait();
     }
 }
@@ -1,12 +1,14 @@
 #ifndef OPENMW_MWPHYSICS_MTPHYSICS_H
 #define OPENMW_MWPHYSICS_MTPHYSICS_H
 
+#include <array>
 #include <atomic>
-#include <condition_variable>
+#include <mutex>
 #include <optional>
 #include <shared_mutex>
-#include <thread>
+#include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <variant>
 
 #include <BulletCollision/CollisionDispatch/btCollisionWorld.h>
@@ -16,11 +18,7 @@
 #include "physicssystem.hpp"
 #include "ptrholder.hpp"
 #include "components/misc/budgetmeasurement.hpp"
-
-namespace Misc
-{
-    class Barrier;
-}
+#include "components/misc/stagedtaskpool.hpp"
 
 namespace MWRender
 {
@@ -61,11 +59,24 @@ namespace MWPhysics
             void releaseSharedStates(); // destroy all objects whose destructor can't be safely called from ~PhysicsTaskScheduler()
 
         private:
-            void doSimulation();
-            void worker();
+            enum class SimulationStage
+            {
+                PreStep,
+                Move,
+                PostStep,
+                LineOfSight,
+                PostSim,
+                Done,
+            };
+
+            std::optional<Misc::StagedTaskPool::Stage> nextSimulationStage();
             void updateActorsPositions();
-            bool hasLineOfSight(const Actor* actor1, const Actor* actor2);
-            void refreshLOSCache();
+            void updateLineOfSight(LOSRequest& req, const Actor* actor1, const Actor* actor2);
+            bool needsLineOfSightUpdate(const LOSRequest& req, const Actor* actor1, const Actor* actor2) const;
+            void refreshLOSCache(std::size_t begin, std::size_t end);
+            void rebuildLOSCacheIndex();
+            void addLOSChange(const btCollisionObject* collisionObject);
+            void reportLOSStats(unsigned int frameNumber, osg::Stats& stats);
             void updateAabbs();
             void updatePtrAabb(const std::shared_ptr<PtrHolder>& ptr);
             void updateStats(osg::Timer_t frameStart, unsigned int frameNumber, osg::Stats& stats);
@@ -84,34 +95,33 @@ namespace MWPhysics
             float mTimeAccum;
             btCollisionWorld* mCollisionWorld;
             MWRender::DebugDrawer* mDebugDrawer;
+            struct LOSKeyHash
+            {
+                std::size_t operator()(const std::array<const Actor*, 2>& actors) const;
+            };
+
             std::vector<LOSRequest> mLOSCache;
+            // Index of the requests in mLOSCache by LOSRequest::mRawActors
+            std::unordered_map<std::array<const Actor*, 2>, std::size_t, LOSKeyHash> mLOSCacheIndex;
+            // Bounds of the objects blocking line of sight that were added, removed or moved since the previous frame.
+            // Only cached requests close to them are raycasted again, unless the actors moved.
+            std::vector<std::pair<btVector3, btVector3>> mLOSChanges;
+            std::vector<std::pair<btVector3, btVector3>> mFrameLOSChanges;
             std::set<std::weak_ptr<PtrHolder>, std::owner_less<std::weak_ptr<PtrHolder>>> mUpdateAabb;
 
-            // TODO: use std::experimental::flex_barrier or std::barrier once it becomes a thing
-            std::unique_ptr<Misc::Barrier> mPreStepBarrier;
-            std::unique_ptr<Misc::Barrier> mPostStepBarrier;
-            std::unique_ptr<Misc::Barrier> mPostSimBarrier;
-
             int mNumThreads;
-            int mNumJobs;
             int mRemainingSteps;
             int mLOSCacheExpiry;
-            std::size_t mFrameCounter;
             bool mAdvanceSimulation;
-            bool mQuit;
-            std::atomic<int> mNextJob;
-            std::atomic<int> mNextLOS;
-            std::vector<std::thread> mThreads;
-
-            std::size_t mWorkersFrameCounter = 0;
-            std::condition_variable mWorkersDone;
-            std::mutex mWorkersDoneMutex;
+            SimulationStage mSimulationStage;
+            std::atomic<unsigned int> mNumLOSQueries;
+            std::atomic<unsigned int> mNumLOSRaycasts;
+            std::unique_ptr<Misc::StagedTaskPool> mPool;
 
-            mutable std::shared_mutex mSimulationMutex;
             mutable std::shared_mutex mCollisionWorldMutex;
             mutable std::shared_mutex mLOSCacheMutex;
+            mutable std::mutex mLOSChangesMutex;
             mutable std::mutex mUpdateAabbMutex;
-            std::condition_variable_any mHasJob;
 
             unsigned int mFrameNumber;
             const osg::Timer* mTimer;
@@ -71,6 +71,8 @@ namespace MWPhysics
         LOSRequest(const std::weak_ptr<Actor>& a1, const std::weak_ptr<Actor>& a2);
         std::array<std::weak_ptr<Actor>, 2> mActors;
         std::array<const Actor*, 2> mRawActors;
+        // Eye positions of mActors used for the last raycast
+        std::array<osg::Vec3f, 2> mPositions;
         bool mResult;
         bool mStale;
         int mAge;
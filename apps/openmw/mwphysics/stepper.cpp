@@ -22,8 +22,8 @@ namespace MWPhysics
         return stepper.mHitObject->getBroadphaseHandle()->m_collisionFilterGroup != CollisionType_Actor;
     }
 
-    Stepper::Stepper(const btCollisionWorld *colWorld, const btCollisionObject *colObj)
-        : mColWorld(colWorld)
+    Stepper::Stepper(const SweepCandidates &candidates, const btCollisionObject *colObj)
+        : mCandidates(candidates)
         , mColObj(colObj)
     {
     }
@@ -36,7 +36,7 @@ namespace MWPhysics
         // Stairstepping algorithms work by moving up to avoid the step, moving forwards, then moving back down onto the ground.
         // This algorithm has a couple of minor problems, but they don't cause problems for sane geometry, and just prevent stepping on insane geometry.
 
-        mUpStepper.doTrace(mColObj, position, position + osg::Vec3f(0.0f, 0.0f, Constants::sStepSizeUp), mColWorld, onGround);
+        mUpStepper.doTrace(mColObj, position, position + osg::Vec3f(0.0f, 0.0f, Constants::sStepSizeUp), mCandidates, onGround);
 
         float upDistance = 0;
         if(!mUpStepper.mHitObject)
@@ -87,7 +87,7 @@ namespace MWPhysics
                 tracerDest = tracerPos + normalMove*sMinStep2;
             }
 
-            mTracer.doTrace(mColObj, tracerPos, tracerDest, mColWorld);
+            mTracer.doTrace(mColObj, tracerPos, tracerDest, mCandidates);
             if(mTracer.mHitObject)
             {
                 // map against what we hit, minus the safety margin
@@ -104,7 +104,7 @@ namespace MWPhysics
                 auto tempDest = tracerDest + mTracer.mPlaneNormal*sCollisionMargin*2;
 
                 ActorTracer tempTracer;
-                tempTracer.doTrace(mColObj, tracerDest, tempDest, mColWorld);
+                tempTracer.doTrace(mColObj, tracerDest, tempDest, mCandidates);
 
                 if(tempTracer.mFraction > 0.5f) // distance to any object is greater than sCollisionMargin (we checked sCollisionMargin*2 distance)
                 {
@@ -117,7 +117,7 @@ namespace MWPhysics
                 downStepSize = upDistance;
             else
                 downStepSize = moveDistance + upDistance + sStepSizeDown;
-            mDownStepper.doTrace(mColObj, tracerDest, tracerDest + osg::Vec3f(0.0f, 0.0f, -downStepSize), mColWorld, onGround);
+            mDownStepper.doTrace(mColObj, tracerDest, tracerDest + osg::Vec3f(0.0f, 0.0f, -downStepSize), mCandidates, onGround);
 
             // can't step down onto air, non-walkable-slopes, or actors
             // NOTE: using a capsule causes isWalkableSlope (used in canStepDown) to fail on certain geometry that were intended to be valid at the bottoms of stairs
@@ -4,7 +4,6 @@
 #include "trace.h"
 
 class btCollisionObject;
-class btCollisionWorld;
 
 namespace osg
 {
@@ -16,13 +15,13 @@ namespace MWPhysics
     class Stepper
     {
     private:
-        const btCollisionWorld *mColWorld;
+        const SweepCandidates &mCandidates;
         const btCollisionObject *mColObj;
 
         ActorTracer mTracer, mUpStepper, mDownStepper;
 
     public:
-        Stepper(const btCollisionWorld *colWorld, const btCollisionObject *colObj);
+        Stepper(const SweepCandidates &candidates, const btCollisionObject *colObj);
 
         bool step(osg::Vec3f &position, osg::Vec3f &velocity, float &remainingTime, const bool & onGround, bool firstIteration);
     };
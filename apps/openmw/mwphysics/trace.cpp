@@ -2,8 +2,10 @@
 
 #include <components/misc/convert.hpp>
 
+#include <BulletCollision/BroadphaseCollision/btBroadphaseInterface.h>
 #include <BulletCollision/CollisionDispatch/btCollisionWorld.h>
 #include <BulletCollision/CollisionShapes/btConvexShape.h>
+#include <LinearMath/btAabbUtil2.h>
 
 #include "collisiontype.hpp"
 #include "actor.hpp"
@@ -12,7 +14,80 @@
 namespace MWPhysics
 {
 
-ActorConvexCallback sweepHelper(const btCollisionObject *actor, const btVector3& from, const btVector3& to, const btCollisionWorld* world, bool actorFilter)
+namespace
+{
+    class CandidateCollector : public btBroadphaseAabbCallback
+    {
+    public:
+        CandidateCollector(const btCollisionObject* me, std::vector<SweepCandidates::Candidate>& candidates)
+            : mMe(me)
+            , mCandidates(candidates)
+        {
+        }
+
+        bool process(const btBroadphaseProxy* proxy) override
+        {
+            // The actor never collides with itself, see ActorConvexCallback
+            if (proxy->m_clientObject != mMe)
+                mCandidates.push_back({proxy->m_aabbMin, proxy->m_aabbMax, static_cast<btCollisionObject*>(proxy->m_clientObject)});
+            return true;
+        }
+
+    private:
+        const btCollisionObject* mMe;
+        std::vector<SweepCandidates::Candidate>& mCandidates;
+    };
+
+    bool contains(const btVector3& outerMin, const btVector3& outerMax, const btVector3& innerMin, const btVector3& innerMax)
+    {
+        return outerMin.x() <= innerMin.x() && outerMin.y() <= innerMin.y() && outerMin.z() <= innerMin.z()
+            && innerMax.x() <= outerMax.x() && innerMax.y() <= outerMax.y() && innerMax.z() <= outerMax.z();
+    }
+}
+
+SweepCandidates::SweepCandidates(const btCollisionObject* actor, const btVector3& aabbMin, const btVector3& aabbMax, const btCollisionWorld* world)
+    : mWorld(world)
+    , mAabbMin(aabbMin)
+    , mAabbMax(aabbMax)
+{
+    // Only reads the broadphase tree, like the ray tests done by btCollisionWorld::convexSweepTest.
+    // The bounds are copied next to each other, most candidates are rejected by the bounds test alone.
+    CandidateCollector collector(actor, mCandidates);
+    const_cast<btCollisionWorld*>(world)->getBroadphase()->aabbTest(aabbMin, aabbMax, collector);
+}
+
+void SweepCandidates::convexSweepTest(const btConvexShape* shape, const btTransform& from, const btTransform& to, ActorConvexCallback& callback) const
+{
+    btVector3 sweepMin, sweepMax;
+    shape->getAabb(from, sweepMin, sweepMax);
+    btVector3 toMin, toMax;
+    shape->getAabb(to, toMin, toMax);
+    sweepMin.setMin(toMin);
+    sweepMax.setMax(toMax);
+
+    if (!contains(mAabbMin, mAabbMax, sweepMin, sweepMax))
+    {
+        mWorld->convexSweepTest(shape, from, to, callback);
+        return;
+    }
+
+    // Same tests as btCollisionWorld::convexSweepTest, without the broadphase traversal
+    for (const Candidate& candidate : mCandidates)
+    {
+        if (callback.m_closestHitFraction == btScalar(0))
+            return;
+        if (!TestAabbAgainstAabb2(sweepMin, sweepMax, candidate.mAabbMin, candidate.mAabbMax))
+            continue;
+        btCollisionObject* object = candidate.mObject;
+        if (!callback.needsCollision(object->getBroadphaseHandle()))
+            continue;
+        btCollisionWorld::objectQuerySingle(shape, from, to, object, object->getCollisionShape(),
+            object->getWorldTransform(), callback, btScalar(0));
+    }
+}
+
+ActorConvexCallback sweepHelper(const btCollisionObject *actor, const btVector3& from, const btVector3& to, const btCollisionWorld* world,
+    const SweepCandidates* candidates, bool actorFilter)
 {
     const btTransform &trans = actor->getWorldTransform();
     btTransform transFrom(trans);
@@ -31,11 +106,25 @@ ActorConvexCallback sweepHelper(const btCollisionObject *actor, const btVector3&
     if(actorFilter)
         traceCallback.m_collisionFilterMask &= ~CollisionType_Actor;
 
-    world->convexSweepTest(static_cast<const btConvexShape*>(shape), transFrom, transTo, traceCallback);
+    if (candidates != nullptr)
+        candidates->convexSweepTest(static_cast<const btConvexShape*>(shape), transFrom, transTo, traceCallback);
+    else
+        world->convexSweepTest(static_cast<const btConvexShape*>(shape), transFrom, transTo, traceCallback);
     return traceCallback;
 }
 
 void ActorTracer::doTrace(const btCollisionObject *actor, const osg::Vec3f& start, const osg::Vec3f& end, const btCollisionWorld* world, bool attempt_short_trace)
+{
+    doTrace(actor, start, end, world, nullptr, attempt_short_trace);
+}
+
+void ActorTracer::doTrace(const btCollisionObject *actor, const osg::Vec3f& start, const osg::Vec3f& end, const SweepCandidates& candidates, bool attempt_short_trace)
+{
+    doTrace(actor, start, end, candidates.getWorld(), &candidates, attempt_short_trace);
+}
+
+void ActorTracer::doTrace(const btCollisionObject *actor, const osg::Vec3f& start, const osg::Vec3f& end, const btCollisionWorld* world,
+    const SweepCandidates* candidates, bool attempt_short_trace)
 {
     const btVector3 btstart = Misc::Convert::toBullet(start);
     btVector3 btend = Misc::Convert::toBullet(end);
@@ -58,7 +147,7 @@ void ActorTracer::doTrace(const btCollisionObject *actor, const osg::Vec3f& star
         doing_short_trace = true;
     }
 
-    const auto traceCallback = sweepHelper(actor, btstart, btend, world, false);
+    const auto traceCallback = sweepHelper(actor, btstart, btend, world, candidates, false);
 
     // Copy the hit data over to our trace results struct:
     if(traceCallback.hasHit())
@@ -77,7 +166,7 @@ void ActorTracer::doTrace(const btCollisionObject *actor, const osg::Vec3f& star
         if(doing_short_trace)
         {
             btend = Misc::Convert::toBullet(end);
-            const auto newTraceCallback = sweepHelper(actor, btstart, btend, world, false);
+            const auto newTraceCallback = sweepHelper(actor, btstart, btend, world, candidates, false);
 
             if(newTraceCallback.hasHit())
             {
@@ -100,7 +189,7 @@ void ActorTracer::doTrace(const btCollisionObject *actor, const osg::Vec3f& star
 
 void ActorTracer::findGround(const Actor* actor, const osg::Vec3f& start, const osg::Vec3f& end, const btCollisionWorld* world)
 {
-    const auto traceCallback = sweepHelper(actor->getCollisionObject(), Misc::Convert::toBullet(start), Misc::Convert::toBullet(end), world, true);
+    const auto traceCallback = sweepHelper(actor->getCollisionObject(), Misc::Convert::toBullet(start), Misc::Convert::toBullet(end), world, nullptr, true);
     if(traceCallback.hasHit())
     {
         mFraction = traceCallback.m_closestHitFraction;
@@ -1,15 +1,52 @@
 #ifndef OENGINE_BULLET_TRACE_H
 #define OENGINE_BULLET_TRACE_H
 
+#include <vector>
+
 #include <osg/Vec3f>
 
+#include <LinearMath/btVector3.h>
+
 class btCollisionObject;
 class btCollisionWorld;
+class btConvexShape;
+class btTransform;
 
 
 namespace MWPhysics
 {
     class Actor;
+    class ActorConvexCallback;
+
+    /// @brief Collision objects around an actor, gathered with a single broadphase query whose bounds cover all the
+    ///     sweeps done while solving the actor movement. The sweeps then only test these objects instead of traversing
+    ///     the broadphase each time.
+    /// @note The collision world must not be modified while the candidates are in use.
+    class SweepCandidates
+    {
+        public:
+            struct Candidate
+            {
+                btVector3 mAabbMin;
+                btVector3 mAabbMax;
+                btCollisionObject* mObject;
+            };
+
+            SweepCandidates(const btCollisionObject* actor, const btVector3& aabbMin, const btVector3& aabbMax, const btCollisionWorld* world);
+
+            /// Same as btCollisionWorld::convexSweepTest, which is used instead if the sweep leaves the gathered bounds.
+            void convexSweepTest(const btConvexShape* shape, const btTransform& from, const btTransform& to, ActorConvexCallback& callback) const;
+
+            const btCollisionWorld* getWorld() const { return mWorld; }
+
+            std::size_t size() const { return mCandidates.size(); }
+
+        private:
+            const btCollisionWorld* mWorld;
+            btVector3 mAabbMin;
+            btVector3 mAabbMax;
+            std::vector<Candidate> mCandidates;
+    };
 
     struct ActorTracer
     {
@@ -21,7 +58,12 @@ namespace MWPhysics
         float mFraction;
 
         void doTrace(const btCollisionObject *actor, const osg::Vec3f& start, const osg::Vec3f& end, const btCollisionWorld* world, bool attempt_short_trace = false);
+        void doTrace(const btCollisionObject *actor, const osg::Vec3f& start, const osg::Vec3f& end, const SweepCandidates& candidates, bool attempt_short_trace = false);
         void findGround(const Actor* actor, const osg::Vec3f& start, const osg::Vec3f& end, const btCollisionWorld* world);
+
+    private:
+        void doTrace(const btCollisionObject *actor, const osg::Vec3f& start, const osg::Vec3f& end, const btCollisionWorld* world,
+            const SweepCandidates* candidates, bool attempt_short_trace);
     };
 }
 
@@ -27,6 +27,7 @@
 #include <components/vfs/manager.hpp>
 
 #include <components/sceneutil/actorutil.hpp>
+#include <components/sceneutil/animationbatch.hpp>
 #include <components/sceneutil/statesetupdater.hpp>
 #include <components/sceneutil/visitor.hpp>
 #include <components/sceneutil/lightmanager.hpp>
@@ -479,20 +480,21 @@ namespace MWRender
         }
     }
 
-    class ResetAccumRootCallback : public SceneUtil::NodeCallback<ResetAccumRootCallback, osg::MatrixTransform*>
+    class ResetAccumRootCallback : public SceneUtil::NodeCallback<ResetAccumRootCallback, osg::MatrixTransform*>, public SceneUtil::BatchedCallback
     {
     public:
         void operator()(osg::MatrixTransform* transform, osg::NodeVisitor* nv)
         {
-            osg::Matrix mat = transform->getMatrix();
-            osg::Vec3f position = mat.getTrans();
-            position = osg::componentMultiply(mResetAxes, position);
-            mat.setTrans(position);
-            transform->setMatrix(mat);
+            apply(transform);
 
             traverse(transform, nv);
         }
 
+        void applyBatched(osg::Node* node, osg::NodeVisitor* nv) override
+        {
+            apply(static_cast<osg::MatrixTransform*>(node));
+        }
+
         void setAccumulate(const osg::Vec3f& accumulate)
         {
             // anything that accumulates (1.f) should be reset in the callback to (0.f)
@@ -502,9 +504,56 @@ namespace MWRender
         }
 
     private:
+        void apply(osg::MatrixTransform* transform)
+        {
+            osg::Matrix mat = transform->getMatrix();
+            osg::Vec3f position = mat.getTrans();
+            position = osg::componentMultiply(mResetAxes, position);
+            mat.setTrans(position);
+            transform->setMatrix(mat);
+        }
+
         osg::Vec3f mResetAxes;
     };
 
+    // Finds out whether update callbacks are left on any of the bones
+    class HasTransformCallbackVisitor : public osg::NodeVisitor
+    {
+    public:
+        HasTransformCallbackVisitor()
+            : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN)
+            , mFound(false)
+        {
+        }
+
+        void apply(osg::MatrixTransform& transform) override
+        {
+            if (transform.getUpdateCallback())
+                mFound = true;
+            else
+                traverse(transform);
+        }
+
+        void apply(osg::Node& node) override
+        {
+            if (!mFound)
+                traverse(node);
+        }
+
+        bool mFound;
+    };
+
+    std::size_t getDepth(const osg::Node* node, const osg::Node* root)
+    {
+        std::size_t depth = 0;
+        while (node != root && node->getNumParents() > 0)
+        {
+            node = node->getParent(0);
+            ++depth;
+        }
+        return depth;
+    }
+
     Animation::Animation(const MWWorld::Ptr &ptr, osg::ref_ptr<osg::Group> parentNode, Resource::ResourceSystem* resourceSystem)
         : mInsert(parentNode)
         , mSkeleton(nullptr)
@@ -512,6 +561,7 @@ namespace MWRender
         , mPtr(ptr)
         , mResourceSystem(resourceSystem)
         , mAccumulate(1.f, 1.f, 0.f)
+        , mAnimationBatch(nullptr)
         , mTextKeyListener(nullptr)
         , mHeadYawRadians(0.f)
         , mHeadPitchRadians(0.f)
@@ -531,6 +581,14 @@ namespace MWRender
     {
         Animation::setLightEffect(0.f);
 
+        // The batch releases the group on its own
+        if (mAnimationBatchGroup)
+        {
+            mAnimationBatchGroup->clear();
+            if (mAnimationBatchRoot)
+                mAnimationBatchRoot->removeUpdateCallback(mAnimationBatchGroup->getRootCallback());
+        }
+
         if (mObjectRoot)
             mInsert->removeChild(mObjectRoot);
     }
@@ -545,6 +603,33 @@ namespace MWRender
         return mPtr;
     }
 
+    void Animation::setAnimationBatch(SceneUtil::AnimationBatch* batch)
+    {
+        if (batch == mAnimationBatch)
+            return;
+
+        if (mAnimationBatchGroup)
+        {
+            mAnimationBatchGroup->clear();
+            if (mAnimationBatchRoot)
+                mAnimationBatchRoot->removeUpdateCallback(mAnimationBatchGroup->getRootCallback());
+            mAnimationBatchRoot = nullptr;
+            // A group can't be moved between batches, the previous batch releases it
+            mAnimationBatchGroup = nullptr;
+        }
+
+        mAnimationBatch = batch;
+        if (mAnimationBatch)
+        {
+            mAnimationBatchGroup = new SceneUtil::AnimationBatchGroup;
+            mAnimationBatch->addGroup(mAnimationBatchGroup);
+        }
+
+        // Move the controllers to or from the batch
+        if (mObjectRoot)
+            resetActiveGroups();
+    }
+
     void Animation::setActive(int active)
     {
         if (mSkeleton)
@@ -1012,6 +1097,58 @@ namespace MWRender
             }
         }
         addControllers();
+
+        updateAnimationBatchGroup();
+    }
+
+    void Animation::updateAnimationBatchGroup()
+    {
+        if (!mAnimationBatchGroup)
+            return;
+
+        mAnimationBatchGroup->clear();
+
+        if (mObjectRoot != mAnimationBatchRoot)
+        {
+            if (mAnimationBatchRoot)
+                mAnimationBatchRoot->removeUpdateCallback(mAnimationBatchGroup->getRootCallback());
+            mAnimationBatchRoot = mObjectRoot;
+            if (mAnimationBatchRoot)
+                mAnimationBatchRoot->addUpdateCallback(mAnimationBatchGroup->getRootCallback());
+        }
+
+        if (!mObjectRoot)
+            return;
+
+        // Evaluate parents before their children, and the callbacks of a node in the order they were added
+        struct Entry
+        {
+            std::size_t mDepth;
+            osg::Node* mNode;
+            osg::Callback* mCallback;
+            SceneUtil::BatchedCallback* mBatched;
+        };
+        std::vector<Entry> entries;
+        for (const auto& [node, callback] : mActiveControllers)
+        {
+            if (auto batched = dynamic_cast<SceneUtil::BatchedCallback*>(callback.get()))
+                entries.push_back(Entry {getDepth(node, mObjectRoot), node, callback, batched});
+        }
+        std::stable_sort(entries.begin(), entries.end(), [] (const Entry& l, const Entry& r) { return l.mDepth < r.mDepth; });
+
+        for (const Entry& entry : entries)
+        {
+            entry.mNode->removeUpdateCallback(entry.mCallback);
+            entry.mCallback->setNestedCallback(nullptr);
+            mAnimationBatchGroup->add(entry.mNode, entry.mCallback, entry.mBatched);
+        }
+
+        mAnimationBatchGroup->setSkeleton(mSkeleton);
+
+        // Bone matrices can only be computed right after the batch if no other callback moves the bones afterwards
+        HasTransformCallbackVisitor visitor;
+        mObjectRoot->accept(visitor);
+        mAnimationBatchGroup->setUpdateBoneMatrices(!visitor.mFound);
     }
 
     void Animation::adjustSpeedMult(const std::string &groupname, float speedmult)
@@ -1380,6 +1517,8 @@ namespace MWRender
         mNodeMap.clear();
         mNodeMapCreated = false;
         mActiveControllers.clear();
+        if (mAnimationBatchGroup)
+            mAnimationBatchGroup->clear();
         mAccumRoot = nullptr;
         mAccumCtrl = nullptr;
 
@@ -25,6 +25,8 @@ namespace Resource
 
 namespace SceneUtil
 {
+    class AnimationBatch;
+    class AnimationBatchGroup;
     class KeyframeHolder;
     class KeyframeController;
     class LightSource;
@@ -252,6 +254,11 @@ protected:
     // We may need to rebuild these controllers when the active animation groups / sources change.
     std::vector<std::pair<osg::ref_ptr<osg::Node>, osg::ref_ptr<osg::Callback>>> mActiveControllers;
 
+    // Batched controllers are moved from mActiveControllers into this group, if a batch is used.
+    SceneUtil::AnimationBatch* mAnimationBatch;
+    osg::ref_ptr<SceneUtil::AnimationBatchGroup> mAnimationBatchGroup;
+    osg::ref_ptr<osg::Node> mAnimationBatchRoot;
+
     std::shared_ptr<AnimationTime> mAnimationTimePtr[sNumBlendMasks];
 
     mutable NodeMap mNodeMap;
@@ -295,6 +302,8 @@ protected:
      */
     void resetActiveGroups();
 
+    void updateAnimationBatchGroup();
+
     size_t detectBlendMask(const osg::Node* node) const;
 
     /* Updates the position of the accum root node for the given time, and
@@ -355,6 +364,10 @@ public:
 
     MWWorld::Ptr getPtr();
 
+    /// Evaluate the keyframe and bone controllers of this object in the given batch rather than in the update
+    /// traversal of the object, or in the update traversal again if nullptr.
+    void setAnimationBatch(SceneUtil::AnimationBatch* batch);
+
     /// Set active flag on the object skeleton, if one exists.
     /// @see SceneUtil::Skeleton::setActive
     /// 0 = Inactive, 1 = Active in place, 2 = Active
@@ -126,6 +126,8 @@ namespace MWRender
         {
         }
 
+        const char* getTraceName() const override { return "createmap"; }
+
         void doWork() override
         {
             osg::ref_ptr<osg::Image> image = new osg::Image;
@@ -249,6 +251,8 @@ namespace MWRender
         explicit WritePng(osg::ref_ptr<const osg::Image> overlayImage)
             : mOverlayImage(std::move(overlayImage)) {}
 
+        const char* getTraceName() const override { return "writepng"; }
+
         void doWork() override
         {
             mImageData = writePng(*mOverlayImage);
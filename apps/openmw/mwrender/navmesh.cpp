@@ -68,6 +68,8 @@ namespace MWRender
         {
         }
 
+        const char* getTraceName() const final { return "createnavmeshtilegroups"; }
+
         void doWork() final
         {
             using DetourNavigator::TilePosition;
@@ -160,6 +162,8 @@ namespace MWRender
 
         explicit DeallocateCreateNavMeshTileGroups(osg::ref_ptr<NavMesh::CreateNavMeshTileGroups>&& workItem)
             : mWorkItem(std::move(workItem)) {}
+
+        const char* getTraceName() const final { return "deallocatenavmeshtilegroups"; }
     };
 
     NavMesh::NavMesh(const osg::ref_ptr<osg::Group>& root, const osg::ref_ptr<SceneUtil::WorkQueue>& workQueue,
@@ -2,6 +2,7 @@
 
 #include <unordered_map>
 
+#include <osg/Geometry>
 #include <osg/LOD>
 #include <osg/Switch>
 #include <osg/Sequence>
@@ -391,6 +392,185 @@ namespace MWRender
         }
     };
 
+    /// Locations of the references in an active grid chunk, so that they can be hidden and shown again
+    /// without merging the chunk again.
+    class ActiveGridRefs : public osg::Object
+    {
+    public:
+        ActiveGridRefs() {}
+        ActiveGridRefs(const ActiveGridRefs& copy, const osg::CopyOp&)
+            : mRefnums(copy.mRefnums), mInstances(copy.mInstances), mGeometries(copy.mGeometries), mHidden(copy.mHidden) {}
+        META_Object(MWRender, ActiveGridRefs)
+
+        struct Instance
+        {
+            osg::ref_ptr<osg::Node> mNode;
+            osg::Node::NodeMask mNodeMask;
+        };
+
+        struct VertexRange
+        {
+            unsigned int mFirst;
+            unsigned int mCount;
+            bool operator==(const VertexRange& other) const { return mFirst == other.mFirst && mCount == other.mCount; }
+        };
+
+        struct MergedGeometry
+        {
+            osg::ref_ptr<osg::Geometry> mGeometry;
+            osg::Geometry::PrimitiveSetList mPrimitives;
+            std::map<ESM::RefNum, std::vector<VertexRange>> mRanges;
+            std::vector<VertexRange> mHiddenRanges;
+        };
+
+        /// References with geometry in the chunk.
+        std::set<ESM::RefNum> mRefnums;
+        std::map<ESM::RefNum, std::vector<Instance>> mInstances;
+        std::vector<MergedGeometry> mGeometries;
+        std::set<ESM::RefNum> mHidden;
+    };
+
+    class CollectActiveGridRefsVisitor : public osg::NodeVisitor
+    {
+    public:
+        CollectActiveGridRefsVisitor(ActiveGridRefs& refs) : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN), mRefs(refs) {}
+
+        void apply(osg::Node& node) override
+        {
+            // Instances that were not merged carry a single marker on their transform
+            if (const osg::UserDataContainer* udc = node.getUserDataContainer())
+            {
+                for (unsigned int i=0; i<udc->getNumUserObjects(); ++i)
+                {
+                    if (const RefnumMarker* marker = dynamic_cast<const RefnumMarker*>(udc->getUserObject(i)))
+                    {
+                        mRefs.mRefnums.insert(marker->mRefnum);
+                        mRefs.mInstances[marker->mRefnum].push_back({&node, node.getNodeMask()});
+                        return;
+                    }
+                }
+            }
+            traverse(node);
+        }
+
+        void apply(osg::Geometry& geometry) override
+        {
+            const osg::UserDataContainer* udc = geometry.getUserDataContainer();
+            if (!udc)
+                return;
+            ActiveGridRefs::MergedGeometry merged;
+            unsigned int first = 0;
+            // The merged vertices are in the order of the markers, see RenderingManager::getIntersectionResult
+            for (unsigned int i=0; i<udc->getNumUserObjects(); ++i)
+            {
+                const RefnumMarker* marker = dynamic_cast<const RefnumMarker*>(udc->getUserObject(i));
+                if (!marker || !marker->mNumVertices)
+                    continue;
+                merged.mRanges[marker->mRefnum].push_back({first, marker->mNumVertices});
+                mRefs.mRefnums.insert(marker->mRefnum);
+                first += marker->mNumVertices;
+            }
+            if (merged.mRanges.empty())
+                return;
+            merged.mGeometry = &geometry;
+            merged.mPrimitives = geometry.getPrimitiveSetList();
+            mRefs.mGeometries.push_back(std::move(merged));
+        }
+
+    private:
+        ActiveGridRefs& mRefs;
+    };
+
+    bool isHiddenVertex(unsigned int index, const std::vector<ActiveGridRefs::VertexRange>& hiddenRanges)
+    {
+        for (const auto& range : hiddenRanges)
+            if (index >= range.mFirst && index < range.mFirst + range.mCount)
+                return true;
+        return false;
+    }
+
+    template <class DrawElementsType>
+    osg::ref_ptr<osg::PrimitiveSet> filterDrawElements(const osg::PrimitiveSet& primitives, unsigned int primitiveSize, const std::vector<ActiveGridRefs::VertexRange>& hiddenRanges)
+    {
+        osg::ref_ptr<DrawElementsType> filtered = new DrawElementsType(primitives.getMode());
+        for (unsigned int i=0; i+primitiveSize<=primitives.getNumIndices(); i+=primitiveSize)
+        {
+            bool visible = true;
+            for (unsigned int j=0; j<primitiveSize && visible; ++j)
+                visible = !isHiddenVertex(primitives.index(i+j), hiddenRanges);
+            if (!visible)
+                continue;
+            for (unsigned int j=0; j<primitiveSize; ++j)
+                filtered->push_back(primitives.index(i+j));
+        }
+        return filtered;
+    }
+
+    /// @return primitives without the hidden vertices, nullptr if nothing remains
+    osg::ref_ptr<osg::PrimitiveSet> filterPrimitiveSet(osg::PrimitiveSet* primitives, const std::vector<ActiveGridRefs::VertexRange>& hiddenRanges)
+    {
+        unsigned int numHidden = 0;
+        for (unsigned int i=0; i<primitives->getNumIndices(); ++i)
+            numHidden += isHiddenVertex(primitives->index(i), hiddenRanges);
+        if (numHidden == 0)
+            return primitives;
+        if (numHidden == primitives->getNumIndices())
+            return nullptr;
+
+        // Strips and fans of different references are never merged, so they are either hidden entirely or not at all.
+        unsigned int primitiveSize = 0;
+        switch (primitives->getMode())
+        {
+            case osg::PrimitiveSet::POINTS: primitiveSize = 1; break;
+            case osg::PrimitiveSet::LINES: primitiveSize = 2; break;
+            case osg::PrimitiveSet::TRIANGLES: primitiveSize = 3; break;
+            default: return primitives;
+        }
+        switch (primitives->getType())
+        {
+            case osg::PrimitiveSet::DrawElementsUBytePrimitiveType:
+                return filterDrawElements<osg::DrawElementsUByte>(*primitives, primitiveSize, hiddenRanges);
+            case osg::PrimitiveSet::DrawElementsUShortPrimitiveType:
+                return filterDrawElements<osg::DrawElementsUShort>(*primitives, primitiveSize, hiddenRanges);
+            default:
+                return filterDrawElements<osg::DrawElementsUInt>(*primitives, primitiveSize, hiddenRanges);
+        }
+    }
+
+    void applyHidden(ActiveGridRefs& refs)
+    {
+        for (auto& [refnum, instances] : refs.mInstances)
+        {
+            bool hidden = refs.mHidden.count(refnum);
+            for (auto& instance : instances)
+                instance.mNode->setNodeMask(hidden ? 0 : instance.mNodeMask);
+        }
+
+        for (auto& merged : refs.mGeometries)
+        {
+            std::vector<ActiveGridRefs::VertexRange> hiddenRanges;
+            for (const auto& [refnum, ranges] : merged.mRanges)
+                if (refs.mHidden.count(refnum))
+                    hiddenRanges.insert(hiddenRanges.end(), ranges.begin(), ranges.end());
+            if (hiddenRanges == merged.mHiddenRanges)
+                continue;
+            merged.mHiddenRanges = hiddenRanges;
+
+            osg::Geometry::PrimitiveSetList primitives;
+            for (const auto& primitiveSet : merged.mPrimitives)
+                if (osg::ref_ptr<osg::PrimitiveSet> filtered = filterPrimitiveSet(primitiveSet, hiddenRanges))
+                    primitives.push_back(filtered);
+
+            // The draw traversal may still be using the current geometry, so swap in a copy instead of modifying it.
+            // The copy shares the unmodified vertex arrays, the new primitive sets get their own buffer objects.
+            osg::ref_ptr<osg::Geometry> geometry = new osg::Geometry(*merged.mGeometry, osg::CopyOp::SHALLOW_COPY);
+            geometry->setPrimitiveSetList(primitives);
+            for (osg::Group* parent : merged.mGeometry->getParents())
+                parent->replaceChild(merged.mGeometry, geometry);
+            merged.mGeometry = geometry;
+        }
+    }
+
     ObjectPaging::ObjectPaging(Resource::SceneManager* sceneManager)
             : GenericResourceManager<ChunkId>(nullptr)
          , mSceneManager(sceneManager)
@@ -726,6 +906,13 @@ namespace MWRender
             group->addCullCallback(new SceneUtil::LightListCallback);
         }
         udc->addUserObject(templateRefs);
+        if (activeGrid)
+        {
+            osg::ref_ptr<ActiveGridRefs> activeGridRefs = new ActiveGridRefs;
+            CollectActiveGridRefsVisitor visitor(*activeGridRefs);
+            group->accept(visitor);
+            udc->addUserObject(activeGridRefs);
+        }
 
         return group;
     }
@@ -735,11 +922,26 @@ namespace MWRender
         return Mask_Static;
     }
 
+    ActiveGridRefs* getActiveGridRefs(osg::Object* chunk)
+    {
+        osg::UserDataContainer* udc = chunk->getUserDataContainer();
+        if (!udc)
+            return nullptr;
+        for (unsigned int i=0; i<udc->getNumUserObjects(); ++i)
+            if (ActiveGridRefs* refs = dynamic_cast<ActiveGridRefs*>(udc->getUserObject(i)))
+                return refs;
+        return nullptr;
+    }
+
     struct ClearCacheFunctor
     {
         void operator()(MWRender::ChunkId id, osg::Object* obj)
         {
-            if (intersects(id, mPosition))
+            if (!intersects(id, mPosition))
+                return;
+            if (std::get<2>(id) && getActiveGridRefs(obj))
+                mToUpdate.emplace_back(id, obj);
+            else
                 mToClear.insert(id);
         }
         bool intersects(ChunkId id, osg::Vec3f pos)
@@ -759,9 +961,46 @@ namespace MWRender
         osg::Vec3f mPosition;
         osg::Vec2i mCell;
         std::set<MWRender::ChunkId> mToClear;
+        /// Active grid chunks that can be updated in place
+        std::vector<std::pair<MWRender::ChunkId, osg::ref_ptr<osg::Object>>> mToUpdate;
         bool mActiveGridOnly = false;
     };
 
+    bool ObjectPaging::updateActiveGridChunks(const ESM::RefNum& refnum, ClearCacheFunctor& ccf)
+    {
+        for (const auto& [id, chunk] : ccf.mToUpdate)
+        {
+            ActiveGridRefs* refs = getActiveGridRefs(chunk);
+            RefnumSet* refnumSet = dynamic_cast<RefnumSet*>(chunk->getUserDataContainer()->getUserObject(0));
+            if (!refnumSet || !refnumSet->mRefnums.count(refnum))
+                continue;
+            bool hidden;
+            bool blacklisted;
+            {
+                std::lock_guard<std::mutex> lock(mRefTrackerMutex);
+                hidden = getRefTracker().mDisabled.count(refnum) || getRefTracker().mBlacklist.count(refnum);
+                blacklisted = getRefTracker().mBlacklist.count(refnum);
+            }
+            // A reference that was disabled when the chunk was created has no geometry to show
+            if (!hidden && !refs->mRefnums.count(refnum))
+            {
+                ccf.mToClear.insert(id);
+                continue;
+            }
+            if (hidden)
+                refs->mHidden.insert(refnum);
+            else
+                refs->mHidden.erase(refnum);
+            // Blacklisted references are rendered on their own from now on
+            if (blacklisted)
+                refnumSet->mRefnums.erase(refnum);
+            applyHidden(*refs);
+        }
+        for (const auto& chunk : ccf.mToClear)
+            mCache->removeFromObjectCache(chunk);
+        return !ccf.mToClear.empty();
+    }
+
     bool ObjectPaging::enableObject(int type, const ESM::RefNum & refnum, const osg::Vec3f& pos, const osg::Vec2i& cell, bool enabled)
     {
         if (!typeFilter(type, false))
@@ -778,10 +1017,7 @@ namespace MWRender
         ccf.mPosition = pos;
         ccf.mCell = cell;
         mCache->call(ccf);
-        if (ccf.mToClear.empty()) return false;
-        for (const auto& chunk : ccf.mToClear)
-            mCache->removeFromObjectCache(chunk);
-        return true;
+        return updateActiveGridChunks(refnum, ccf);
     }
 
     bool ObjectPaging::blacklistObject(int type, const ESM::RefNum & refnum, const osg::Vec3f& pos, const osg::Vec2i& cell)
@@ -800,10 +1036,7 @@ namespace MWRender
         ccf.mCell = cell;
         ccf.mActiveGridOnly = true;
         mCache->call(ccf);
-        if (ccf.mToClear.empty()) return false;
-        for (const auto& chunk : ccf.mToClear)
-            mCache->removeFromObjectCache(chunk);
-        return true;
+        return updateActiveGridChunks(refnum, ccf);
     }
 
 
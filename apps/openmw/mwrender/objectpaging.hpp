@@ -21,6 +21,8 @@ namespace MWRender
 
     typedef std::tuple<osg::Vec2f, float, bool> ChunkId; // Center, Size, ActiveGrid
 
+    struct ClearCacheFunctor;
+
     class ObjectPaging : public Resource::GenericResourceManager<ChunkId>, public Terrain::QuadTreeWorld::ChunkManager
     {
     public:
@@ -72,6 +74,11 @@ namespace MWRender
         const RefTracker& getRefTracker() const { return mRefTracker; }
         RefTracker& getWritableRefTracker() { return mRefTrackerLocked ? mRefTrackerNew : mRefTracker; }
 
+        /// Hide or show the reference in the active grid chunks collected by the functor without merging them again,
+        /// clear the chunks that cannot be updated in place.
+        /// @return true if view needs rebuild
+        bool updateActiveGridChunks(const ESM::RefNum& refnum, ClearCacheFunctor& ccf);
+
         std::mutex mSizeCacheMutex;
         typedef std::map<ESM::RefNum, float> SizeCache;
         SizeCache mSizeCache;
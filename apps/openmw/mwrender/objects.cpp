@@ -20,6 +20,7 @@ namespace MWRender
 Objects::Objects(Resource::ResourceSystem* resourceSystem, osg::ref_ptr<osg::Group> rootNode)
     : mRootNode(rootNode)
     , mResourceSystem(resourceSystem)
+    , mAnimationBatch(nullptr)
 {
 }
 
@@ -72,6 +73,7 @@ void Objects::insertModel(const MWWorld::Ptr &ptr, const std::string &mesh, bool
     ptr.getRefData().getBaseNode()->setNodeMask(Mask_Object);
 
     osg::ref_ptr<ObjectAnimation> anim (new ObjectAnimation(ptr, mesh, mResourceSystem, animated, allowLight));
+    anim->setAnimationBatch(mAnimationBatch);
 
     mObjects.insert(std::make_pair(ptr, anim));
 }
@@ -88,6 +90,7 @@ void Objects::insertCreature(const MWWorld::Ptr &ptr, const std::string &mesh, b
         anim = new CreatureWeaponAnimation(ptr, mesh, mResourceSystem);
     else
         anim = new CreatureAnimation(ptr, mesh, mResourceSystem);
+    anim->setAnimationBatch(mAnimationBatch);
 
     if (mObjects.insert(std::make_pair(ptr, anim)).second)
         ptr.getClass().getContainerStore(ptr).setContListener(static_cast<ActorAnimation*>(anim.get()));
@@ -99,6 +102,7 @@ void Objects::insertNPC(const MWWorld::Ptr &ptr)
     ptr.getRefData().getBaseNode()->setNodeMask(Mask_Actor);
 
     osg::ref_ptr<NpcAnimation> anim (new NpcAnimation(ptr, osg::ref_ptr<osg::Group>(ptr.getRefData().getBaseNode()), mResourceSystem));
+    anim->setAnimationBatch(mAnimationBatch);
 
     if (mObjects.insert(std::make_pair(ptr, anim)).second)
     {
@@ -201,6 +205,13 @@ void Objects::updatePtr(const MWWorld::Ptr &old, const MWWorld::Ptr &cur)
     }
 }
 
+void Objects::setAnimationBatch(SceneUtil::AnimationBatch* batch)
+{
+    mAnimationBatch = batch;
+    for (const auto& [ptr, animation] : mObjects)
+        animation->setAnimationBatch(batch);
+}
+
 Animation* Objects::getAnimation(const MWWorld::Ptr &ptr)
 {
     PtrAnimationMap::const_iterator iter = mObjects.find(ptr);
@@ -24,6 +24,11 @@ namespace MWWorld
     class CellStore;
 }
 
+namespace SceneUtil
+{
+    class AnimationBatch;
+}
+
 namespace MWRender{
 
 class Animation;
@@ -61,6 +66,8 @@ class Objects{
 
     Resource::ResourceSystem* mResourceSystem;
 
+    SceneUtil::AnimationBatch* mAnimationBatch;
+
     void insertBegin(const MWWorld::Ptr& ptr);
 
 public:
@@ -74,6 +81,9 @@ public:
     void insertNPC(const MWWorld::Ptr& ptr);
     void insertCreature (const MWWorld::Ptr& ptr, const std::string& model, bool weaponsShields);
 
+    /// Evaluate the animations of all objects in the given batch, or in the update traversal if nullptr.
+    void setAnimationBatch(SceneUtil::AnimationBatch* batch);
+
     Animation* getAnimation(const MWWorld::Ptr &ptr);
     const Animation* getAnimation(const MWWorld::ConstPtr &ptr) const;
 
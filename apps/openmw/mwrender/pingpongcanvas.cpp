@@ -1,5 +1,7 @@
 #include "pingpongcanvas.hpp"
 
+#include <SDL_opengl_glext.h>
+
 #include <components/shader/shadermanager.hpp>
 #include <components/debug/debuglog.hpp>
 
@@ -56,6 +58,24 @@ namespace MWRender
         osg::Geometry::drawImplementation(renderInfo);
     }
 
+    void PingPongCanvas::dispatchCompute(osg::State& state, osg::GLExtensions* ext, osg::Texture2D& output) const
+    {
+        const osg::Texture::TextureObject* textureObject = output.getTextureObject(state.getContextID());
+        const std::optional<GLenum> format = fx::Pass::getImageFormat(output.getInternalFormat());
+
+        // Targets are created when their framebuffer is first applied, formats are checked when the technique compiles
+        if (!textureObject || !format)
+            return;
+
+        ext->glBindImageTexture(0, textureObject->id(), 0, GL_FALSE, 0, GL_WRITE_ONLY, *format);
+
+        constexpr int groupSize = fx::Pass::sComputeWorkGroupSize;
+        ext->glDispatchCompute((output.getTextureWidth() + groupSize - 1) / groupSize, (output.getTextureHeight() + groupSize - 1) / groupSize, 1);
+
+        // Later passes sample the image or draw to it
+        ext->glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_FRAMEBUFFER_BARRIER_BIT);
+    }
+
     void PingPongCanvas::drawImplementation(osg::RenderInfo& renderInfo) const
     {
         osg::State& state = *renderInfo.getState();
@@ -215,7 +235,7 @@ namespace MWRender
 
                     lastApplied = pass.mRenderTarget->getHandle(state.getContextID());;
                 }
-                else if (&pass == resolvePass)
+                else if (&pass == resolvePass && !pass.mCompute)
                 {
                     bindDestinationFbo();
                 }
@@ -240,13 +260,43 @@ namespace MWRender
                 state.pushStateSet(pass.mStateSet);
                 state.apply();
 
-                if (!state.getLastAppliedProgramObject())
+                const bool linked = state.getLastAppliedProgramObject() != nullptr;
+
+                if (!linked)
                     mFallbackProgram->apply(state);
 
-                drawGeometry(renderInfo);
+                if (pass.mCompute)
+                {
+                    if (linked)
+                    {
+                        osg::Texture2D* output = pass.mRenderTexture ? pass.mRenderTexture.get()
+                            : (osg::Texture2D*)mFbos[lastDraw - GL_COLOR_ATTACHMENT0_EXT]->getAttachment(osg::Camera::COLOR_BUFFER0).getTexture();
+
+                        dispatchCompute(state, ext, *output);
+                    }
+                }
+                else
+                    drawGeometry(renderInfo);
 
                 state.popStateSet();
                 state.apply();
+
+                // Images can't be bound to the destination, so the compute pass resolving the chain wrote to a ping-pong buffer instead
+                if (pass.mCompute && &pass == resolvePass)
+                {
+                    bindDestinationFbo();
+
+                    mFallbackStateSet->setTextureAttributeAndModes(0, mFbos[lastDraw - GL_COLOR_ATTACHMENT0_EXT]->getAttachment(osg::Camera::COLOR_BUFFER0).getTexture());
+
+                    state.pushStateSet(mFallbackStateSet);
+                    state.apply();
+                    viewport->apply(state);
+
+                    drawGeometry(renderInfo);
+
+                    state.popStateSet();
+                    state.apply();
+                }
             }
 
             state.popStateSet();
@@ -55,6 +55,8 @@ namespace MWRender
     private:
         void copyNewFrameData(size_t frameId) const;
 
+        void dispatchCompute(osg::State& state, osg::GLExtensions* ext, osg::Texture2D& output) const;
+
         mutable HDRDriver mHDRDriver;
 
         osg::ref_ptr<osg::Program> mFallbackProgram;
@@ -94,6 +94,7 @@ namespace MWRender
         , mNormals(false)
         , mPrevNormals(false)
         , mNormalsSupported(false)
+        , mComputeSupported(false)
         , mPassLights(false)
         , mPrevPassLights(false)
         , mMainTemplate(new osg::Texture2D)
@@ -125,6 +126,10 @@ namespace MWRender
 
         mGLSLVersion = ext->glslLanguageVersion * 100;
         mUBO = ext && ext->isUniformBufferObjectSupported && mGLSLVersion >= 330;
+        mComputeSupported = mGLSLVersion >= 430 && ext->glDispatchCompute && ext->glBindImageTexture && ext->glMemoryBarrier && !Stereo::getMultiview();
+
+        if (!mComputeSupported)
+            Log(Debug::Info) << "Compute shaders unsupported, post processing passes will use their fragment shader fallbacks.";
         mStateUpdater = new fx::StateUpdater(mUBO);
 
         if (!SceneUtil::AutoDepth::isReversed() && !mSoftParticles && !mUsePostProcessing && !Stereo::getStereo() && !Stereo::getMultiview())
@@ -581,6 +586,7 @@ namespace MWRender
                 fx::DispatchNode::SubPass subPass;
 
                 pass->prepareStateSet(subPass.mStateSet, technique->getName());
+                subPass.mCompute = pass->getType() == fx::Pass::Type::Compute;
 
                 node.mHandle = technique;
 
@@ -747,7 +753,7 @@ namespace MWRender
             if (name == mTemplates[i]->getName())
                 return mTemplates[i];
 
-        auto technique = std::make_shared<fx::Technique>(*mVFS, *mRendering.getResourceSystem()->getImageManager(), name, mWidth, mHeight, mUBO, mNormalsSupported);
+        auto technique = std::make_shared<fx::Technique>(*mVFS, *mRendering.getResourceSystem()->getImageManager(), name, mWidth, mHeight, mUBO, mNormalsSupported, mComputeSupported);
 
         technique->compile();
 
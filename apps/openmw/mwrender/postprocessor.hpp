@@ -212,6 +212,7 @@ namespace MWRender
         bool mNormals;
         bool mPrevNormals;
         bool mNormalsSupported;
+        bool mComputeSupported;
         bool mPassLights;
         bool mPrevPassLights;
         bool mUBO;
@@ -1,5 +1,7 @@
 #include "renderingmanager.hpp"
 
+#include <algorithm>
+#include <filesystem>
 #include <limits>
 #include <cstdlib>
 
@@ -33,6 +35,7 @@
 
 #include <components/settings/settings.hpp>
 
+#include <components/sceneutil/animationbatch.hpp>
 #include <components/sceneutil/depth.hpp>
 #include <components/sceneutil/visitor.hpp>
 #include <components/sceneutil/lightmanager.hpp>
@@ -46,6 +49,7 @@
 
 #include <components/terrain/terraingrid.hpp>
 #include <components/terrain/quadtreeworld.hpp>
+#include <components/terrain/diskcache.hpp>
 
 #include <components/esm3/loadcell.hpp>
 
@@ -309,6 +313,8 @@ namespace MWRender
         {
         }
 
+        const char* getTraceName() const override { return "preloadcommonassets"; }
+
         void doWork() override
         {
             try
@@ -443,6 +449,14 @@ namespace MWRender
 
         mObjects.reset(new Objects(mResourceSystem, sceneRoot));
 
+        if (Settings::Manager::getBool("batched animation", "Game"))
+        {
+            const int threads = std::max(0, Settings::Manager::getInt("batched animation threads", "Game"));
+            mAnimationBatch = new SceneUtil::AnimationBatch(static_cast<unsigned int>(threads));
+            sceneRoot->addUpdateCallback(mAnimationBatch);
+            mObjects->setAnimationBatch(mAnimationBatch);
+        }
+
         if (getenv("OPENMW_DONT_PRECOMPILE") == nullptr)
         {
             mViewer->setIncrementalCompileOperation(new osgUtil::IncrementalCompileOperation);
@@ -626,6 +640,14 @@ namespace MWRender
         return mTerrain.get();
     }
 
+    void RenderingManager::setupTerrainDiskCache(const std::string& userDataPath, std::size_t contentHash)
+    {
+        if (!Settings::Manager::getBool("disk cache", "Terrain"))
+            return;
+
+        mTerrain->setDiskCache(std::make_unique<Terrain::DiskCache>(std::filesystem::path(userDataPath) / "terrain", contentHash));
+    }
+
     void RenderingManager::preloadCommonAssets()
     {
         osg::ref_ptr<PreloadCommonAssetsWorkItem> workItem (new PreloadCommonAssetsWorkItem(mResourceSystem));
@@ -1189,6 +1211,7 @@ namespace MWRender
     {
         mPlayerAnimation = new NpcAnimation(player, player.getRefData().getBaseNode(), mResourceSystem, 0, NpcAnimation::VM_Normal,
                                                 mFirstPersonFieldOfView);
+        mPlayerAnimation->setAnimationBatch(mAnimationBatch);
 
         mCamera->setAnimation(mPlayerAnimation.get());
         mCamera->attachTo(player);
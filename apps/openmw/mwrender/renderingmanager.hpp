@@ -57,6 +57,7 @@ namespace Fallback
 
 namespace SceneUtil
 {
+    class AnimationBatch;
     class ShadowManager;
     class WorkQueue;
     class LightManager;
@@ -113,6 +114,10 @@ namespace MWRender
         SceneUtil::WorkQueue* getWorkQueue();
         Terrain::World* getTerrain();
 
+        /// Set up the terrain disk cache in \a userDataPath if it is enabled in the settings.
+        /// @param contentHash identifies the loaded content files and land textures, cached composite maps are discarded when it changes
+        void setupTerrainDiskCache(const std::string& userDataPath, std::size_t contentHash);
+
         void preloadCommonAssets();
 
         double getReferenceTime() const;
@@ -305,6 +310,7 @@ namespace MWRender
 
         osg::ref_ptr<StateUpdater> mStateUpdater;
         osg::ref_ptr<SharedUniformStateUpdater> mSharedUniformStateUpdater;
+        osg::ref_ptr<SceneUtil::AnimationBatch> mAnimationBatch;
         osg::ref_ptr<PerViewUniformStateUpdater> mPerViewUniformStateUpdater;
 
         osg::Vec4f mAmbientColor;
@@ -28,12 +28,21 @@ void RotateController::setOffset(const osg::Vec3f& offset)
 }
 
 void RotateController::operator()(osg::MatrixTransform *node, osg::NodeVisitor *nv)
+{
+    apply(node);
+    traverse(node, nv);
+}
+
+void RotateController::applyBatched(osg::Node* node, osg::NodeVisitor* nv)
+{
+    apply(static_cast<osg::MatrixTransform*>(node));
+}
+
+void RotateController::apply(osg::MatrixTransform* node)
 {
     if (!mEnabled)
-    {
-        traverse(node, nv);
         return;
-    }
+
     osg::Matrix matrix = node->getMatrix();
     osg::Quat worldOrient = getWorldOrientation(node);
     osg::Quat worldOrientInverse = worldOrient.inverse();
@@ -43,8 +52,6 @@ void RotateController::operator()(osg::MatrixTransform *node, osg::NodeVisitor *
     matrix.setTrans(matrix.getTrans() + worldOrientInverse * mOffset);
 
     node->setMatrix(matrix);
-
-    traverse(node,nv);
 }
 
 osg::Quat RotateController::getWorldOrientation(osg::Node *node)
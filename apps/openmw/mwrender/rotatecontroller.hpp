@@ -1,6 +1,7 @@
 #ifndef OPENMW_MWRENDER_ROTATECONTROLLER_H
 #define OPENMW_MWRENDER_ROTATECONTROLLER_H
 
+#include <components/sceneutil/animationbatch.hpp>
 #include <components/sceneutil/nodecallback.hpp>
 #include <osg/Quat>
 
@@ -15,7 +16,7 @@ namespace MWRender
 /// Applies a rotation in \a relativeTo's space.
 /// @note Assumes that the node being rotated has its "original" orientation set every frame by a different controller.
 /// The rotation is then applied on top of that orientation.
-class RotateController : public SceneUtil::NodeCallback<RotateController, osg::MatrixTransform*>
+class RotateController : public SceneUtil::NodeCallback<RotateController, osg::MatrixTransform*>, public SceneUtil::BatchedCallback
 {
 public:
     RotateController(osg::Node* relativeTo);
@@ -26,9 +27,13 @@ public:
 
     void operator()(osg::MatrixTransform* node, osg::NodeVisitor* nv);
 
+    void applyBatched(osg::Node* node, osg::NodeVisitor* nv) override;
+
 protected:
     osg::Quat getWorldOrientation(osg::Node* node);
 
+    void apply(osg::MatrixTransform* node);
+
     bool mEnabled;
     osg::Vec3f mOffset;
     osg::Quat mRotate;
@@ -1,5 +1,10 @@
 #include "terrainstorage.hpp"
 
+#include <cmath>
+#include <filesystem>
+
+#include <components/misc/hash.hpp>
+
 #include "../mwbase/world.hpp"
 #include "../mwbase/environment.hpp"
 #include "../mwworld/esmstore.hpp"
@@ -59,6 +64,68 @@ namespace MWRender
         maxY += 1;
     }
 
+    std::optional<std::size_t> TerrainStorage::getFileHash(const std::string& fileName)
+    {
+        std::lock_guard<std::mutex> lock(mFileHashesMutex);
+        auto found = mFileHashes.find(fileName);
+        if (found != mFileHashes.end())
+            return found->second;
+
+        // Identify the content file by its name, size and modification time instead of hashing its contents,
+        // the terrain only needs to notice edited or replaced files
+        std::optional<std::size_t> result;
+        std::error_code ec;
+        const std::filesystem::path path(fileName);
+        const auto fileSize = std::filesystem::file_size(path, ec);
+        if (!ec)
+        {
+            const auto writeTime = std::filesystem::last_write_time(path, ec);
+            if (!ec)
+            {
+                std::size_t hash = std::hash<std::string>()(path.filename().string());
+                Misc::hashCombine(hash, fileSize);
+                Misc::hashCombine(hash, writeTime.time_since_epoch().count());
+                result = hash;
+            }
+        }
+        mFileHashes.emplace(fileName, result);
+        return result;
+    }
+
+    bool TerrainStorage::getLandHash(float size, const osg::Vec2f& center, std::size_t& hash)
+    {
+        const MWWorld::ESMStore &esmStore =
+            MWBase::Environment::get().getWorld()->getStore();
+
+        // Vertex normals and colours at the chunk border are taken from the neighbouring cells
+        const int startX = static_cast<int>(std::floor(center.x() - size / 2.f)) - 1;
+        const int startY = static_cast<int>(std::floor(center.y() - size / 2.f)) - 1;
+        const int endX = static_cast<int>(std::ceil(center.x() + size / 2.f)) + 1;
+        const int endY = static_cast<int>(std::ceil(center.y() + size / 2.f)) + 1;
+
+        hash = 0;
+        for (int cellY = startY; cellY < endY; ++cellY)
+        {
+            for (int cellX = startX; cellX < endX; ++cellX)
+            {
+                const ESM::Land* land = esmStore.get<ESM::Land>().search(cellX, cellY);
+                if (!land)
+                {
+                    Misc::hashCombine(hash, 0);
+                    continue;
+                }
+
+                const std::optional<std::size_t> fileHash = getFileHash(land->mContext.filename);
+                if (!fileHash)
+                    return false;
+                Misc::hashCombine(hash, *fileHash);
+                Misc::hashCombine(hash, land->mContext.filePos);
+                Misc::hashCombine(hash, land->mDataTypes);
+            }
+        }
+        return true;
+    }
+
     LandManager *TerrainStorage::getLandManager() const
     {
         return mLandManager.get();
@@ -1,7 +1,10 @@
 #ifndef MWRENDER_TERRAINSTORAGE_H
 #define MWRENDER_TERRAINSTORAGE_H
 
+#include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
 
 #include <components/esm3terrain/storage.hpp>
 
@@ -28,11 +31,18 @@ namespace MWRender
         /// Get bounds of the whole terrain in cell units
         void getBounds(float& minX, float& maxX, float& minY, float& maxY) override;
 
+        bool getLandHash(float size, const osg::Vec2f& center, std::size_t& hash) override;
+
         LandManager* getLandManager() const;
 
     private:
+       std::optional<std::size_t> getFileHash(const std::string& fileName);
+
        std::unique_ptr<LandManager> mLandManager;
 
+       std::mutex mFileHashesMutex;
+       std::map<std::string, std::optional<std::size_t>> mFileHashes;
+
        Resource::ResourceSystem* mResourceSystem;
     };
 
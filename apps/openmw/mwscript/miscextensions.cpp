@@ -8,6 +8,7 @@
 #include <components/compiler/locals.hpp>
 
 #include <components/debug/debuglog.hpp>
+#include <components/debug/trace.hpp>
 
 #include <components/interpreter/interpreter.hpp>
 #include <components/interpreter/runtime.hpp>
@@ -1617,6 +1618,29 @@ namespace MWScript
                 }
         };
 
+        class OpWriteTrace : public Interpreter::Opcode0
+        {
+            public:
+
+                void execute (Interpreter::Runtime& runtime) override
+                {
+                    if (!Debug::isTraceEnabled())
+                    {
+                        runtime.getContext().report("Tracing is disabled, set OPENMW_TRACE_FILE to enable it");
+                        return;
+                    }
+                    try
+                    {
+                        Debug::writeTrace();
+                        runtime.getContext().report("Trace is written to " + Debug::getTracePath());
+                    }
+                    catch (const std::exception& e)
+                    {
+                        runtime.getContext().report(e.what());
+                    }
+                }
+        };
+
         void installOpcodes (Interpreter::Interpreter& interpreter)
         {
             interpreter.installSegment5<OpMenuMode>(Compiler::Misc::opcodeMenuMode);
@@ -1738,6 +1762,7 @@ namespace MWScript
             interpreter.installSegment5<OpToggleRecastMesh>(Compiler::Misc::opcodeToggleRecastMesh);
             interpreter.installSegment5<OpHelp>(Compiler::Misc::opcodeHelp);
             interpreter.installSegment5<OpReloadLua>(Compiler::Misc::opcodeReloadLua);
+            interpreter.installSegment5<OpWriteTrace>(Compiler::Misc::opcodeWriteTrace);
         }
     }
 }
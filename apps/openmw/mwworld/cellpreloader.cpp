@@ -1,8 +1,11 @@
 #include "cellpreloader.hpp"
 
+#include <algorithm>
 #include <atomic>
 #include <limits>
 
+#include <osg/Stats>
+
 #include <components/debug/debuglog.hpp>
 #include <components/resource/scenemanager.hpp>
 #include <components/resource/resourcesystem.hpp>
@@ -65,27 +68,33 @@ namespace MWWorld
         std::vector<std::string>& mOut;
     };
 
-    /// Worker thread item: preload models in a cell.
-    class PreloadItem : public SceneUtil::WorkItem
+    namespace
+    {
+        std::vector<std::string> listModels(MWWorld::CellStore& cell)
+        {
+            std::vector<std::string> models;
+            ListModelsVisitor visitor (models);
+            cell.forEach(visitor);
+
+            for (std::string& model : models)
+                Misc::StringUtils::lowerCaseInPlace(model);
+            models.erase(std::remove(models.begin(), models.end(), std::string()), models.end());
+            std::sort(models.begin(), models.end());
+            models.erase(std::unique(models.begin(), models.end()), models.end());
+            return models;
+        }
+    }
+
+    /// Worker thread item: preload a single asset. Shared by all preloaded cells referencing the asset.
+    class PreloadAssetItem : public SceneUtil::WorkItem
     {
     public:
-        /// Constructor to be called from the main thread.
-        PreloadItem(MWWorld::CellStore* cell, Resource::SceneManager* sceneManager, Resource::BulletShapeManager* bulletShapeManager, Resource::KeyframeManager* keyframeManager, Terrain::World* terrain, MWRender::LandManager* landManager, bool preloadInstances)
-            : mIsExterior(cell->getCell()->isExterior())
-            , mX(cell->getCell()->getGridX())
-            , mY(cell->getCell()->getGridY())
-            , mSceneManager(sceneManager)
-            , mBulletShapeManager(bulletShapeManager)
-            , mKeyframeManager(keyframeManager)
-            , mTerrain(terrain)
-            , mLandManager(landManager)
-            , mPreloadInstances(preloadInstances)
+        PreloadAssetItem(const std::string& key)
+            : mKey(key)
+            , mPriority(std::numeric_limits<float>::max())
+            , mNumUsers(0)
             , mAbort(false)
         {
-            mTerrainView = mTerrain->createView();
-
-            ListModelsVisitor visitor (mMeshes);
-            cell->forEach(visitor);
         }
 
         void abort() override
@@ -93,79 +102,117 @@ namespace MWWorld
             mAbort = true;
         }
 
-        /// Preload work to be called from the worker thread.
+        /// Key in the model item map, empty for items owned by a single cell.
+        const std::string mKey;
+
+        // Accessed by the main thread only
+        float mPriority;
+        unsigned int mNumUsers;
+
+    protected:
+        std::atomic<bool> mAbort;
+
+        // keep a ref to the loaded objects to make sure they stay loaded as long as a cell using this item is in the preloaded state
+        std::vector<osg::ref_ptr<const osg::Object>> mPreloadedObjects;
+    };
+
+    /// Worker thread item: preload the rendering mesh, animation and collision shape of a model.
+    class ModelPreloadItem : public PreloadAssetItem
+    {
+    public:
+        ModelPreloadItem(const std::string& mesh, Resource::SceneManager* sceneManager, Resource::BulletShapeManager* bulletShapeManager, Resource::KeyframeManager* keyframeManager, bool preloadInstances)
+            : PreloadAssetItem(mesh)
+            , mSceneManager(sceneManager)
+            , mBulletShapeManager(bulletShapeManager)
+            , mKeyframeManager(keyframeManager)
+            , mPreloadInstances(preloadInstances)
+        {
+        }
+
+        const char* getTraceName() const override { return "preloadasset"; }
+
         void doWork() override
         {
-            if (mIsExterior)
-            {
-                try
-                {
-                    mTerrain->cacheCell(mTerrainView.get(), mX, mY);
-                    mPreloadedObjects.insert(mLandManager->getLand(mX, mY));
-                }
-                catch(std::exception&)
-                {
-                }
-            }
+            if (mAbort)
+                return;
 
-            for (std::string& mesh: mMeshes)
+            try
             {
-                if (mAbort)
-                    break;
+                std::string mesh = Misc::ResourceHelpers::correctActorModelPath(mKey, mSceneManager->getVFS());
 
-                try
+                size_t slashpos = mesh.find_last_of("/\\");
+                if (slashpos != std::string::npos && slashpos != mesh.size()-1)
                 {
-                    mesh = Misc::ResourceHelpers::correctActorModelPath(mesh, mSceneManager->getVFS());
-
-                    size_t slashpos = mesh.find_last_of("/\\");
-                    if (slashpos != std::string::npos && slashpos != mesh.size()-1)
+                    Misc::StringUtils::lowerCaseInPlace(mesh);
+                    if (mesh[slashpos+1] == 'x')
                     {
-                        Misc::StringUtils::lowerCaseInPlace(mesh);
-                        if (mesh[slashpos+1] == 'x')
+                        std::string kfname = mesh;
+                        if(kfname.size() > 4 && kfname.compare(kfname.size()-4, 4, ".nif") == 0)
                         {
-                            std::string kfname = mesh;
-                            if(kfname.size() > 4 && kfname.compare(kfname.size()-4, 4, ".nif") == 0)
-                            {
-                                kfname.replace(kfname.size()-4, 4, ".kf");
-                                if (mSceneManager->getVFS()->exists(kfname))
-                                    mPreloadedObjects.insert(mKeyframeManager->get(kfname));
-                            }
+                            kfname.replace(kfname.size()-4, 4, ".kf");
+                            if (mSceneManager->getVFS()->exists(kfname))
+                                mPreloadedObjects.emplace_back(mKeyframeManager->get(kfname));
                         }
                     }
-                    mPreloadedObjects.insert(mSceneManager->getTemplate(mesh));
-                    if (mPreloadInstances)
-                        mPreloadedObjects.insert(mBulletShapeManager->cacheInstance(mesh));
-                    else
-                        mPreloadedObjects.insert(mBulletShapeManager->getShape(mesh));
-
-                }
-                catch (std::exception&)
-                {
-                    // ignore error for now, would spam the log too much
-                    // error will be shown when visiting the cell
                 }
+                mPreloadedObjects.emplace_back(mSceneManager->getTemplate(mesh));
+                if (mPreloadInstances)
+                    mPreloadedObjects.emplace_back(mBulletShapeManager->cacheInstance(mesh));
+                else
+                    mPreloadedObjects.emplace_back(mBulletShapeManager->getShape(mesh));
+            }
+            catch (std::exception&)
+            {
+                // ignore error for now, would spam the log too much
+                // error will be shown when visiting the cell
             }
         }
 
     private:
-        typedef std::vector<std::string> MeshList;
-        bool mIsExterior;
-        int mX;
-        int mY;
-        MeshList mMeshes;
         Resource::SceneManager* mSceneManager;
         Resource::BulletShapeManager* mBulletShapeManager;
         Resource::KeyframeManager* mKeyframeManager;
-        Terrain::World* mTerrain;
-        MWRender::LandManager* mLandManager;
         bool mPreloadInstances;
+    };
 
-        std::atomic<bool> mAbort;
+    /// Worker thread item: preload the terrain and land data of an exterior cell.
+    class TerrainCellPreloadItem : public PreloadAssetItem
+    {
+    public:
+        /// Constructor to be called from the main thread.
+        TerrainCellPreloadItem(int x, int y, Terrain::World* terrain, MWRender::LandManager* landManager)
+            : PreloadAssetItem(std::string())
+            , mX(x)
+            , mY(y)
+            , mTerrain(terrain)
+            , mLandManager(landManager)
+        {
+            mTerrainView = mTerrain->createView();
+        }
 
-        osg::ref_ptr<Terrain::View> mTerrainView;
+        const char* getTraceName() const override { return "terraincellpreload"; }
+
+        void doWork() override
+        {
+            if (mAbort)
+                return;
 
-        // keep a ref to the loaded objects to make sure it stays loaded as long as this cell is in the preloaded state
-        std::set<osg::ref_ptr<const osg::Object> > mPreloadedObjects;
+            try
+            {
+                mTerrain->cacheCell(mTerrainView.get(), mX, mY);
+                mPreloadedObjects.emplace_back(mLandManager->getLand(mX, mY));
+            }
+            catch(std::exception&)
+            {
+            }
+        }
+
+    private:
+        int mX;
+        int mY;
+        Terrain::World* mTerrain;
+        MWRender::LandManager* mLandManager;
+        osg::ref_ptr<Terrain::View> mTerrainView;
     };
 
     class TerrainPreloadItem : public SceneUtil::WorkItem
@@ -179,6 +226,8 @@ namespace MWWorld
         {
         }
 
+        const char* getTraceName() const override { return "terrainpreload"; }
+
         void doWork() override
         {
             for (unsigned int i=0; i<mTerrainViews.size() && i<mPreloadPositions.size() && !mAbort; ++i)
@@ -217,6 +266,8 @@ namespace MWWorld
         {
         }
 
+        const char* getTraceName() const override { return "updatecache"; }
+
         void doWork() override
         {
             mResourceSystem->updateCache(mReferenceTime);
@@ -237,6 +288,10 @@ namespace MWWorld
         , mMaxCacheSize(0)
         , mPreloadInstances(true)
         , mLastResourceCacheUpdate(0.0)
+        , mPrioritiesChanged(false)
+        , mNumHits(0)
+        , mNumMissedCells(0)
+        , mNumLate(0)
         , mLoadedTerrainTimestamp(0.0)
     {
     }
@@ -256,16 +311,19 @@ namespace MWWorld
             mUpdateCacheItem = nullptr;
         }
 
-        for (PreloadMap::iterator it = mPreloadCells.begin(); it != mPreloadCells.end();++it)
-            it->second.mWorkItem->abort();
+        for (const osg::ref_ptr<PreloadAssetItem>& item : mDispatchedItems)
+            item->abort();
 
-        for (PreloadMap::iterator it = mPreloadCells.begin(); it != mPreloadCells.end();++it)
-            it->second.mWorkItem->waitTillDone();
+        for (const osg::ref_ptr<PreloadAssetItem>& item : mDispatchedItems)
+            item->waitTillDone();
 
+        mDispatchedItems.clear();
+        mPendingItems.clear();
+        mModelItems.clear();
         mPreloadCells.clear();
     }
 
-    void CellPreloader::preload(CellStore *cell, double timestamp)
+    void CellPreloader::preload(CellStore *cell, double timestamp, float priority)
     {
         if (!mWorkQueue)
         {
@@ -281,8 +339,16 @@ namespace MWWorld
         PreloadMap::iterator found = mPreloadCells.find(cell);
         if (found != mPreloadCells.end())
         {
-            // already preloaded, nothing to do other than updating the timestamp
+            // already preloaded, nothing to do other than updating the timestamp and priority
+            // a cell may be requested several times per frame, the most urgent request wins
+            if (found->second.mTimeStamp == timestamp)
+                priority = std::min(priority, found->second.mPriority);
             found->second.mTimeStamp = timestamp;
+            if (found->second.mPriority != priority)
+            {
+                found->second.mPriority = priority;
+                mPrioritiesChanged = true;
+            }
             return;
         }
 
@@ -303,17 +369,37 @@ namespace MWWorld
 
             if (oldestTimestamp + threshold < timestamp)
             {
-                oldestCell->second.mWorkItem->abort();
+                releaseItems(oldestCell->second);
                 mPreloadCells.erase(oldestCell);
             }
             else
                 return;
         }
 
-        osg::ref_ptr<PreloadItem> item (new PreloadItem(cell, mResourceSystem->getSceneManager(), mBulletShapeManager, mResourceSystem->getKeyframeManager(), mTerrain, mLandManager, mPreloadInstances));
-        mWorkQueue->addWorkItem(item);
+        PreloadEntry& entry = mPreloadCells[cell];
+        entry = PreloadEntry(timestamp, priority);
 
-        mPreloadCells[cell] = PreloadEntry(timestamp, item);
+        const auto addItem = [&] (const osg::ref_ptr<PreloadAssetItem>& item)
+        {
+            if (item->mNumUsers++ == 0)
+                mPendingItems.push_back(item);
+            item->mPriority = std::min(item->mPriority, priority);
+            entry.mItems.push_back(item);
+        };
+
+        if (cell->getCell()->isExterior())
+            addItem(new TerrainCellPreloadItem(cell->getCell()->getGridX(), cell->getCell()->getGridY(), mTerrain, mLandManager));
+
+        for (const std::string& model : listModels(*cell))
+        {
+            osg::ref_ptr<PreloadAssetItem>& item = mModelItems[model];
+            if (!item)
+                item = new ModelPreloadItem(model, mResourceSystem->getSceneManager(), mBulletShapeManager,
+                                            mResourceSystem->getKeyframeManager(), mPreloadInstances);
+            addItem(item);
+        }
+
+        dispatchItems();
     }
 
     void CellPreloader::notifyLoaded(CellStore *cell)
@@ -321,26 +407,26 @@ namespace MWWorld
         PreloadMap::iterator found = mPreloadCells.find(cell);
         if (found != mPreloadCells.end())
         {
-            if (found->second.mWorkItem)
+            for (const osg::ref_ptr<PreloadAssetItem>& item : found->second.mItems)
             {
-                found->second.mWorkItem->abort();
-                found->second.mWorkItem = nullptr;
+                if (item->isDone())
+                    ++mNumHits;
+                else
+                    ++mNumLate;
             }
 
+            releaseItems(found->second);
             mPreloadCells.erase(found);
         }
+        else
+            ++mNumMissedCells;
     }
 
     void CellPreloader::clear()
     {
         for (PreloadMap::iterator it = mPreloadCells.begin(); it != mPreloadCells.end();)
         {
-            if (it->second.mWorkItem)
-            {
-                it->second.mWorkItem->abort();
-                it->second.mWorkItem = nullptr;
-            }
-
+            releaseItems(it->second);
             mPreloadCells.erase(it++);
         }
     }
@@ -351,17 +437,15 @@ namespace MWWorld
         {
             if (mPreloadCells.size() >= mMinCacheSize && it->second.mTimeStamp < timestamp - mExpiryDelay)
             {
-                if (it->second.mWorkItem)
-                {
-                    it->second.mWorkItem->abort();
-                    it->second.mWorkItem = nullptr;
-                }
+                releaseItems(it->second);
                 mPreloadCells.erase(it++);
             }
             else
                 ++it;
         }
 
+        dispatchItems();
+
         if (timestamp - mLastResourceCacheUpdate > 1.0 && (!mUpdateCacheItem || mUpdateCacheItem->isDone()))
         {
             // the resource cache is cleared from the worker thread so that we're not holding up the main thread with delete operations
@@ -377,6 +461,59 @@ namespace MWWorld
         }
     }
 
+    void CellPreloader::releaseItems(PreloadEntry& entry)
+    {
+        for (const osg::ref_ptr<PreloadAssetItem>& item : entry.mItems)
+        {
+            if (--item->mNumUsers > 0)
+                continue;
+            item->abort();
+            if (!item->mKey.empty())
+                mModelItems.erase(item->mKey);
+        }
+        entry.mItems.clear();
+        mPrioritiesChanged = true;
+    }
+
+    void CellPreloader::dispatchItems()
+    {
+        const auto isDone = [] (const osg::ref_ptr<PreloadAssetItem>& item) { return item->isDone(); };
+        mDispatchedItems.erase(std::remove_if(mDispatchedItems.begin(), mDispatchedItems.end(), isDone), mDispatchedItems.end());
+
+        const auto isUnused = [] (const osg::ref_ptr<PreloadAssetItem>& item) { return item->mNumUsers == 0; };
+        mPendingItems.erase(std::remove_if(mPendingItems.begin(), mPendingItems.end(), isUnused), mPendingItems.end());
+
+        // Only keep a few jobs per worker thread in the work queue, so that the remaining ones are started
+        // in order of the latest priorities instead of the order they were requested in.
+        const std::size_t maxDispatched = std::max<std::size_t>(mWorkQueue->getNumThreads(), 1) * 4;
+        if (mPendingItems.empty() || mDispatchedItems.size() >= maxDispatched)
+            return;
+
+        if (mPrioritiesChanged)
+        {
+            for (const osg::ref_ptr<PreloadAssetItem>& item : mPendingItems)
+                item->mPriority = std::numeric_limits<float>::max();
+            for (const auto& [cell, entry] : mPreloadCells)
+                for (const osg::ref_ptr<PreloadAssetItem>& item : entry.mItems)
+                    item->mPriority = std::min(item->mPriority, entry.mPriority);
+            mPrioritiesChanged = false;
+        }
+
+        const std::size_t count = std::min(maxDispatched - mDispatchedItems.size(), mPendingItems.size());
+        const auto byPriority = [] (const osg::ref_ptr<PreloadAssetItem>& lhs, const osg::ref_ptr<PreloadAssetItem>& rhs)
+        {
+            return lhs->mPriority < rhs->mPriority;
+        };
+        std::partial_sort(mPendingItems.begin(), mPendingItems.begin() + count, mPendingItems.end(), byPriority);
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            mWorkQueue->addWorkItem(mPendingItems[i]);
+            mDispatchedItems.push_back(std::move(mPendingItems[i]));
+        }
+        mPendingItems.erase(mPendingItems.begin(), mPendingItems.begin() + count);
+    }
+
     void CellPreloader::setExpiryDelay(double expiryDelay)
     {
         mExpiryDelay = expiryDelay;
@@ -469,4 +606,13 @@ namespace MWWorld
         return mLoadedTerrainTimestamp + mResourceSystem->getSceneManager()->getExpiryDelay() > referenceTime && contains(mLoadedTerrainPositions, std::array {position}, ESM::Land::REAL_SIZE);
     }
 
+    void CellPreloader::reportStats(unsigned int frameNumber, osg::Stats& stats) const
+    {
+        stats.setAttribute(frameNumber, "Preload Cells", mPreloadCells.size());
+        stats.setAttribute(frameNumber, "Preload Jobs", mPendingItems.size() + mDispatchedItems.size());
+        stats.setAttribute(frameNumber, "Preload Hits", mNumHits);
+        stats.setAttribute(frameNumber, "Preload Missed Cells", mNumMissedCells);
+        stats.setAttribute(frameNumber, "Preload Late", mNumLate);
+    }
+
 }
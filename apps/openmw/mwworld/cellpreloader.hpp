@@ -2,11 +2,18 @@
 #define OPENMW_MWWORLD_CELLPRELOADER_H
 
 #include <map>
+#include <string>
+#include <vector>
 #include <osg/ref_ptr>
 #include <osg/Vec3f>
 #include <osg/Vec4i>
 #include <components/sceneutil/workqueue.hpp>
 
+namespace osg
+{
+    class Stats;
+}
+
 namespace Resource
 {
     class ResourceSystem;
@@ -33,6 +40,7 @@ namespace MWWorld
 {
     class CellStore;
     class TerrainPreloadItem;
+    class PreloadAssetItem;
 
     class CellPreloader
     {
@@ -40,9 +48,11 @@ namespace MWWorld
         CellPreloader(Resource::ResourceSystem* resourceSystem, Resource::BulletShapeManager* bulletShapeManager, Terrain::World* terrain, MWRender::LandManager* landManager);
         ~CellPreloader();
 
-        /// Ask a background thread to preload rendering meshes and collision shapes for objects in this cell.
+        /// Ask the background threads to preload rendering meshes and collision shapes for objects in this cell.
+        /// Every asset is preloaded by a separate job shared between all preloaded cells referencing it.
+        /// @param priority Jobs of cells with lower values are started first, usually the distance to the player.
         /// @note The cell itself must be in State_Loaded or State_Preloaded.
-        void preload(MWWorld::CellStore* cell, double timestamp);
+        void preload(MWWorld::CellStore* cell, double timestamp, float priority = 0.f);
 
         void notifyLoaded(MWWorld::CellStore* cell);
 
@@ -74,6 +84,8 @@ namespace MWWorld
         void abortTerrainPreloadExcept(const PositionCellGrid *exceptPos);
         bool isTerrainLoaded(const CellPreloader::PositionCellGrid &position, double referenceTime) const;
 
+        void reportStats(unsigned int frameNumber, osg::Stats& stats) const;
+
     private:
         Resource::ResourceSystem* mResourceSystem;
         Resource::BulletShapeManager* mBulletShapeManager;
@@ -89,24 +101,43 @@ namespace MWWorld
 
         struct PreloadEntry
         {
-            PreloadEntry(double timestamp, osg::ref_ptr<SceneUtil::WorkItem> workItem)
+            PreloadEntry(double timestamp, float priority)
                 : mTimeStamp(timestamp)
-                , mWorkItem(workItem)
+                , mPriority(priority)
             {
             }
             PreloadEntry()
                 : mTimeStamp(0.0)
+                , mPriority(0.f)
             {
             }
 
             double mTimeStamp;
-            osg::ref_ptr<SceneUtil::WorkItem> mWorkItem;
+            float mPriority;
+            std::vector<osg::ref_ptr<PreloadAssetItem>> mItems;
         };
         typedef std::map<const MWWorld::CellStore*, PreloadEntry> PreloadMap;
 
         // Cells that are currently being preloaded, or have already finished preloading
         PreloadMap mPreloadCells;
 
+        // Model jobs shared between the preloaded cells, keyed by lower case model path
+        std::map<std::string, osg::ref_ptr<PreloadAssetItem>> mModelItems;
+
+        // Jobs waiting to be added to the work queue, dispatched in order of priority
+        std::vector<osg::ref_ptr<PreloadAssetItem>> mPendingItems;
+        // Jobs added to the work queue that may not be done yet
+        std::vector<osg::ref_ptr<PreloadAssetItem>> mDispatchedItems;
+        bool mPrioritiesChanged;
+
+        std::size_t mNumHits;
+        // Cells loaded without being preloaded, their assets aren't listed to not delay the loading
+        std::size_t mNumMissedCells;
+        std::size_t mNumLate;
+
+        void releaseItems(PreloadEntry& entry);
+        void dispatchItems();
+
         std::vector<osg::ref_ptr<Terrain::View> > mTerrainViews;
         std::vector<PositionCellGrid> mTerrainPreloadPositions;
         osg::ref_ptr<TerrainPreloadItem> mTerrainPreloadItem;
@@ -978,6 +978,8 @@ namespace MWWorld
         {
         }
 
+        const char* getTraceName() const override { return "preloadmesh"; }
+
         void doWork() override
         {
             if (mAborted)
@@ -1073,14 +1075,15 @@ namespace MWWorld
             {
                 try
                 {
+                    const float priority = std::sqrt(sqrDistToPlayer);
                     if (!door.getCellRef().getDestCell().empty())
-                        preloadCell(mWorld.getInterior(door.getCellRef().getDestCell()));
+                        preloadCell(mWorld.getInterior(door.getCellRef().getDestCell()), false, priority);
                     else
                     {
                         osg::Vec3f pos = door.getCellRef().getDoorDest().asVec3();
                         int x,y;
                         mWorld.positionToIndex (pos.x(), pos.y(), x, y);
-                        preloadCell(mWorld.getExterior(x,y), true);
+                        preloadCell(mWorld.getExterior(x,y), true, priority);
                         exteriorPositions.emplace_back(pos, gridCenterToBounds(getNewGridCenter(pos)));
                     }
                 }
@@ -1121,12 +1124,12 @@ namespace MWWorld
                 float loadDist = Constants::CellSizeInUnits / 2 + Constants::CellSizeInUnits - mCellLoadingThreshold + mPreloadDistance;
 
                 if (dist < loadDist)
-                    preloadCell(mWorld.getExterior(cellX+dx, cellY+dy));
+                    preloadCell(mWorld.getExterior(cellX+dx, cellY+dy), false, dist);
             }
         }
     }
 
-    void Scene::preloadCell(CellStore *cell, bool preloadSurrounding)
+    void Scene::preloadCell(CellStore *cell, bool preloadSurrounding, float priority)
     {
         if (preloadSurrounding && cell->isExterior())
         {
@@ -1137,14 +1140,15 @@ namespace MWWorld
             {
                 for (int dy = -mHalfGridSize; dy <= mHalfGridSize; ++dy)
                 {
-                    mPreloader->preload(mWorld.getExterior(x+dx, y+dy), mRendering.getReferenceTime());
+                    const float distance = std::max(std::abs(dx), std::abs(dy)) * Constants::CellSizeInUnits;
+                    mPreloader->preload(mWorld.getExterior(x+dx, y+dy), mRendering.getReferenceTime(), priority + distance);
                     if (++numpreloaded >= mPreloader->getMaxCacheSize())
                         break;
                 }
             }
         }
         else
-            mPreloader->preload(cell, mRendering.getReferenceTime());
+            mPreloader->preload(cell, mRendering.getReferenceTime(), priority);
     }
 
     void Scene::preloadTerrain(const osg::Vec3f &pos, bool sync)
@@ -1209,18 +1213,25 @@ namespace MWWorld
             cellStore->forEachType<ESM::Creature>(listVisitor);
         }
 
+        // travelling requires a conversation first, so these are less urgent than anything else in range
+        const float priority = mPreloadDistance;
         for (ESM::Transport::Dest& dest : listVisitor.mList)
         {
             if (!dest.mCellName.empty())
-                preloadCell(mWorld.getInterior(dest.mCellName));
+                preloadCell(mWorld.getInterior(dest.mCellName), false, priority);
             else
             {
                 osg::Vec3f pos = dest.mPos.asVec3();
                 int x,y;
                 mWorld.positionToIndex( pos.x(), pos.y(), x, y);
-                preloadCell(mWorld.getExterior(x,y), true);
+                preloadCell(mWorld.getExterior(x,y), true, priority);
                 exteriorPositions.emplace_back(pos, gridCenterToBounds(getNewGridCenter(pos)));
             }
         }
     }
+
+    void Scene::reportStats(unsigned int frameNumber, osg::Stats& stats) const
+    {
+        mPreloader->reportStats(frameNumber, stats);
+    }
 }
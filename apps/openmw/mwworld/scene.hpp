@@ -19,6 +19,7 @@
 namespace osg
 {
     class Vec3f;
+    class Stats;
 }
 
 namespace ESM
@@ -138,7 +139,8 @@ namespace MWWorld
 
             ~Scene();
 
-            void preloadCell(MWWorld::CellStore* cell, bool preloadSurrounding=false);
+            /// @param priority Cells with lower values are preloaded first, usually the distance to the player.
+            void preloadCell(MWWorld::CellStore* cell, bool preloadSurrounding=false, float priority=0.f);
             void preloadTerrain(const osg::Vec3f& pos, bool sync=false);
             void reloadTerrain();
 
@@ -188,6 +190,8 @@ namespace MWWorld
 
             void testExteriorCells();
             void testInteriorCells();
+
+            void reportStats(unsigned int frameNumber, osg::Stats& stats) const;
     };
 }
 
@@ -1002,6 +1002,10 @@ namespace MWWorld
         // TODO: if we require this behaviour, maybe we should move it to the place that requires it
         std::sort(mShared.begin(), mShared.end(), [](const ESM::Dialogue* l, const ESM::Dialogue* r) -> bool { return l->mId < r->mId; });
 
+        mInfoIndex.clear();
+        for (const ESM::Dialogue* dial : mShared)
+            mInfoIndex.emplace(dial, MWDialogue::InfoIndex(*dial));
+
         mKeywordSearchModFlag = true;
     }
 
@@ -1056,6 +1060,7 @@ namespace MWWorld
         }
         else
         {
+            mInfoIndex.erase(&found->second);
             found->second.loadData(esm, isDeleted);
             dialogue.mId = found->second.mId;
         }
@@ -1067,8 +1072,13 @@ namespace MWWorld
 
     bool Store<ESM::Dialogue>::eraseStatic(const std::string &id)
     {
-        if (mStatic.erase(id))
+        const auto it = mStatic.find(id);
+        if (it != mStatic.end())
+        {
+            mInfoIndex.erase(&it->second);
+            mStatic.erase(it);
             mKeywordSearchModFlag = true;
+        }
 
         return true;
     }
@@ -1100,6 +1110,14 @@ namespace MWWorld
 
         return mKeywordSearch;
     }
+
+    const MWDialogue::InfoIndex* Store<ESM::Dialogue>::getInfoIndex(const ESM::Dialogue& dialogue) const
+    {
+        const auto it = mInfoIndex.find(&dialogue);
+        if (it == mInfoIndex.end())
+            return nullptr;
+        return &it->second;
+    }
 }
 
 template class MWWorld::Store<ESM::Activator>;
@@ -12,6 +12,7 @@
 #include <components/misc/stringops.hpp>
 #include <components/misc/rng.hpp>
 
+#include "../mwdialogue/infoindex.hpp"
 #include "../mwdialogue/keywordsearch.hpp"
 
 namespace ESM
@@ -463,6 +464,8 @@ namespace MWWorld
         mutable bool mKeywordSearchModFlag;
         mutable MWDialogue::KeywordSearch<std::string, int /*unused*/> mKeywordSearch;
 
+        std::unordered_map<const ESM::Dialogue*, MWDialogue::InfoIndex> mInfoIndex;
+
     public:
         Store();
 
@@ -485,6 +488,10 @@ namespace MWWorld
         void listIdentifier(std::vector<std::string> &list) const override;
 
         const MWDialogue::KeywordSearch<std::string, int>& getDialogIdKeywordSearch() const;
+
+        /// @return the index of the infos of the dialogue, or nullptr if the dialogue is not part of the store
+        ///     or was modified since the last setUp.
+        const MWDialogue::InfoIndex* getInfoIndex(const ESM::Dialogue& dialogue) const;
     };
 
 } //end namespace
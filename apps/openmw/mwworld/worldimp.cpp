@@ -1,5 +1,7 @@
 #include "worldimp.hpp"
 
+#include <filesystem>
+
 #include <osg/Group>
 #include <osg/ComputeBoundsVisitor>
 #include <osg/Timer>
@@ -21,9 +23,12 @@
 #include <components/misc/resourcehelpers.hpp>
 #include <components/misc/rng.hpp>
 #include <components/misc/convert.hpp>
+#include <components/misc/hash.hpp>
 
 #include <components/files/collections.hpp>
 
+#include <components/vfs/manager.hpp>
+
 #include <components/resource/bulletshape.hpp>
 #include <components/resource/resourcesystem.hpp>
 
@@ -198,6 +203,7 @@ namespace MWWorld
         }
 
         mRendering.reset(new MWRender::RenderingManager(viewer, rootNode, resourceSystem, workQueue, resourcePath, *mNavigator, mGroundcoverStore));
+        mRendering->setupTerrainDiskCache(userDataPath, getContentHash());
         mProjectileManager.reset(new ProjectileManager(mRendering->getLightRoot()->asGroup(), resourceSystem, mRendering.get(), mPhysics.get()));
         mRendering->preloadCommonAssets();
 
@@ -206,6 +212,65 @@ namespace MWWorld
         mWorldScene.reset(new Scene(*this, *mRendering.get(), mPhysics.get(), *mNavigator));
     }
 
+    std::size_t World::getContentHash() const
+    {
+        std::size_t hash = 0;
+        for (const ESM::ESMReader& reader : mEsm)
+        {
+            const std::filesystem::path path(reader.getName());
+            Misc::hashCombine(hash, path.filename().string());
+            Misc::hashCombine(hash, reader.getFileSize());
+            std::error_code ec;
+            const auto writeTime = std::filesystem::last_write_time(path, ec);
+            if (!ec)
+                Misc::hashCombine(hash, writeTime.time_since_epoch().count());
+        }
+
+        // Composite maps are rendered from the land textures, which can be replaced by files in other data
+        // directories or archives, or by their specular maps depending on the settings.
+        const bool useSpecularMaps = Settings::Manager::getBool("auto use terrain specular maps", "Shaders");
+        const std::string specularMapPattern = Settings::Manager::getString("terrain specular map pattern", "Shaders");
+        Misc::hashCombine(hash, useSpecularMaps);
+        Misc::hashCombine(hash, specularMapPattern);
+        Misc::hashCombine(hash, Settings::Manager::getBool("auto use terrain normal maps", "Shaders"));
+        Misc::hashCombine(hash, Settings::Manager::getString("normal map pattern", "Shaders"));
+        Misc::hashCombine(hash, Settings::Manager::getString("normal height map pattern", "Shaders"));
+
+        const VFS::Manager* vfs = mResourceSystem->getVFS();
+        const auto hashTexture = [&] (const std::string& name)
+        {
+            if (!vfs->exists(name))
+                return;
+            Misc::hashCombine(hash, vfs->normalizeFilename(name));
+            Misc::hashCombine(hash, vfs->getArchive(name));
+            std::error_code ec;
+            const std::filesystem::path path(vfs->getAbsoluteFileName(name));
+            const auto size = std::filesystem::file_size(path, ec);
+            if (!ec)
+                Misc::hashCombine(hash, size);
+            const auto writeTime = std::filesystem::last_write_time(path, ec);
+            if (!ec)
+                Misc::hashCombine(hash, writeTime.time_since_epoch().count());
+        };
+
+        std::vector<std::string> textures {"textures\\_land_default.dds"};
+        const MWWorld::Store<ESM::LandTexture>& landTextures = mStore.get<ESM::LandTexture>();
+        for (std::size_t plugin = 0; plugin < landTextures.getSize(); ++plugin)
+            for (auto it = landTextures.begin(plugin); it != landTextures.end(plugin); ++it)
+                textures.push_back(Misc::ResourceHelpers::correctTexturePath(it->mTexture, vfs));
+        for (std::string& texture : textures)
+        {
+            hashTexture(texture);
+            if (useSpecularMaps)
+            {
+                Misc::StringUtils::replaceLast(texture, ".", specularMapPattern + ".");
+                hashTexture(texture);
+            }
+        }
+
+        return hash;
+    }
+
     void World::fillGlobalVariables()
     {
         mGlobalVariables.fill (mStore);
@@ -3980,6 +4045,7 @@ namespace MWWorld
     {
         mNavigator->reportStats(frameNumber, stats);
         mPhysics->reportStats(frameNumber, stats);
+        mWorldScene->reportStats(frameNumber, stats);
     }
 
     void World::updateSkyDate()
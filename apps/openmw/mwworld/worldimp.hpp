@@ -166,6 +166,10 @@ namespace MWWorld
 
             void fillGlobalVariables();
 
+            /// Hash identifying the loaded content files and the land textures by name, size and modification time,
+            /// and the settings that choose the land textures
+            std::size_t getContentHash() const;
+
             void updateSkyDate();
 
             void loadContentFiles(const Files::Collections& fileCollections, const std::vector<std::string>& content, ESMStore& store, std::vector<ESM::ESMReader>& readers, ToUTF8::Utf8Encoder* encoder, Loading::Listener* listener);
@@ -0,0 +1,59 @@
+#include <components/debug/trace.hpp>
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace
+{
+    using namespace testing;
+
+    constexpr const char* sZoneNames[] = {"zone0", "zone1", "zone2", "zone3", "zone4", "zone5"};
+
+    // Threads take their buffer size when they record their first zone, so each test uses new threads
+    std::string recordInThread(const std::string& threadName, std::size_t numZones)
+    {
+        std::thread thread([&]
+        {
+            Debug::setTraceThreadName(threadName);
+            for (std::size_t i = 0; i < numZones; ++i)
+                const Debug::TraceZone zone(sZoneNames[i]);
+        });
+        thread.join();
+        std::ostringstream stream;
+        Debug::writeTrace(stream);
+        return stream.str();
+    }
+
+    std::size_t count(const std::string& text, const std::string& value)
+    {
+        std::size_t result = 0;
+        for (std::size_t pos = text.find(value); pos != std::string::npos; pos = text.find(value, pos + 1))
+            ++result;
+        return result;
+    }
+
+    TEST(DebugTraceTest, should_write_zones_with_thread_name)
+    {
+        Debug::enableTrace("trace.json", 16);
+        const std::string trace = recordInThread("Named \"worker\"", 2);
+        EXPECT_EQ(count(trace, R"("args":{"name":"Named \"worker\""})"), 1);
+        EXPECT_EQ(count(trace, R"({"name":"zone0","ph":"X")"), 1);
+        EXPECT_EQ(count(trace, R"({"name":"zone1","ph":"X")"), 1);
+        EXPECT_EQ(trace.substr(0, 1), "{");
+        EXPECT_EQ(trace.substr(trace.size() - 3), "]}\n");
+    }
+
+    TEST(DebugTraceTest, should_keep_only_last_zones_of_each_thread)
+    {
+        Debug::enableTrace("trace.json", 3);
+        const std::string trace = recordInThread("Short buffer", 6);
+        const std::string thread = trace.substr(trace.find("Short buffer"));
+        EXPECT_EQ(count(thread, R"("zone2")"), 0);
+        EXPECT_EQ(count(thread, R"("zone3")"), 1);
+        EXPECT_EQ(count(thread, R"("zone4")"), 1);
+        EXPECT_EQ(count(thread, R"("zone5")"), 1);
+    }
+}
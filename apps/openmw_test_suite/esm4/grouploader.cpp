@@ -0,0 +1,221 @@
+#include <components/esm4/grouploader.hpp>
+#include <components/esm4/reader.hpp>
+
+#include <boost/iostreams/device/back_inserter.hpp>
+#include <boost/iostreams/filter/zlib.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace
+{
+    using namespace testing;
+    using namespace ESM4;
+
+    struct Record
+    {
+        FormId mFormId;
+        std::string mValue;
+
+        bool operator==(const Record& other) const
+        {
+            return std::tie(mFormId, mValue) == std::tie(other.mFormId, other.mValue);
+        }
+    };
+
+    struct Esm4GroupLoaderTest : Test
+    {
+        std::string mContent;
+
+        template <class T>
+        void write(std::string& out, const T& value)
+        {
+            out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+
+        std::string makeSubRecord(std::uint32_t type, const std::string& data)
+        {
+            std::string result;
+            write(result, SubRecordHeader {type, static_cast<std::uint16_t>(data.size())});
+            result += data;
+            return result;
+        }
+
+        static std::string compress(const std::string& data)
+        {
+            std::string result;
+            {
+                boost::iostreams::filtering_ostream stream;
+                stream.push(boost::iostreams::zlib_compressor());
+                stream.push(boost::iostreams::back_inserter(result));
+                stream << data;
+            }
+            return result;
+        }
+
+        void addRecord(std::string& out, std::uint32_t type, FormId formId, const std::string& data,
+            bool compressed = false)
+        {
+            RecordTypeHeader header {};
+            header.typeId = type;
+            header.id = formId;
+            if (compressed)
+            {
+                std::string compressedData;
+                write(compressedData, static_cast<std::uint32_t>(data.size()));
+                compressedData += compress(data);
+                header.flags = Rec_Compressed;
+                header.dataSize = static_cast<std::uint32_t>(compressedData.size());
+                write(out, header);
+                out += compressedData;
+                return;
+            }
+            header.dataSize = static_cast<std::uint32_t>(data.size());
+            write(out, header);
+            out += data;
+        }
+
+        void addGroup(std::string& out, std::int32_t type, std::uint32_t label, const std::string& content)
+        {
+            GroupTypeHeader header {};
+            header.typeId = REC_GRUP;
+            header.groupSize = static_cast<std::uint32_t>(sizeof(header) + content.size());
+            header.label.value = label;
+            header.type = type;
+            write(out, header);
+            out += content;
+        }
+
+        void addHeader(const std::vector<std::string>& masters)
+        {
+            std::string data;
+            std::string hedr;
+            write(hedr, 1.7f);
+            write(hedr, std::int32_t(0));
+            write(hedr, std::uint32_t(0));
+            data += makeSubRecord(SUB_HEDR, hedr);
+            for (const std::string& master : masters)
+            {
+                data += makeSubRecord(SUB_MAST, master + '\0');
+                std::string size;
+                write(size, std::uint64_t(0));
+                data += makeSubRecord(SUB_DATA, size);
+            }
+            addRecord(mContent, REC_TES4, 0, data);
+        }
+
+        std::string writeFile()
+        {
+            const auto path = std::string(UnitTest::GetInstance()->current_test_info()->name()) + ".esm";
+            std::ofstream stream(path, std::ios::binary);
+            stream << mContent;
+            return path;
+        }
+
+        static void readRecord(Reader& reader, std::vector<Record>& records)
+        {
+            Record& record = records.emplace_back();
+            record.mFormId = reader.hdr().record.id;
+            reader.adjustFormId(record.mFormId);
+            reader.getRecordData();
+            while (reader.getSubRecordHeader())
+            {
+                std::string value(reader.subRecordHeader().dataSize, '\0');
+                reader.get(value.data(), value.size());
+                record.mValue += value;
+            }
+        }
+
+        static std::vector<Record> load(const Reader& reader, std::size_t threads)
+        {
+            std::vector<Record> result;
+            loadGroups<std::vector<Record>>(reader, threads, readRecord,
+                [&] (std::vector<Record>&& records) { result.insert(result.end(), records.begin(), records.end()); });
+            return result;
+        }
+    };
+
+    TEST_F(Esm4GroupLoaderTest, records_should_be_inserted_in_file_order_for_any_number_of_threads)
+    {
+        addHeader({});
+        std::vector<Record> expected;
+        for (std::uint32_t group = 0; group < 16; ++group)
+        {
+            std::string content;
+            for (std::uint32_t i = 0; i < 8; ++i)
+            {
+                const Record record {group * 100 + i, "value " + std::to_string(group) + ' ' + std::to_string(i)};
+                addRecord(content, REC_GLOB, record.mFormId, makeSubRecord(SUB_EDID, record.mValue), i % 3 == 0);
+                expected.push_back(record);
+            }
+            addGroup(mContent, Grp_RecordType, REC_GLOB, content);
+        }
+        const std::string path = writeFile();
+
+        Reader reader(Files::openConstrainedFileStream(path), path);
+        EXPECT_EQ(indexTopGroups(reader).size(), 16);
+        EXPECT_EQ(load(reader, 1), expected);
+        EXPECT_EQ(load(reader, 4), expected);
+    }
+
+    TEST_F(Esm4GroupLoaderTest, nested_groups_should_be_read)
+    {
+        addHeader({});
+        std::string cell;
+        addRecord(cell, REC_GLOB, 2, makeSubRecord(SUB_EDID, "child"));
+        std::string content;
+        addRecord(content, REC_GLOB, 1, makeSubRecord(SUB_EDID, "parent"));
+        addGroup(content, Grp_CellChild, 1, cell);
+        addRecord(content, REC_GLOB, 3, makeSubRecord(SUB_EDID, "sibling"));
+        addGroup(mContent, Grp_RecordType, REC_GLOB, content);
+        const std::string path = writeFile();
+
+        Reader reader(Files::openConstrainedFileStream(path), path);
+        EXPECT_EQ(load(reader, 2), std::vector<Record>({{1, "parent"}, {2, "child"}, {3, "sibling"}}));
+    }
+
+    TEST_F(Esm4GroupLoaderTest, form_ids_should_be_fixed_up_by_mod_index)
+    {
+        addHeader({"A.esm", "B.esm"});
+        for (FormId formId : {0x00000001u, 0x01000002u, 0x02000003u})
+        {
+            std::string content;
+            addRecord(content, REC_GLOB, formId, makeSubRecord(SUB_EDID, "value"));
+            addGroup(mContent, Grp_RecordType, REC_GLOB, content);
+        }
+        const std::string path = writeFile();
+
+        Reader reader(Files::openConstrainedFileStream(path), path);
+        reader.setModIndex(3);
+        reader.updateModIndices({"A.esm", "C.esm", "B.esm"});
+        EXPECT_EQ(load(reader, 3),
+            std::vector<Record>({{0x00000001, "value"}, {0x02000002, "value"}, {0x03000003, "value"}}));
+    }
+
+    TEST_F(Esm4GroupLoaderTest, error_should_be_rethrown)
+    {
+        addHeader({});
+        for (FormId formId = 0; formId < 4; ++formId)
+        {
+            std::string content;
+            addRecord(content, REC_GLOB, formId, makeSubRecord(SUB_EDID, "value"));
+            addGroup(mContent, Grp_RecordType, REC_GLOB, content);
+        }
+        const std::string path = writeFile();
+
+        Reader reader(Files::openConstrainedFileStream(path), path);
+        const auto read = [] (Reader& groupReader, std::size_t group)
+        {
+            if (group == 2)
+                throw std::runtime_error("failed");
+            groupReader.skipRecordData();
+        };
+        EXPECT_THROW(readGroups(reader, indexTopGroups(reader), 2, read), std::runtime_error);
+    }
+}
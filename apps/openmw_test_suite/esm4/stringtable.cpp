@@ -0,0 +1,79 @@
+#include <components/esm4/stringtable.hpp>
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    using namespace testing;
+    using namespace ESM4;
+
+    struct Esm4StringTableTest : Test
+    {
+        template <class T>
+        static void write(std::string& out, const T& value)
+        {
+            out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+
+        static std::string writeFile(const std::vector<std::pair<FormId, std::string>>& strings, bool sizePrefixed)
+        {
+            std::string directory;
+            std::string data;
+            for (const auto& [id, value] : strings)
+            {
+                write(directory, id);
+                write(directory, static_cast<std::uint32_t>(data.size()));
+                if (sizePrefixed)
+                    write(data, static_cast<std::uint32_t>(value.size() + 1));
+                data += value;
+                data += '\0';
+            }
+
+            std::string content;
+            write(content, static_cast<std::uint32_t>(strings.size()));
+            write(content, static_cast<std::uint32_t>(data.size()));
+            content += directory;
+            content += data;
+
+            const auto path = std::string(UnitTest::GetInstance()->current_test_info()->name()) + ".STRINGS";
+            std::ofstream stream(path, std::ios::binary);
+            stream << content;
+            return path;
+        }
+    };
+
+    TEST_F(Esm4StringTableTest, find_should_return_null_terminated_strings)
+    {
+        const StringTable table(writeFile({{3, "three"}, {1, "one"}, {2, ""}}, false), false);
+        EXPECT_EQ(table.find(1), "one");
+        EXPECT_EQ(table.find(2), "");
+        EXPECT_EQ(table.find(3), "three");
+        EXPECT_EQ(table.find(4), std::nullopt);
+    }
+
+    TEST_F(Esm4StringTableTest, find_should_return_size_prefixed_strings)
+    {
+        const StringTable table(writeFile({{1, "one"}, {2, "two"}}, true), true);
+        EXPECT_EQ(table.find(1), "one");
+        EXPECT_EQ(table.find(2), "two");
+        EXPECT_EQ(table.find(0), std::nullopt);
+    }
+
+    TEST_F(Esm4StringTableTest, find_should_return_last_duplicated_id)
+    {
+        const StringTable table(writeFile({{2, "first"}, {1, "one"}, {2, "second"}}, false), false);
+        EXPECT_EQ(table.find(2), "second");
+    }
+
+    TEST_F(Esm4StringTableTest, file_should_only_be_read_by_first_lookup)
+    {
+        const StringTable table("missing.STRINGS", false);
+        EXPECT_THROW(table.find(1), std::runtime_error);
+    }
+}
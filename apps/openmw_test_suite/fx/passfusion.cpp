@@ -0,0 +1,138 @@
+#include <components/fx/passfusion.hpp>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace
+{
+    using namespace testing;
+    using namespace fx;
+
+    std::size_t countOccurrences(std::string_view text, std::string_view value)
+    {
+        std::size_t result = 0;
+        for (std::size_t pos = text.find(value); pos != std::string_view::npos; pos = text.find(value, pos + 1))
+            ++result;
+        return result;
+    }
+
+    constexpr std::string_view tint = R"(
+        omw_In vec2 omw_TexCoord;
+
+        void main()
+        {
+            omw_FragColor = omw_GetLastShader(omw_TexCoord) * 0.5;
+        }
+    )";
+
+    constexpr std::string_view gamma = R"(
+        omw_In vec2 omw_TexCoord;
+
+        void main()
+        {
+            omw_FragColor = pow(omw_GetLastPass(omw_TexCoord), vec4(1.0 / 2.2));
+        }
+    )";
+
+    TEST(FxPassFusionTest, reads_last_pass_per_fragment_at_tex_coord)
+    {
+        EXPECT_TRUE(readsLastPassPerFragment(gamma));
+        EXPECT_TRUE(readsLastPassPerFragment("void main() { omw_FragColor = omw_GetLastPass( omw_TexCoord ); }"));
+        EXPECT_TRUE(readsLastPassPerFragment("void main() { omw_FragColor = omw_GetLastShader(omw_TexCoord + 0.1); }"));
+    }
+
+    TEST(FxPassFusionTest, does_not_read_last_pass_per_fragment_at_offset)
+    {
+        EXPECT_FALSE(readsLastPassPerFragment("void main() { omw_FragColor = omw_GetLastPass(omw_TexCoord + 0.1); }"));
+        EXPECT_FALSE(readsLastPassPerFragment("void main() { omw_FragColor = omw_GetLastPass(vec2(0.5)); }"));
+    }
+
+    TEST(FxPassFusionTest, does_not_read_last_pass_per_fragment_from_sampler)
+    {
+        EXPECT_FALSE(readsLastPassPerFragment("void main() { omw_FragColor = omw_Texture2D(omw_SamplerLastPass, omw_TexCoord); }"));
+    }
+
+    TEST(FxPassFusionTest, reads_last_pass_ignores_comments)
+    {
+        EXPECT_TRUE(readsLastPassPerFragment(R"(
+            // omw_GetLastPass(omw_TexCoord + 0.1)
+            /* omw_SamplerLastPass */
+            void main() { omw_FragColor = omw_GetLastPass(omw_TexCoord); }
+        )"));
+    }
+
+    TEST(FxPassFusionTest, fuse_should_run_main_functions_in_order)
+    {
+        const std::optional<std::string> result = fuseFragmentShaders({tint, gamma});
+        ASSERT_TRUE(result.has_value());
+        EXPECT_THAT(*result, HasSubstr("#define main _omw_FusedPass0\n"));
+        EXPECT_THAT(*result, HasSubstr("#define main _omw_FusedPass1\n"));
+        EXPECT_THAT(*result, HasSubstr("#define omw_GetLastPass(uv) _omw_FusedLastPass\n"));
+        EXPECT_THAT(*result, EndsWith(
+            "void main()\n"
+            "{\n"
+            "    _omw_FusedPass0();\n"
+            "    _omw_FusedLastPass = clamp(omw_FragColor, 0.0, 1.0);\n"
+            "    _omw_FusedPass1();\n"
+            "}\n"));
+    }
+
+    TEST(FxPassFusionTest, fuse_should_keep_identical_declarations_once)
+    {
+        const std::optional<std::string> result = fuseFragmentShaders({tint, gamma, gamma});
+        ASSERT_TRUE(result.has_value());
+        EXPECT_EQ(countOccurrences(*result, "omw_In vec2 omw_TexCoord;"), 1);
+    }
+
+    TEST(FxPassFusionTest, fuse_should_fail_on_name_clash)
+    {
+        EXPECT_FALSE(fuseFragmentShaders({"uniform float a; void main() {}", "const float a = 1.0; void main() {}"}));
+        EXPECT_FALSE(fuseFragmentShaders({"float f() { return 1.0; } void main() {}", "float f() { return 2.0; } void main() {}"}));
+        EXPECT_FALSE(fuseFragmentShaders({"struct S { float x; }; void main() {}", "float S; void main() {}"}));
+        EXPECT_FALSE(fuseFragmentShaders({"float a, b; void main() {}", "float b; void main() {}"}));
+    }
+
+    TEST(FxPassFusionTest, fuse_should_allow_function_declared_before_definition)
+    {
+        EXPECT_TRUE(fuseFragmentShaders({"float f(); void main() {} float f() { return 1.0; }", "void main() {}"}));
+    }
+
+    TEST(FxPassFusionTest, fuse_should_fail_on_top_level_directives)
+    {
+        EXPECT_FALSE(fuseFragmentShaders({"#define X 1\nvoid main() {}", "void main() {}"}));
+        EXPECT_FALSE(fuseFragmentShaders({"void main() {}", "#if OMW_HDR\nfloat a;\n#endif\nvoid main() {}"}));
+        EXPECT_FALSE(fuseFragmentShaders({"void main()\n{\n#define X 1\n}\n", "void main() {}"}));
+    }
+
+    TEST(FxPassFusionTest, fuse_should_allow_line_directives_and_conditionals_in_functions)
+    {
+        EXPECT_TRUE(fuseFragmentShaders({"\n#line 3\nvoid main()\n{\n#if OMW_HDR\n    omw_FragColor = vec4(1.0);\n#endif\n}\n", gamma}));
+    }
+
+    TEST(FxPassFusionTest, fuse_should_fail_on_discard_before_last_pass)
+    {
+        constexpr std::string_view discarding = "void main() { if (omw_GetLastPass(omw_TexCoord).a < 0.5) discard; }";
+        EXPECT_FALSE(fuseFragmentShaders({discarding, gamma}));
+        EXPECT_TRUE(fuseFragmentShaders({tint, discarding}));
+    }
+
+    TEST(FxPassFusionTest, fuse_should_fail_when_later_pass_reads_last_pass_at_offset)
+    {
+        EXPECT_FALSE(fuseFragmentShaders({tint, "void main() { omw_FragColor = omw_GetLastPass(omw_TexCoord * 0.5); }"}));
+    }
+
+    TEST(FxPassFusionTest, fuse_should_fail_without_main)
+    {
+        EXPECT_FALSE(fuseFragmentShaders({"float a;", gamma}));
+    }
+
+    TEST(FxPassFusionTest, fuse_should_ignore_comments)
+    {
+        const std::optional<std::string> result = fuseFragmentShaders({
+            "// discard\n/* #define X */\nvoid main() {}\n",
+            "void main() { omw_FragColor = omw_GetLastPass(omw_TexCoord /* + 0.1 */); }"
+        });
+        ASSERT_TRUE(result.has_value());
+        EXPECT_THAT(*result, Not(HasSubstr("#define X")));
+    }
+}
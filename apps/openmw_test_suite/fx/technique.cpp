@@ -84,6 +84,83 @@ TestFile repeated_shared_block{R"(
     technique { passes = main; }
 )"};
 
+TestFile fused_passes{R"(
+    fragment tint {
+        omw_In vec2 omw_TexCoord;
+
+        void main()
+        {
+            omw_FragColor = omw_GetLastShader(omw_TexCoord) * vec4(1.0, 0.9, 0.8, 1.0);
+        }
+    }
+    fragment gamma {
+        omw_In vec2 omw_TexCoord;
+
+        void main()
+        {
+            omw_FragColor = pow(omw_GetLastPass(omw_TexCoord), vec4(1.0 / 2.2));
+        }
+    }
+    fragment blur {
+        omw_In vec2 omw_TexCoord;
+
+        void main()
+        {
+            omw_FragColor = (omw_GetLastPass(omw_TexCoord) + omw_GetLastPass(omw_TexCoord + omw.rcpResolution)) * 0.5;
+        }
+    }
+    technique { passes = tint, gamma, blur; }
+)"};
+
+TestFile unfused_passes{R"(
+    fragment tint {
+        omw_In vec2 omw_TexCoord;
+
+        void main()
+        {
+            omw_FragColor = omw_GetLastShader(omw_TexCoord);
+        }
+    }
+    fragment gamma {
+        omw_In vec2 omw_TexCoord;
+
+        void main()
+        {
+            omw_FragColor = omw_GetLastPass(omw_TexCoord);
+        }
+    }
+    technique {
+        passes = tint, gamma;
+        fuse_passes = false;
+    }
+)"};
+
+TestFile compute_with_fallback{R"(
+    compute main {
+        void main()
+        {
+            imageStore(omw_ImageOutput, ivec2(gl_GlobalInvocationID.xy), vec4(1.0));
+        }
+    }
+    fragment main {
+        void main()
+        {
+            omw_FragColor = vec4(1.0);
+        }
+    }
+    technique { passes = main; }
+)"};
+
+TestFile compute_without_fallback{R"(
+    compute main {
+        void main()
+        {
+            imageStore(omw_ImageOutput, ivec2(gl_GlobalInvocationID.xy), vec4(1.0));
+        }
+    }
+    technique { passes = main; }
+)"};
+
 
     using namespace testing;
     using namespace fx;
@@ -101,6 +178,10 @@ TestFile repeated_shared_block{R"(
                 {"shaders/uniform_properties.omwfx", &uniform_properties},
                 {"shaders/missing_sampler_source.omwfx", &missing_sampler_source},
                 {"shaders/repeated_shared_block.omwfx", &repeated_shared_block},
+                {"shaders/fused_passes.omwfx", &fused_passes},
+                {"shaders/unfused_passes.omwfx", &unfused_passes},
+                {"shaders/compute_with_fallback.omwfx", &compute_with_fallback},
+                {"shaders/compute_without_fallback.omwfx", &compute_without_fallback},
             }))
             , mImageManager(mVFS.get())
         {
@@ -108,9 +189,9 @@ TestFile repeated_shared_block{R"(
             Settings::Manager::setBool("stereo enabled", "Stereo", false);
         }
 
-        void compile(const std::string& name)
+        void compile(const std::string& name, bool supportsCompute = true)
         {
-            mTechnique = std::make_unique<Technique>(*mVFS.get(), mImageManager, name, 1, 1, true, true);
+            mTechnique = std::make_unique<Technique>(*mVFS.get(), mImageManager, name, 1, 1, true, true, supportsCompute);
             mTechnique->compile();
         }
     };
@@ -201,4 +282,51 @@ TestFile repeated_shared_block{R"(
         Log(Debug::Error) << output;
         EXPECT_THAT(output, HasSubstr("repeated 'shared' block"));
     }
-}
\ No newline at end of file
+
+    TEST_F(TechniqueTest, passes_reading_the_last_pass_per_fragment_are_fused)
+    {
+        compile("fused_passes");
+
+        EXPECT_TRUE(mTechnique->isValid());
+        ASSERT_EQ(mTechnique->getPasses().size(), 2);
+        EXPECT_EQ(mTechnique->getPasses()[0]->getName(), "tint+gamma");
+        EXPECT_EQ(mTechnique->getPasses()[1]->getName(), "blur");
+    }
+
+    TEST_F(TechniqueTest, passes_are_not_fused_when_disabled)
+    {
+        compile("unfused_passes");
+
+        EXPECT_FALSE(mTechnique->getFusePasses());
+        ASSERT_EQ(mTechnique->getPasses().size(), 2);
+        EXPECT_EQ(mTechnique->getPasses()[0]->getName(), "tint");
+        EXPECT_EQ(mTechnique->getPasses()[1]->getName(), "gamma");
+    }
+
+    TEST_F(TechniqueTest, compute_pass_is_used_when_supported)
+    {
+        compile("compute_with_fallback");
+
+        ASSERT_EQ(mTechnique->getPasses().size(), 1);
+        EXPECT_EQ(mTechnique->getPasses()[0]->getType(), Pass::Type::Compute);
+    }
+
+    TEST_F(TechniqueTest, compute_pass_falls_back_to_fragment_shader)
+    {
+        compile("compute_with_fallback", false);
+
+        ASSERT_EQ(mTechnique->getPasses().size(), 1);
+        EXPECT_EQ(mTechnique->getPasses()[0]->getType(), Pass::Type::Pixel);
+    }
+
+    TEST_F(TechniqueTest, fail_with_unsupported_compute_pass_without_fallback)
+    {
+        internal::CaptureStdout();
+
+        compile("compute_without_fallback", false);
+
+        std::string output = internal::GetCapturedStdout();
+        Log(Debug::Error) << output;
+        EXPECT_THAT(output, HasSubstr("pass 'main' has no 'fragment' block to fall back to"));
+    }
+}
@@ -1,4 +1,5 @@
 #include "gmock/gmock.h"
+#include <algorithm>
 #include <gtest/gtest.h>
 
 #include <components/esm/luascripts.hpp>
@@ -185,6 +186,32 @@ return {
                                                  "Test[test2.lua]:\t update 1.5\n");
     }
 
+    TEST_F(LuaScriptsContainerTest, ScriptStats)
+    {
+        LuaUtil::ScriptsContainer scripts(&mLua, "Test");
+        const int test1 = *mCfg.findId("test1.lua");
+        const int stopEvent = *mCfg.findId("stopEvent.lua");
+        EXPECT_TRUE(scripts.addCustomScript(test1));
+        EXPECT_TRUE(scripts.addCustomScript(stopEvent));
+        mLua.resetScriptStats();
+
+        testing::internal::CaptureStdout();
+        scripts.update(1.5f);
+        scripts.update(1.5f);
+        scripts.receiveEvent("Event1", LuaUtil::serialize(mLua.sol().create_table_with("x", 1.5)));
+        internal::GetCapturedStdout();
+
+        const auto& stats = mLua.getScriptStats();
+        ASSERT_GT(stats.size(), static_cast<std::size_t>(std::max(test1, stopEvent)));
+        EXPECT_EQ(stats[test1].mCalls, 3u);
+        EXPECT_EQ(stats[stopEvent].mCalls, 1u);
+        EXPECT_GT(stats[test1].mTime, 0);
+        EXPECT_EQ(mLua.getTotalStats().mCalls, 4u);
+
+        mLua.resetScriptStats();
+        EXPECT_TRUE(mLua.getScriptStats().empty());
+    }
+
     TEST_F(LuaScriptsContainerTest, CallEvent)
     {
         LuaUtil::ScriptsContainer scripts(&mLua, "Test");
@@ -271,4 +271,58 @@ namespace
         EXPECT_EQ(ry.b, 3);
     }
 
+    TEST(LuaSerializationTest, Copy)
+    {
+        sol::state lua;
+        sol::table table(lua, sol::create);
+        table["aa"] = 1;
+        table["ab"] = true;
+        table["nested"] = sol::table(lua, sol::create);
+        table["nested"]["bb"] = "something";
+        table["nested"][5] = -0.5;
+        table[1] = osg::Vec3f(1, 2, 3);
+        table["x"] = TestStruct1{1.5, 2.5};
+        TestSerializer serializer;
+
+        EXPECT_ERROR(LuaUtil::copy(lua, table), "Value is not serializable.");
+        sol::table res = LuaUtil::copy(lua, table, &serializer, &serializer);
+        EXPECT_EQ(res.get<int>("aa"), 1);
+        EXPECT_EQ(res.get<bool>("ab"), true);
+        EXPECT_FLOAT_EQ(res.get<sol::table>("nested").get<double>(5), -0.5);
+
+        // The copy doesn't share tables with the source
+        table["nested"]["bb"] = "changed";
+        EXPECT_EQ(res.get<sol::table>("nested").get<std::string>("bb"), "something");
+        EXPECT_EQ(res.get<osg::Vec3f>(1), osg::Vec3f(1, 2, 3));
+        EXPECT_EQ(res.get<TestStruct1>("x").b, 2.5);
+
+        EXPECT_EQ(LuaUtil::copy(lua, sol::nil), sol::nil);
+        EXPECT_EQ(LuaUtil::copy(lua, sol::make_object(lua, "abc")).as<std::string>(), "abc");
+        EXPECT_ERROR(LuaUtil::copy(lua, lua.safe_script("return function() end").get<sol::object>()),
+                     "Functions are not allowed to be serialized.");
+
+        sol::table recursive(lua, sol::create);
+        recursive["self"] = recursive;
+        EXPECT_ERROR(LuaUtil::copy(lua, recursive), "Can not serialize more than 32 nested tables.");
+        EXPECT_EQ(lua_gettop(lua), 0);
+    }
+
+    TEST(LuaSerializationTest, SerializeTable)
+    {
+        sol::state lua;
+        const std::string a = LuaUtil::serialize(sol::make_object(lua, 5));
+        const std::string b = LuaUtil::serialize(lua.safe_script("return {x = 'abc', y = {1, 2}}").get<sol::object>());
+        const std::string nil = LuaUtil::serialize(sol::nil);
+
+        sol::table res = LuaUtil::deserialize(lua, LuaUtil::serializeTable({{"a", a}, {"long key that doesn't fit short strings", b}, {"c", nil}}));
+        EXPECT_EQ(res.get<int>("a"), 5);
+        sol::table t = res.get<sol::table>("long key that doesn't fit short strings");
+        EXPECT_EQ(t.get<std::string>("x"), "abc");
+        EXPECT_EQ(t.get<sol::table>("y").get<int>(2), 2);
+        EXPECT_EQ(res.get<sol::object>("c"), sol::nil);
+
+        EXPECT_EQ(LuaUtil::serializeTable({}), LuaUtil::serialize(sol::table(lua, sol::create)));
+        EXPECT_ERROR(LuaUtil::serializeTable({{"a", "x"}}), "Incorrect version of Lua serialization format");
+    }
+
 }
@@ -112,4 +112,62 @@ namespace
         EXPECT_TRUE(get<bool>(mLua, "temporary:get('y') == nil"));
     }
 
+    TEST(LuaUtilStorageTest, CopiesAreIndependent)
+    {
+        sol::state mLua;
+        LuaUtil::LuaStorage::initLuaBindings(mLua);
+        LuaUtil::LuaStorage storage(mLua);
+
+        mLua["s"] = storage.getMutableSection("test");
+        mLua.safe_script("s:set('t', {a = 1, b = {c = 2}})");
+        mLua.safe_script("copy1 = s:getCopy('t'); copy1.b.c = 5");
+        EXPECT_EQ(get<int>(mLua, "s:getCopy('t').b.c"), 2);
+        EXPECT_EQ(get<int>(mLua, "s:get('t').b.c"), 2);
+        EXPECT_TRUE(get<bool>(mLua, "s:getCopy('t') ~= s:getCopy('t')"));
+
+        mLua.safe_script("s:set('t', {a = 3})");
+        EXPECT_EQ(get<int>(mLua, "s:getCopy('t').a"), 3);
+        EXPECT_EQ(get<int>(mLua, "s:get('t').a"), 3);
+        EXPECT_TRUE(get<bool>(mLua, "s:getCopy('missing') == nil"));
+    }
+
+    TEST(LuaUtilStorageTest, SavingSkipsUnchangedStorage)
+    {
+        sol::state mLua;
+        LuaUtil::LuaStorage::initLuaBindings(mLua);
+        LuaUtil::LuaStorage storage(mLua);
+
+        mLua["s"] = storage.getMutableSection("test");
+        mLua.safe_script("s:set('x', 1)");
+
+        const std::string tmpFile = (std::filesystem::temp_directory_path() / "test_storage_incremental.bin").string();
+        std::filesystem::remove(tmpFile);
+        storage.save(tmpFile);
+        const auto size = std::filesystem::file_size(tmpFile);
+
+        // Not rewritten without changes
+        std::filesystem::resize_file(tmpFile, 0);
+        storage.save(tmpFile);
+        EXPECT_EQ(std::filesystem::file_size(tmpFile), 0);
+
+        mLua.safe_script("s:set('y', 'abc')");
+        storage.save(tmpFile);
+        EXPECT_GT(std::filesystem::file_size(tmpFile), size);
+
+        LuaUtil::LuaStorage storage2(mLua);
+        storage2.load(tmpFile);
+        mLua["s2"] = storage2.getReadOnlySection("test");
+        EXPECT_EQ(get<int>(mLua, "s2:get('x')"), 1);
+        EXPECT_EQ(get<std::string>(mLua, "s2:get('y')"), "abc");
+
+        // Temporary sections are not saved, so the file changes when a section becomes temporary
+        mLua.safe_script("s:removeOnExit()");
+        storage.save(tmpFile);
+        LuaUtil::LuaStorage storage3(mLua);
+        storage3.load(tmpFile);
+        mLua["s3"] = storage3.getReadOnlySection("test");
+        EXPECT_TRUE(get<bool>(mLua, "s3:get('x') == nil"));
+        std::filesystem::remove(tmpFile);
+    }
+
 }
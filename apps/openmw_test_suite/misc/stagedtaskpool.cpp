@@ -0,0 +1,141 @@
+#include <components/misc/stagedtaskpool.hpp>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+namespace
+{
+    using namespace testing;
+    using namespace Misc;
+
+    // Returns the stages with the given sizes in order, recording which items of which stage were run
+    struct Stages
+    {
+        std::vector<std::size_t> mSizes;
+        std::size_t mMinChunkSize = 1;
+        std::size_t mNext = 0;
+        std::vector<std::unique_ptr<std::atomic<int>[]>> mRuns;
+        std::vector<std::size_t> mRequested;
+        std::atomic<bool> mOutOfOrder {false};
+
+        explicit Stages(std::vector<std::size_t> sizes, std::size_t minChunkSize = 1)
+            : mSizes(std::move(sizes))
+            , mMinChunkSize(minChunkSize)
+        {
+            for (const std::size_t size : mSizes)
+            {
+                mRuns.emplace_back(new std::atomic<int>[size]);
+                for (std::size_t i = 0; i < size; ++i)
+                    mRuns.back()[i] = 0;
+            }
+        }
+
+        StagedTaskPool::NextStage makeNextStage()
+        {
+            return [this] () -> std::optional<StagedTaskPool::Stage>
+            {
+                // Every item of the previous stages has to be finished before the next stage is requested
+                for (std::size_t stage = 0; stage < mNext; ++stage)
+                    for (std::size_t i = 0; i < mSizes[stage]; ++i)
+                        if (mRuns[stage][i] != 1)
+                            mOutOfOrder = true;
+                if (mNext == mSizes.size())
+                    return std::nullopt;
+                const std::size_t stage = mNext++;
+                mRequested.push_back(stage);
+                return StagedTaskPool::Stage {mSizes[stage], mMinChunkSize, [this, stage] (std::size_t begin, std::size_t end)
+                {
+                    for (std::size_t i = begin; i < end; ++i)
+                    {
+                        // Items of later stages must not have started yet
+                        for (std::size_t later = stage + 1; later < mSizes.size(); ++later)
+                            for (std::size_t j = 0; j < mSizes[later]; ++j)
+                                if (mRuns[later][j] != 0)
+                                    mOutOfOrder = true;
+                        ++mRuns[stage][i];
+                    }
+                }};
+            };
+        }
+
+        void expectEachItemRunOnce() const
+        {
+            for (std::size_t stage = 0; stage < mSizes.size(); ++stage)
+                for (std::size_t i = 0; i < mSizes[stage]; ++i)
+                    EXPECT_EQ(mRuns[stage][i], 1) << "stage " << stage << " item " << i;
+        }
+    };
+
+    TEST(MiscStagedTaskPoolTest, without_threads_should_run_stages_in_order_in_start)
+    {
+        StagedTaskPool pool(0);
+        EXPECT_EQ(pool.getNumThreads(), 0);
+        Stages stages({3, 0, 5, 1});
+        pool.start(stages.makeNextStage());
+        EXPECT_FALSE(pool.isBusy());
+        EXPECT_THAT(stages.mRequested, ElementsAre(0, 1, 2, 3));
+        EXPECT_FALSE(stages.mOutOfOrder);
+        stages.expectEachItemRunOnce();
+        pool.wait();
+    }
+
+    TEST(MiscStagedTaskPoolTest, should_run_each_item_once_across_chunks)
+    {
+        StagedTaskPool pool(4);
+        Stages stages({1000, 7, 1, 64}, 3);
+        pool.start(stages.makeNextStage());
+        pool.wait();
+        EXPECT_THAT(stages.mRequested, ElementsAre(0, 1, 2, 3));
+        EXPECT_FALSE(stages.mOutOfOrder);
+        stages.expectEachItemRunOnce();
+    }
+
+    TEST(MiscStagedTaskPoolTest, should_skip_empty_stages)
+    {
+        StagedTaskPool pool(2);
+        Stages stages({0, 10, 0, 0, 10, 0});
+        pool.start(stages.makeNextStage());
+        pool.wait();
+        EXPECT_THAT(stages.mRequested, ElementsAre(0, 1, 2, 3, 4, 5));
+        EXPECT_FALSE(stages.mOutOfOrder);
+        stages.expectEachItemRunOnce();
+    }
+
+    TEST(MiscStagedTaskPoolTest, wait_should_return_after_last_stage)
+    {
+        StagedTaskPool pool(3);
+        std::atomic<bool> lastStageDone {false};
+        bool requested = false;
+        pool.start([&] () -> std::optional<StagedTaskPool::Stage>
+        {
+            if (requested)
+                return std::nullopt;
+            requested = true;
+            return StagedTaskPool::Stage {1, 1, [&] (std::size_t, std::size_t)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                lastStageDone = true;
+            }};
+        });
+        pool.wait();
+        EXPECT_TRUE(lastStageDone);
+        EXPECT_FALSE(pool.isBusy());
+    }
+
+    TEST(MiscStagedTaskPoolTest, should_be_restartable_after_wait)
+    {
+        StagedTaskPool pool(2);
+        for (int i = 0; i < 10; ++i)
+        {
+            Stages stages({50, 50});
+            pool.start(stages.makeNextStage());
+            pool.wait();
+            EXPECT_FALSE(stages.mOutOfOrder);
+            stages.expectEachItemRunOnce();
+        }
+    }
+}
@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+
+#include <components/esm3/loaddial.hpp>
+
+#include "apps/openmw/mwdialogue/infoindex.hpp"
+
+namespace
+{
+    using namespace testing;
+    using namespace MWDialogue;
+
+    struct InfoIndexTest : Test
+    {
+        ESM::Dialogue mDialogue;
+
+        ESM::DialInfo& addInfo(const std::string& id)
+        {
+            ESM::DialInfo& info = mDialogue.mInfo.emplace_back();
+            info.blank();
+            info.mId = id;
+            return info;
+        }
+
+        static std::vector<std::string> getIds(const std::vector<const ESM::DialInfo*>& infos)
+        {
+            std::vector<std::string> result;
+            for (const ESM::DialInfo* info : infos)
+                result.push_back(info->mId);
+            return result;
+        }
+
+        static InfoIndex::Speaker makeNpc(const std::string& id, const std::string& faction, const std::string& cls,
+            const std::string& race)
+        {
+            InfoIndex::Speaker speaker;
+            speaker.mId = id;
+            speaker.mFaction = faction;
+            speaker.mClass = cls;
+            speaker.mRace = race;
+            return speaker;
+        }
+    };
+
+    TEST_F(InfoIndexTest, candidates_should_keep_dialogue_order)
+    {
+        addInfo("any");
+        addInfo("race").mRace = "Dark Elf";
+        addInfo("actor").mActor = "Fargoth";
+        addInfo("class").mClass = "Commoner";
+        addInfo("faction").mFaction = "Hlaalu";
+        const InfoIndex index(mDialogue);
+        EXPECT_EQ(getIds(index.getCandidates(makeNpc("fargoth", "hlaalu", "commoner", "dark elf"))),
+            std::vector<std::string>({"any", "race", "actor", "class", "faction"}));
+    }
+
+    TEST_F(InfoIndexTest, candidates_should_not_contain_infos_for_other_speakers)
+    {
+        addInfo("any");
+        addInfo("other race").mRace = "Argonian";
+        addInfo("other actor").mActor = "Vivec";
+        addInfo("other class").mClass = "Guard";
+        addInfo("other faction").mFaction = "Redoran";
+        addInfo("race").mRace = "Wood Elf";
+        const InfoIndex index(mDialogue);
+        EXPECT_EQ(getIds(index.getCandidates(makeNpc("fargoth", "hlaalu", "commoner", "wood elf"))),
+            std::vector<std::string>({"any", "race"}));
+    }
+
+    TEST_F(InfoIndexTest, factionless_infos_should_only_be_candidates_for_speakers_without_faction)
+    {
+        ESM::DialInfo& factionLess = addInfo("factionless");
+        factionLess.mFaction = "FFFF";
+        factionLess.mFactionLess = true;
+        const InfoIndex index(mDialogue);
+        EXPECT_EQ(getIds(index.getCandidates(makeNpc("fargoth", "", "commoner", "wood elf"))),
+            std::vector<std::string>({"factionless"}));
+        EXPECT_TRUE(index.getCandidates(makeNpc("fargoth", "hlaalu", "commoner", "wood elf")).empty());
+    }
+
+    TEST_F(InfoIndexTest, creatures_should_only_get_infos_for_their_id)
+    {
+        addInfo("any");
+        addInfo("actor").mActor = "Mudcrab";
+        const InfoIndex index(mDialogue);
+        InfoIndex::Speaker speaker;
+        speaker.mId = "mudcrab";
+        speaker.mIsCreature = true;
+        EXPECT_EQ(getIds(index.getCandidates(speaker)), std::vector<std::string>({"actor"}));
+    }
+}
@@ -134,3 +134,52 @@ TEST_F(KeywordSearchTest, keyword_test_russian_ascii_before)
     EXPECT_EQ(std::string(matches[0].mBeg, matches[0].mEnd), "Доложить Каю Косадесу");
 }
 
+
+TEST_F(KeywordSearchTest, keyword_test_prefix_seeded_after_longer_keyword)
+{
+    MWDialogue::KeywordSearch<std::string, int> search;
+    search.seed("dwemer language", 1);
+    search.seed("dwemer", 2);
+
+    std::string text = "the dwemer knew the dwemer language";
+
+    std::vector<MWDialogue::KeywordSearch<std::string, int>::Match> matches;
+    search.highlightKeywords(text.begin(), text.end(), matches);
+
+    EXPECT_EQ(matches.size(), 2);
+    EXPECT_EQ(std::string(matches[0].mBeg, matches[0].mEnd), "dwemer");
+    EXPECT_EQ(matches[0].mValue, 2);
+    EXPECT_EQ(std::string(matches[1].mBeg, matches[1].mEnd), "dwemer language");
+    EXPECT_EQ(matches[1].mValue, 1);
+}
+
+TEST_F(KeywordSearchTest, keyword_test_suffix_of_another_keyword)
+{
+    // "ois" ends inside the longer keyword and has to be found while matching it
+    MWDialogue::KeywordSearch<std::string, int> search;
+    search.seed("déçois pas", 0);
+    search.seed("ois", 0);
+
+    std::string text = "tu me déçois toujours";
+
+    std::vector<MWDialogue::KeywordSearch<std::string, int>::Match> matches;
+    search.highlightKeywords(text.begin(), text.end(), matches);
+
+    EXPECT_EQ(matches.size(), 1);
+    EXPECT_EQ(std::string(matches[0].mBeg, matches[0].mEnd), "ois");
+}
+
+TEST_F(KeywordSearchTest, keyword_test_contains_keyword)
+{
+    MWDialogue::KeywordSearch<std::string, int> search;
+    search.seed("Caius Cosades", 1);
+    search.seed("caius", 2);
+
+    int value = 0;
+    EXPECT_TRUE(search.containsKeyword("CAIUS COSADES", value));
+    EXPECT_EQ(value, 1);
+    EXPECT_TRUE(search.containsKeyword("caius", value));
+    EXPECT_EQ(value, 2);
+    EXPECT_FALSE(search.containsKeyword("caius cos", value));
+    EXPECT_FALSE(search.containsKeyword("", value));
+}
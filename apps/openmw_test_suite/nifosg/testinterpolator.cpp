@@ -0,0 +1,71 @@
+#include <components/nifosg/controller.hpp>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+    using namespace testing;
+    using namespace NifOsg;
+
+    std::shared_ptr<Nif::FloatKeyMap> makeKeys(const std::vector<std::pair<float, float>>& values)
+    {
+        auto result = std::make_shared<Nif::FloatKeyMap>();
+        result->mInterpolationType = Nif::InterpolationType_Linear;
+        std::vector<std::pair<float, Nif::FloatKey>> keys;
+        for (const auto& [time, value] : values)
+        {
+            Nif::FloatKey key {};
+            key.mValue = value;
+            keys.emplace_back(time, key);
+        }
+        result->setKeys(std::move(keys));
+        return result;
+    }
+
+    TEST(NifOsgFloatInterpolatorTest, should_return_default_value_without_keys)
+    {
+        const FloatInterpolator interpolator(Nif::FloatKeyMapPtr(), 42.f);
+        EXPECT_TRUE(interpolator.empty());
+        EXPECT_EQ(interpolator.interpKey(1.f), 42.f);
+    }
+
+    TEST(NifOsgFloatInterpolatorTest, should_sort_keys_and_replace_duplicates)
+    {
+        const auto keys = makeKeys({{2.f, 20.f}, {0.f, 0.f}, {1.f, 5.f}, {1.f, 10.f}});
+        EXPECT_EQ(keys->mTimes, std::vector<float>({0.f, 1.f, 2.f}));
+        EXPECT_EQ(keys->mValues[1].mValue, 10.f);
+    }
+
+    TEST(NifOsgFloatInterpolatorTest, should_detect_evenly_spaced_keys)
+    {
+        EXPECT_FLOAT_EQ(makeKeys({{0.f, 0.f}, {0.5f, 1.f}, {1.f, 2.f}})->mRate, 2.f);
+        EXPECT_EQ(makeKeys({{0.f, 0.f}, {0.2f, 1.f}, {1.f, 2.f}})->mRate, 0.f);
+    }
+
+    TEST(NifOsgFloatInterpolatorTest, should_clamp_to_first_and_last_key)
+    {
+        const FloatInterpolator interpolator(makeKeys({{1.f, 10.f}, {2.f, 20.f}}));
+        EXPECT_EQ(interpolator.interpKey(0.f), 10.f);
+        EXPECT_EQ(interpolator.interpKey(3.f), 20.f);
+    }
+
+    TEST(NifOsgFloatInterpolatorTest, should_interpolate_evenly_spaced_keys)
+    {
+        const FloatInterpolator interpolator(makeKeys({{0.f, 0.f}, {1.f, 10.f}, {2.f, 30.f}, {3.f, 60.f}}));
+        EXPECT_FLOAT_EQ(interpolator.interpKey(0.5f), 5.f);
+        EXPECT_FLOAT_EQ(interpolator.interpKey(2.5f), 45.f);
+        EXPECT_FLOAT_EQ(interpolator.interpKey(1.f), 10.f);
+        EXPECT_FLOAT_EQ(interpolator.interpKey(0.25f), 2.5f);
+    }
+
+    TEST(NifOsgFloatInterpolatorTest, should_interpolate_unevenly_spaced_keys_in_any_order)
+    {
+        const FloatInterpolator interpolator(makeKeys({{0.f, 0.f}, {1.f, 10.f}, {1.5f, 20.f}, {3.f, 60.f}}));
+        EXPECT_FLOAT_EQ(interpolator.interpKey(0.5f), 5.f);
+        EXPECT_FLOAT_EQ(interpolator.interpKey(1.25f), 15.f);
+        EXPECT_FLOAT_EQ(interpolator.interpKey(2.25f), 40.f);
+        EXPECT_FLOAT_EQ(interpolator.interpKey(0.5f), 5.f);
+        EXPECT_FLOAT_EQ(interpolator.interpKey(1.5f), 20.f);
+        EXPECT_FLOAT_EQ(interpolator.interpKey(3.f), 60.f);
+    }
+}
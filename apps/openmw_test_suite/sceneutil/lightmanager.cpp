@@ -0,0 +1,96 @@
+#include <components/sceneutil/lightmanager.hpp>
+
+#include <gtest/gtest.h>
+
+#include <osg/Matrix>
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    using namespace testing;
+    using namespace SceneUtil;
+
+    constexpr int tilesX = 16;
+    constexpr int tilesY = 8;
+    constexpr int slices = 16;
+
+    struct SceneUtilClusterRangeTest : Test
+    {
+        const osg::Matrix mProjection = osg::Matrix::perspective(60, 16.0 / 9.0, 1, 8192);
+        const osg::Vec2f mDepthParams {64.f, slices / std::log(8192.f / 64.f)};
+
+        // Same as lcalcCluster in lighting_util.glsl
+        std::optional<osg::Vec3i> getCluster(const osg::Vec3f& viewPos) const
+        {
+            const osg::Vec4f clip = osg::Vec4f(viewPos, 1.f) * mProjection;
+            if (clip.w() <= 0.f)
+                return std::nullopt;
+            const osg::Vec2f ndc(clip.x() / clip.w(), clip.y() / clip.w());
+            if (std::abs(ndc.x()) > 1.f || std::abs(ndc.y()) > 1.f)
+                return std::nullopt;
+            const float screenX = std::clamp(ndc.x() * 0.5f + 0.5f, 0.f, 0.9999f);
+            const float screenY = std::clamp(ndc.y() * 0.5f + 0.5f, 0.f, 0.9999f);
+            const float depth = std::max(-viewPos.z(), mDepthParams.x());
+            const int slice = static_cast<int>(std::min(std::log(depth / mDepthParams.x()) * mDepthParams.y(), float(slices - 1)));
+            return osg::Vec3i(static_cast<int>(screenX * tilesX), static_cast<int>(screenY * tilesY), slice);
+        }
+
+        // Every visible point within the radius of the light must be in one of its clusters
+        void expectReachesEveryCluster(const osg::Vec3f& center, float radius) const
+        {
+            const std::optional<ClusterRange> range = getClusterRange(center, radius, mProjection, mDepthParams, tilesX, tilesY, slices);
+            constexpr int steps = 16;
+            for (int x = -steps; x <= steps; ++x)
+                for (int y = -steps; y <= steps; ++y)
+                    for (int z = -steps; z <= steps; ++z)
+                    {
+                        const osg::Vec3f offset(x, y, z);
+                        if (offset.length() > steps)
+                            continue;
+                        const osg::Vec3f point = center + offset * (radius / steps);
+                        const std::optional<osg::Vec3i> cluster = getCluster(point);
+                        if (!cluster)
+                            continue;
+                        ASSERT_TRUE(range.has_value()) << "point " << point.x() << " " << point.y() << " " << point.z();
+                        EXPECT_GE(cluster->x(), range->mMinX);
+                        EXPECT_LE(cluster->x(), range->mMaxX);
+                        EXPECT_GE(cluster->y(), range->mMinY);
+                        EXPECT_LE(cluster->y(), range->mMaxY);
+                        EXPECT_GE(cluster->z(), range->mMinZ);
+                        EXPECT_LE(cluster->z(), range->mMaxZ);
+                    }
+        }
+    };
+
+    TEST_F(SceneUtilClusterRangeTest, light_in_front_of_camera_should_reach_every_cluster_within_radius)
+    {
+        expectReachesEveryCluster(osg::Vec3f(0, 0, -1000), 300);
+        expectReachesEveryCluster(osg::Vec3f(200, -100, -400), 150);
+        expectReachesEveryCluster(osg::Vec3f(-50, 20, -80), 40);
+    }
+
+    TEST_F(SceneUtilClusterRangeTest, light_at_edge_of_screen_should_reach_every_cluster_within_radius)
+    {
+        expectReachesEveryCluster(osg::Vec3f(1000, 300, -1000), 400);
+        expectReachesEveryCluster(osg::Vec3f(-900, -500, -800), 256);
+    }
+
+    TEST_F(SceneUtilClusterRangeTest, light_around_camera_should_cover_whole_screen)
+    {
+        const std::optional<ClusterRange> range = getClusterRange(osg::Vec3f(10, 0, -20), 100, mProjection, mDepthParams, tilesX, tilesY, slices);
+        ASSERT_TRUE(range.has_value());
+        EXPECT_EQ(range->mMinX, 0);
+        EXPECT_EQ(range->mMaxX, tilesX - 1);
+        EXPECT_EQ(range->mMinY, 0);
+        EXPECT_EQ(range->mMaxY, tilesY - 1);
+        EXPECT_EQ(range->mMinZ, 0);
+        expectReachesEveryCluster(osg::Vec3f(10, 0, -20), 100);
+    }
+
+    TEST_F(SceneUtilClusterRangeTest, light_behind_camera_should_not_reach_any_cluster)
+    {
+        EXPECT_FALSE(getClusterRange(osg::Vec3f(0, 0, 500), 300, mProjection, mDepthParams, tilesX, tilesY, slices));
+    }
+}
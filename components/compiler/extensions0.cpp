@@ -339,6 +339,7 @@ namespace Compiler
             extensions.registerInstruction ("togglerecastmesh", "", opcodeToggleRecastMesh);
             extensions.registerInstruction ("help", "", opcodeHelp);
             extensions.registerInstruction ("reloadlua", "", opcodeReloadLua);
+            extensions.registerInstruction ("writetrace", "", opcodeWriteTrace);
         }
     }
 
@@ -0,0 +1,228 @@
+#include "trace.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <vector>
+
+namespace Debug
+{
+    namespace
+    {
+        struct Event
+        {
+            std::atomic<const char*> mName {nullptr};
+            std::atomic<std::int64_t> mBegin {0};
+            std::atomic<std::int64_t> mEnd {0};
+        };
+
+        // Written only by its thread. mStarted is increased before an event is overwritten and mWritten after, so
+        // that a reader can drop the events that changed while it was copying them.
+        struct ThreadBuffer
+        {
+            const std::size_t mId;
+            std::string mName; // guarded by Registry::mMutex
+            const std::size_t mCapacity;
+            const std::unique_ptr<Event[]> mEvents;
+            std::atomic<std::uint64_t> mStarted {0};
+            std::atomic<std::uint64_t> mWritten {0};
+
+            ThreadBuffer(std::size_t id, std::string&& name, std::size_t capacity)
+                : mId(id)
+                , mName(std::move(name))
+                , mCapacity(capacity)
+                , mEvents(std::make_unique<Event[]>(capacity))
+            {
+            }
+        };
+
+        struct Registry
+        {
+            std::mutex mMutex;
+            std::string mPath;
+            std::size_t mEventsPerThread = 1;
+            std::int64_t mStart = 0;
+            std::vector<std::unique_ptr<ThreadBuffer>> mBuffers;
+        };
+
+        // Never destroyed, threads may record until the process exits
+        Registry& getRegistry()
+        {
+            static Registry* const registry = new Registry;
+            return *registry;
+        }
+
+        thread_local ThreadBuffer* sBuffer = nullptr;
+        thread_local std::string sThreadName;
+
+        ThreadBuffer& getThreadBuffer()
+        {
+            if (sBuffer != nullptr)
+                return *sBuffer;
+            Registry& registry = getRegistry();
+            const std::lock_guard<std::mutex> lock(registry.mMutex);
+            const std::size_t id = registry.mBuffers.size();
+            std::string name = sThreadName.empty() ? "Thread " + std::to_string(id) : sThreadName;
+            registry.mBuffers.push_back(std::make_unique<ThreadBuffer>(id, std::move(name), registry.mEventsPerThread));
+            sBuffer = registry.mBuffers.back().get();
+            return *sBuffer;
+        }
+
+        void writeString(std::ostream& stream, std::string_view value)
+        {
+            stream << '"';
+            for (const char c : value)
+            {
+                if (c == '"' || c == '\\')
+                    stream << '\\' << c;
+                else if (static_cast<unsigned char>(c) < 0x20)
+                    stream << ' ';
+                else
+                    stream << c;
+            }
+            stream << '"';
+        }
+
+        // Chrome trace timestamps are in microseconds
+        void writeMicroseconds(std::ostream& stream, std::int64_t nanoseconds)
+        {
+            if (nanoseconds < 0)
+                nanoseconds = 0;
+            const std::int64_t fraction = nanoseconds % 1000;
+            stream << nanoseconds / 1000 << '.' << fraction / 100 << fraction / 10 % 10 << fraction % 10;
+        }
+
+        struct EventCopy
+        {
+            const char* mName;
+            std::int64_t mBegin;
+            std::int64_t mEnd;
+        };
+
+        std::vector<EventCopy> copyEvents(const ThreadBuffer& buffer)
+        {
+            const std::uint64_t written = buffer.mWritten.load(std::memory_order_acquire);
+            const std::uint64_t first = written > buffer.mCapacity ? written - buffer.mCapacity : 0;
+
+            std::vector<EventCopy> result;
+            result.reserve(static_cast<std::size_t>(written - first));
+            for (std::uint64_t i = first; i < written; ++i)
+            {
+                const Event& event = buffer.mEvents[i % buffer.mCapacity];
+                result.push_back(EventCopy {event.mName.load(std::memory_order_relaxed),
+                    event.mBegin.load(std::memory_order_relaxed), event.mEnd.load(std::memory_order_relaxed)});
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            const std::uint64_t started = buffer.mStarted.load(std::memory_order_relaxed);
+            const std::uint64_t valid = started > buffer.mCapacity ? started - buffer.mCapacity : 0;
+            if (valid > first)
+                result.erase(result.begin(), result.begin() + static_cast<std::ptrdiff_t>(std::min(valid, written) - first));
+            return result;
+        }
+    }
+
+    namespace Trace
+    {
+        std::atomic<bool> sEnabled {false};
+
+        std::int64_t now()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        void record(const char* name, std::int64_t begin, std::int64_t end)
+        {
+            ThreadBuffer& buffer = getThreadBuffer();
+            const std::uint64_t index = buffer.mWritten.load(std::memory_order_relaxed);
+            buffer.mStarted.store(index + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            Event& event = buffer.mEvents[index % buffer.mCapacity];
+            event.mName.store(name, std::memory_order_relaxed);
+            event.mBegin.store(begin, std::memory_order_relaxed);
+            event.mEnd.store(end, std::memory_order_relaxed);
+            buffer.mWritten.store(index + 1, std::memory_order_release);
+        }
+    }
+
+    void enableTrace(const std::string& path, std::size_t eventsPerThread)
+    {
+        Registry& registry = getRegistry();
+        {
+            const std::lock_guard<std::mutex> lock(registry.mMutex);
+            registry.mPath = path;
+            registry.mEventsPerThread = std::max<std::size_t>(eventsPerThread, 1);
+            registry.mStart = Trace::now();
+        }
+        Trace::sEnabled.store(true, std::memory_order_relaxed);
+    }
+
+    const std::string& getTracePath()
+    {
+        return getRegistry().mPath;
+    }
+
+    void setTraceThreadName(std::string_view name)
+    {
+        sThreadName = name;
+        if (sBuffer == nullptr)
+            return;
+        Registry& registry = getRegistry();
+        const std::lock_guard<std::mutex> lock(registry.mMutex);
+        sBuffer->mName = sThreadName;
+    }
+
+    void writeTrace(std::ostream& stream)
+    {
+        Registry& registry = getRegistry();
+        const std::lock_guard<std::mutex> lock(registry.mMutex);
+
+        stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        bool first = true;
+        const auto separate = [&]
+        {
+            if (!first)
+                stream << ',';
+            first = false;
+            stream << '\n';
+        };
+
+        for (const std::unique_ptr<ThreadBuffer>& buffer : registry.mBuffers)
+        {
+            separate();
+            stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->mId
+                << ",\"args\":{\"name\":";
+            writeString(stream, buffer->mName);
+            stream << "}}";
+
+            for (const EventCopy& event : copyEvents(*buffer))
+            {
+                separate();
+                stream << "{\"name\":";
+                writeString(stream, event.mName);
+                stream << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->mId << ",\"ts\":";
+                writeMicroseconds(stream, event.mBegin - registry.mStart);
+                stream << ",\"dur\":";
+                writeMicroseconds(stream, event.mEnd - event.mBegin);
+                stream << '}';
+            }
+        }
+
+        stream << "\n]}\n";
+    }
+
+    void writeTrace()
+    {
+        const std::string path = getTracePath();
+        std::ofstream stream(path, std::ios::binary);
+        writeTrace(stream);
+        stream.close();
+        if (stream.fail())
+            throw std::runtime_error("Failed to write trace to " + path);
+    }
+}
@@ -0,0 +1,71 @@
+#ifndef OPENMW_COMPONENTS_DEBUG_TRACE_H
+#define OPENMW_COMPONENTS_DEBUG_TRACE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+
+namespace Debug
+{
+    // Timeline of scoped zones recorded by all threads, written in the Chrome trace event format that is read by
+    // chrome://tracing and https://ui.perfetto.dev. Each thread records into its own ring buffer without locking, so
+    // the last events before a hitch can be written at any time. Zones cost a relaxed atomic load when disabled.
+
+    namespace Trace
+    {
+        extern std::atomic<bool> sEnabled;
+
+        std::int64_t now();
+
+        void record(const char* name, std::int64_t begin, std::int64_t end);
+    }
+
+    // Starts recording, to be called once at startup. Each thread keeps its last eventsPerThread zones.
+    void enableTrace(const std::string& path, std::size_t eventsPerThread = 1 << 16);
+
+    inline bool isTraceEnabled()
+    {
+        return Trace::sEnabled.load(std::memory_order_relaxed);
+    }
+
+    // Path given to enableTrace
+    const std::string& getTracePath();
+
+    // Names the calling thread in the trace
+    void setTraceThreadName(std::string_view name);
+
+    // Writes the zones recorded by all threads so far
+    void writeTrace(std::ostream& stream);
+
+    // Writes the zones to the path given to enableTrace, throws if the file can't be written
+    void writeTrace();
+
+    class TraceZone
+    {
+        public:
+            // @param name must outlive the trace, usually a string literal
+            explicit TraceZone(const char* name)
+                : mName(isTraceEnabled() ? name : nullptr)
+                , mBegin(mName == nullptr ? 0 : Trace::now())
+            {
+            }
+
+            TraceZone(const TraceZone&) = delete;
+            TraceZone& operator=(const TraceZone&) = delete;
+
+            ~TraceZone()
+            {
+                if (mName != nullptr)
+                    Trace::record(mName, mBegin, Trace::now());
+            }
+
+        private:
+            const char* const mName;
+            const std::int64_t mBegin;
+    };
+}
+
+#endif
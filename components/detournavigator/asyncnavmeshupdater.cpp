@@ -8,6 +8,7 @@
 #include "dbrefgeometryobject.hpp"
 
 #include <components/debug/debuglog.hpp>
+#include <components/debug/trace.hpp>
 #include <components/misc/thread.hpp>
 #include <components/loadinglistener/loadinglistener.hpp>
 
@@ -329,6 +330,7 @@ namespace DetourNavigator
     {
         Log(Debug::Debug) << "Start process navigator jobs by thread=" << std::this_thread::get_id();
         Misc::setCurrentThreadIdlePriority();
+        Debug::setTraceThreadName("NavMeshUpdater");
         while (!mShouldStop)
         {
             try
@@ -369,6 +371,7 @@ namespace DetourNavigator
 
     JobStatus AsyncNavMeshUpdater::processJob(Job& job)
     {
+        const Debug::TraceZone zone("navmeshjob");
         Log(Debug::Debug) << "Processing job " << job.mId << " by thread=" << std::this_thread::get_id();
 
         const auto navMeshCacheItem = job.mNavMeshCacheItem.lock();
@@ -752,6 +755,7 @@ namespace DetourNavigator
 
     void DbWorker::run() noexcept
     {
+        Debug::setTraceThreadName("NavMeshDb");
         while (!mShouldStop)
         {
             try
@@ -768,6 +772,7 @@ namespace DetourNavigator
 
     void DbWorker::processJob(JobIt job)
     {
+        const Debug::TraceZone zone("navmeshdbjob");
         const auto process = [&] (auto f)
         {
             try
@@ -60,6 +60,8 @@ namespace DetourNavigator
                 RecastMeshProvider recastMeshProvider, const osg::Vec3f& agentHalfExtents, const Settings& settings,
                 std::weak_ptr<NavMeshTileConsumer> consumer);
 
+        const char* getTraceName() const final { return "generatenavmeshtile"; }
+
         void doWork() final;
 
     private:
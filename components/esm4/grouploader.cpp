@@ -0,0 +1,136 @@
+#include "grouploader.hpp"
+
+#include "reader.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include <components/files/constrainedfilestream.hpp>
+
+namespace ESM4
+{
+    namespace
+    {
+        void enterGroup(Reader& reader)
+        {
+            switch (static_cast<GroupType>(reader.hdr().group.type))
+            {
+                case Grp_RecordType:
+                case Grp_InteriorCell:
+                case Grp_InteriorSubCell:
+                case Grp_ExteriorCell:
+                case Grp_ExteriorSubCell:
+                    reader.enterGroup();
+                    return;
+                case Grp_WorldChild:
+                case Grp_CellChild:
+                case Grp_TopicChild:
+                case Grp_CellPersistentChild:
+                case Grp_CellTemporaryChild:
+                case Grp_CellVisibleDistChild:
+                    reader.adjustGRUPFormId();
+                    reader.enterGroup();
+                    return;
+            }
+
+            reader.skipGroup();
+        }
+
+        void readGroup(Reader& reader, const TopGroup& group, std::size_t index, const ReadRecord& readRecord)
+        {
+            const std::size_t end = group.mOffset + group.mHeader.groupSize;
+            reader.seekTopGroup(group.mOffset);
+            while (reader.getFileRead() < end)
+            {
+                reader.exitGroupCheck();
+                if (!reader.getRecordHeader())
+                    reader.fail("Unexpected end of group");
+                if (reader.hdr().record.typeId == REC_GRUP)
+                    enterGroup(reader);
+                else
+                    readRecord(reader, index);
+            }
+        }
+    }
+
+    std::vector<TopGroup> indexTopGroups(const Reader& reader)
+    {
+        const Files::IStreamPtr stream = Files::openConstrainedFileStream(reader.getFileName());
+        const std::size_t headerSize = reader.getRecHeaderSize();
+        const std::size_t fileSize = reader.getFileSize();
+
+        RecordHeader header;
+        if (!stream->read(reinterpret_cast<char*>(&header), headerSize))
+            throw std::runtime_error("ESM4::indexTopGroups failed to read the file header of " + reader.getFileName());
+
+        std::vector<TopGroup> result;
+        std::size_t offset = headerSize + header.record.dataSize;
+        while (offset + headerSize <= fileSize)
+        {
+            stream->seekg(offset);
+            if (!stream->read(reinterpret_cast<char*>(&header), headerSize))
+                throw std::runtime_error("ESM4::indexTopGroups failed to read a group header of "
+                    + reader.getFileName());
+            if (header.group.typeId != REC_GRUP || header.group.groupSize < headerSize)
+                throw std::runtime_error("ESM4::indexTopGroups invalid top level group in " + reader.getFileName());
+            result.push_back(TopGroup {offset, header.group});
+            offset += header.group.groupSize;
+        }
+
+        return result;
+    }
+
+    void readGroups(const Reader& reader, const std::vector<TopGroup>& groups, std::size_t threads,
+        const ReadRecord& readRecord)
+    {
+        const std::size_t workers = std::clamp<std::size_t>(threads, 1, std::max<std::size_t>(groups.size(), 1));
+
+        std::atomic_size_t nextGroup {0};
+        std::atomic_bool failed {false};
+        std::mutex mutex;
+        std::exception_ptr error;
+        std::size_t errorGroup = groups.size();
+
+        const auto work = [&]
+        {
+            std::size_t group = groups.size();
+            try
+            {
+                const std::unique_ptr<Reader> groupReader = reader.clone();
+                while (!failed)
+                {
+                    group = nextGroup++;
+                    if (group >= groups.size())
+                        return;
+                    readGroup(*groupReader, groups[group], group, readRecord);
+                }
+            }
+            catch (...)
+            {
+                failed = true;
+                const std::lock_guard<std::mutex> lock(mutex);
+                // Report the error of the first failed group in the file order
+                if (error == nullptr || group < errorGroup)
+                {
+                    error = std::current_exception();
+                    errorGroup = group;
+                }
+            }
+        };
+
+        std::vector<std::thread> pool;
+        pool.reserve(workers - 1);
+        for (std::size_t i = 1; i < workers; ++i)
+            pool.emplace_back(work);
+        work();
+        for (std::thread& thread : pool)
+            thread.join();
+
+        if (error != nullptr)
+            std::rethrow_exception(error);
+    }
+}
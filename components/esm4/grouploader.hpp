@@ -0,0 +1,51 @@
+#ifndef OPENMW_COMPONENTS_ESM4_GROUPLOADER_H
+#define OPENMW_COMPONENTS_ESM4_GROUPLOADER_H
+
+#include "common.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace ESM4
+{
+    class Reader;
+
+    struct TopGroup
+    {
+        // Offset of the group header in the file
+        std::size_t mOffset;
+        GroupTypeHeader mHeader;
+    };
+
+    // Top level groups of the file in the file order, found by seeking from one group header to the next without
+    // reading the records
+    std::vector<TopGroup> indexTopGroups(const Reader& reader);
+
+    // Called for each record of a group with its header read, the record data must be read or skipped
+    using ReadRecord = std::function<void(Reader& reader, std::size_t group)>;
+
+    // Reads the records of the groups with up to the given number of threads. Each thread reads with its own clone
+    // of the reader, so its own file stream, inflate context and buffers. The records of a group are read in the
+    // file order by a single thread, readRecord is called concurrently for different groups.
+    // NOTE: the reader must be set up (encoder, mod index and updateModIndices()) before, the clones share the
+    // FormId fix-ups.
+    void readGroups(const Reader& reader, const std::vector<TopGroup>& groups, std::size_t threads,
+        const ReadRecord& readRecord);
+
+    // Reads each group into its own Result in parallel, then calls insert with the results in the file order, so that
+    // the insertion order does not depend on the number of threads
+    template <class Result, class Read, class Insert>
+    void loadGroups(const Reader& reader, std::size_t threads, Read&& read, Insert&& insert)
+    {
+        const std::vector<TopGroup> groups = indexTopGroups(reader);
+        std::vector<Result> results(groups.size());
+        readGroups(reader, groups, threads,
+            [&] (Reader& groupReader, std::size_t group) { read(groupReader, results[group]); });
+        for (Result& result : results)
+            insert(std::move(result));
+    }
+}
+
+#endif
@@ -29,7 +29,9 @@
 #undef DEBUG_GROUPSTACK
 
 #include <cassert>
+#include <optional>
 #include <stdexcept>
+#include <string_view>
 #include <unordered_map>
 #include <iostream> // for debugging
 #include <sstream>  // for debugging
@@ -43,13 +45,11 @@
 #else
     #include <boost/iostreams/filter/zlib.hpp>
 #endif
-#include <boost/iostreams/filtering_streambuf.hpp>
-#include <boost/iostreams/copy.hpp>
 #include <boost/algorithm/string.hpp>
 #include <boost/filesystem/path.hpp>
 #include <boost/filesystem/operations.hpp>
 
-#include <components/bsa/memorystream.hpp>
+#include <components/files/memorystream.hpp>
 
 #include "formid.hpp"
 
@@ -64,6 +64,17 @@ ReaderContext::ReaderContext() : modIndex(0), recHeaderSize(sizeof(RecordHeader)
     currCellGrid.grid.y = 0;
 }
 
+struct Reader::Inflater
+{
+    // Keeps the zlib stream and its buffers between the records, it is only reset after each record
+    boost::iostreams::zlib_decompressor mDecompressor;
+};
+
+Reader::Reader()
+    : mEncoder(nullptr), mFileSize(0)
+{
+}
+
 Reader::Reader(Files::IStreamPtr&& esmStream, const std::string& filename)
     : mEncoder(nullptr), mFileSize(0), mStream(std::move(esmStream))
 {
@@ -113,6 +124,33 @@ Reader::~Reader()
     close();
 }
 
+std::unique_ptr<Reader> Reader::clone() const
+{
+    std::unique_ptr<Reader> result(new Reader);
+    result->mHeader = mHeader;
+    result->mCtx = mCtx;
+    result->mCtx.groupStack.clear();
+    result->mEncoder = mEncoder;
+    result->mFileSize = mFileSize;
+    result->mStream = Files::openConstrainedFileStream(mCtx.filename);
+    result->mStrings = mStrings;
+    result->mILStrings = mILStrings;
+    result->mDLStrings = mDLStrings;
+
+    return result;
+}
+
+void Reader::seekTopGroup(std::size_t offset)
+{
+    if (mSavedStream)
+        mStream = std::move(mSavedStream);
+
+    mCtx.groupStack.clear();
+    mCtx.fileRead = offset;
+    mStream->clear();
+    mStream->seekg(offset);
+}
+
 // Since the record data may have been compressed, it is not always possible to use seek() to
 // go to a position of a sub record.
 //
@@ -195,47 +233,9 @@ void Reader::buildLStringIndex()
     boost::filesystem::path p(mCtx.filename);
     std::string filename = p.stem().filename().string();
 
-    buildLStringIndex("Strings/" + filename + "_English.STRINGS",   Type_Strings);
-    buildLStringIndex("Strings/" + filename + "_English.ILSTRINGS", Type_ILStrings);
-    buildLStringIndex("Strings/" + filename + "_English.DLSTRINGS", Type_DLStrings);
-}
-
-void Reader::buildLStringIndex(const std::string& stringFile, LocalizedStringType stringType)
-{
-    std::uint32_t numEntries;
-    std::uint32_t dataSize;
-    std::uint32_t stringId;
-    LStringOffset sp;
-    sp.type = stringType;
-
-    // TODO: possibly check if the resource exists?
-    Files::IStreamPtr filestream = Files::openConstrainedFileStream(stringFile);
-
-    filestream->seekg(0, std::ios::end);
-    std::size_t fileSize = filestream->tellg();
-    filestream->seekg(0, std::ios::beg);
-
-    std::istream* stream = filestream.get();
-    switch (stringType)
-    {
-        case Type_Strings:   mStrings =   std::move(filestream); break;
-        case Type_ILStrings: mILStrings = std::move(filestream); break;
-        case Type_DLStrings: mDLStrings = std::move(filestream); break;
-        default:
-            throw std::runtime_error("ESM4::Reader::unknown localised string type");
-    }
-
-    stream->read((char*)&numEntries, sizeof(numEntries));
-    stream->read((char*)&dataSize, sizeof(dataSize));
-    std::size_t dataStart = fileSize - dataSize;
-    for (unsigned int i = 0; i < numEntries; ++i)
-    {
-        stream->read((char*)&stringId, sizeof(stringId));
-        stream->read((char*)&sp.offset, sizeof(sp.offset));
-        sp.offset += (std::uint32_t)dataStart;
-        mLStringIndex[stringId] = sp;
-    }
-    //assert (dataStart - stream->tell() == 0 && "String file start of data section mismatch");
+    mStrings =   std::make_shared<StringTable>("Strings/" + filename + "_English.STRINGS",   false);
+    mILStrings = std::make_shared<StringTable>("Strings/" + filename + "_English.ILSTRINGS", true);
+    mDLStrings = std::make_shared<StringTable>("Strings/" + filename + "_English.DLSTRINGS", true);
 }
 
 void Reader::getLocalizedString(std::string& str)
@@ -249,46 +249,25 @@ void Reader::getLocalizedString(std::string& str)
         getLocalizedStringImpl(stringId, str);
 }
 
-// FIXME: very messy and probably slow/inefficient
 void Reader::getLocalizedStringImpl(const FormId stringId, std::string& str)
 {
-    const std::map<FormId, LStringOffset>::const_iterator it = mLStringIndex.find(stringId);
-
-    if (it != mLStringIndex.end())
+    // An id in several files resolves to the DLSTRINGS entry, then to the ILSTRINGS one, like the index that was
+    // filled from STRINGS, ILSTRINGS and DLSTRINGS in that order with later entries replacing earlier ones
+    std::optional<std::string_view> value;
+    for (const StringTable* table : { mDLStrings.get(), mILStrings.get(), mStrings.get() })
     {
-        std::istream* filestream = nullptr;
-
-        switch (it->second.type)
-        {
-            case Type_Strings: // no string size provided
-            {
-                filestream = mStrings.get();
-                filestream->seekg(it->second.offset);
-
-                char ch;
-                std::vector<char> data;
-                do {
-                    filestream->read(&ch, sizeof(ch));
-                    data.push_back(ch);
-                } while (ch != 0);
-
-                str = std::string(data.data());
-                return;
-            }
-            case Type_ILStrings: filestream = mILStrings.get(); break;
-            case Type_DLStrings: filestream = mDLStrings.get(); break;
-            default:
-                throw std::runtime_error("ESM4::Reader::getLocalizedString unknown string type");
-        }
-
-        // get ILStrings or DLStrings (they provide string size)
-        filestream->seekg(it->second.offset);
-        std::uint32_t size = 0;
-        filestream->read((char*)&size, sizeof(size));
-        getStringImpl(str, size, *filestream, mEncoder, true); // expect null terminated string
+        if (table != nullptr && (value = table->find(stringId)))
+            break;
     }
-    else
+
+    if (!value)
         throw std::runtime_error("ESM4::Reader::getLocalizedString localized string not found");
+
+    if (mEncoder == nullptr)
+        return (void)str.assign(*value);
+
+    std::string buffer;
+    str = mEncoder->getUtf8(*value, ToUTF8::BufferAllocationPolicy::FitToRequiredSize, buffer);
 }
 
 bool Reader::getRecordHeader()
@@ -332,28 +311,22 @@ void Reader::getRecordData(bool dump)
         mStream->read(reinterpret_cast<char*>(&uncompressedSize), sizeof(std::uint32_t));
 
         std::size_t recordSize = mCtx.recordHeader.record.dataSize - sizeof(std::uint32_t);
-        Bsa::MemoryInputStream compressedRecord(recordSize);
-        mStream->read(compressedRecord.getRawData(), recordSize);
-        std::istream *fileStream = (std::istream*)&compressedRecord;
+        mCompressedData.resize(recordSize);
+        mStream->read(mCompressedData.data(), recordSize);
         mSavedStream = std::move(mStream);
 
         mCtx.recordHeader.record.dataSize = uncompressedSize - sizeof(uncompressedSize);
 
-        auto memoryStreamPtr = std::make_unique<Bsa::MemoryInputStream>(uncompressedSize);
-
-        boost::iostreams::filtering_streambuf<boost::iostreams::input> inputStreamBuf;
-        inputStreamBuf.push(boost::iostreams::zlib_decompressor());
-        inputStreamBuf.push(*fileStream);
-
-        boost::iostreams::basic_array_sink<char> sr(memoryStreamPtr->getRawData(), uncompressedSize);
-        boost::iostreams::copy(inputStreamBuf, sr);
+        // The buffers are reused by the next records, the memory stream is gone by the next getRecordHeader()
+        mRecordData.resize(uncompressedSize);
+        inflate(mCompressedData.data(), recordSize, mRecordData.data(), uncompressedSize);
 
     // For debugging only
 //#if 0
 if (dump)
 {
         std::ostringstream ss;
-        char* data = memoryStreamPtr->getRawData();
+        char* data = mRecordData.data();
         for (unsigned int i = 0; i < uncompressedSize; ++i)
         {
             if (data[i] > 64 && data[i] < 91)
@@ -368,8 +341,36 @@ if (dump)
         std::cout << ss.str() << std::endl;
 }
 //#endif
-        mStream = std::make_unique<Files::StreamWithBuffer<Bsa::MemoryInputStream>>(std::move(memoryStreamPtr));
+        mStream = std::make_unique<Files::IMemStream>(mRecordData.data(), uncompressedSize);
+    }
+}
+
+void Reader::inflate(const char* data, std::size_t size, char* out, std::size_t outSize)
+{
+    if (mInflater == nullptr)
+        mInflater = std::make_unique<Inflater>();
+
+    auto& decompressor = mInflater->mDecompressor.filter();
+    const char* in = data;
+    char* outBegin = out;
+    try
+    {
+        bool more = true;
+        while (more && outBegin != out + outSize)
+        {
+            const char* const prevIn = in;
+            char* const prevOut = outBegin;
+            more = decompressor.filter(in, data + size, outBegin, out + outSize, true);
+            if (in == prevIn && outBegin == prevOut)
+                break; // truncated data
+        }
+    }
+    catch (...)
+    {
+        decompressor.close();
+        throw;
     }
+    decompressor.close();
 }
 
 void Reader::skipRecordData()
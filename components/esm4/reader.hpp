@@ -26,9 +26,12 @@
 #include <map>
 #include <cstddef>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "common.hpp"
 #include "loadtes4.hpp"
+#include "stringtable.hpp"
 #include "../esm/reader.hpp"
 
 namespace ESM4 {
@@ -85,26 +88,16 @@ namespace ESM4 {
         Files::IStreamPtr    mStream;
         Files::IStreamPtr    mSavedStream; // mStream is saved here while using deflated memory stream
 
-        Files::IStreamPtr    mStrings;
-        Files::IStreamPtr    mILStrings;
-        Files::IStreamPtr    mDLStrings;
+        // Reused for all the compressed records read by this reader
+        struct Inflater;
+        std::unique_ptr<Inflater> mInflater;
+        std::vector<char>    mCompressedData;
+        std::vector<char>    mRecordData;
 
-        enum LocalizedStringType
-        {
-            Type_Strings   = 0,
-            Type_ILStrings = 1,
-            Type_DLStrings = 2
-        };
-
-        struct LStringOffset
-        {
-            LocalizedStringType type;
-            std::uint32_t offset;
-        };
-
-        std::map<FormId, LStringOffset> mLStringIndex;
-
-        void buildLStringIndex(const std::string& stringFile, LocalizedStringType stringType);
+        // Shared with the clones of this reader
+        std::shared_ptr<const StringTable> mStrings;
+        std::shared_ptr<const StringTable> mILStrings;
+        std::shared_ptr<const StringTable> mDLStrings;
 
         inline bool hasLocalizedStrings() const { return (mHeader.mFlags & Rec_Localized) != 0; }
 
@@ -121,13 +114,19 @@ namespace ESM4 {
         // Closes the currently open file first, if any.
         void open(Files::IStreamPtr&& stream, const std::string& filename);
 
-        Reader() = default;
+        void inflate(const char* data, std::size_t size, char* out, std::size_t outSize);
+
+        Reader();
 
     public:
 
         Reader(Files::IStreamPtr&& esmStream, const std::string& filename);
         ~Reader();
 
+        // Opens another reader on the same file, with the header, mod indices, encoder and localised strings index
+        // of this one, to read different groups of the file concurrently
+        std::unique_ptr<Reader> clone() const;
+
         // FIXME: should be private but ESMTool uses it
         void openRaw(const std::string& filename)
         {
@@ -160,6 +159,15 @@ namespace ESM4 {
         inline std::size_t getFileSize() const { return mFileSize; }
         inline std::size_t getFileOffset() const { return mStream->tellg(); }
 
+        // Position in the file after the last record or group header read, unlike getFileOffset() it does not
+        // depend on the record being compressed
+        inline std::size_t getFileRead() const { return mCtx.fileRead; }
+
+        inline std::size_t getRecHeaderSize() const { return mCtx.recHeaderSize; }
+
+        // Moves to the header of a top level group, see ESM4::indexTopGroups()
+        void seekTopGroup(std::size_t offset);
+
         // Methods added for saving/restoring context
         ReaderContext getContext(); // WARN: must be called immediately after reading the record header
 
@@ -186,6 +194,7 @@ namespace ESM4 {
         inline unsigned int esmVersion() const { return mHeader.mData.version.ui; }
         inline unsigned int numRecords() const { return mHeader.mData.records; }
 
+        // The string files are only mapped and indexed by the first lookup
         void buildLStringIndex();
         void getLocalizedString(std::string& str);
 
@@ -0,0 +1,100 @@
+#include "stringtable.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include <boost/iostreams/device/mapped_file.hpp>
+
+namespace ESM4
+{
+    namespace
+    {
+        template <class T>
+        T readAt(std::string_view data, std::size_t offset)
+        {
+            T result;
+            std::memcpy(&result, data.data() + offset, sizeof(T));
+            return result;
+        }
+    }
+
+    struct StringTable::Mapping
+    {
+        boost::iostreams::mapped_file_source mFile;
+    };
+
+    StringTable::StringTable(const std::string& path, bool sizePrefixed)
+        : mPath(path)
+        , mSizePrefixed(sizePrefixed)
+    {
+    }
+
+    StringTable::~StringTable() = default;
+
+    void StringTable::load() const
+    {
+        auto mapping = std::make_unique<Mapping>();
+        try
+        {
+            mapping->mFile.open(mPath);
+        }
+        catch (const std::exception& e)
+        {
+            throw std::runtime_error("ESM4::StringTable failed to map " + mPath + ": " + e.what());
+        }
+
+        const std::string_view file(mapping->mFile.data(), mapping->mFile.size());
+        if (file.size() < 2 * sizeof(std::uint32_t))
+            throw std::runtime_error("ESM4::StringTable file is too small: " + mPath);
+
+        const std::uint32_t numEntries = readAt<std::uint32_t>(file, 0);
+        const std::uint32_t dataSize = readAt<std::uint32_t>(file, sizeof(std::uint32_t));
+        const std::size_t directoryEnd = 2 * sizeof(std::uint32_t) + std::size_t(numEntries) * sizeof(Entry);
+        if (dataSize > file.size() || directoryEnd > file.size() - dataSize)
+            throw std::runtime_error("ESM4::StringTable invalid directory: " + mPath);
+
+        static_assert(sizeof(Entry) == 2 * sizeof(std::uint32_t));
+        std::vector<Entry> index(numEntries);
+        std::memcpy(index.data(), file.data() + 2 * sizeof(std::uint32_t), numEntries * sizeof(Entry));
+        // The directory is usually sorted already. Keep the last entry of a duplicated id, like the former
+        // std::map index did.
+        const auto less = [] (const Entry& left, const Entry& right) { return left.mId < right.mId; };
+        if (!std::is_sorted(index.begin(), index.end(), less))
+            std::stable_sort(index.begin(), index.end(), less);
+
+        mData = file.substr(file.size() - dataSize);
+        mIndex = std::move(index);
+        mMapping = std::move(mapping);
+    }
+
+    std::optional<std::string_view> StringTable::find(FormId id) const
+    {
+        std::call_once(mLoaded, [this] { load(); });
+
+        const auto it = std::upper_bound(mIndex.begin(), mIndex.end(), id,
+            [] (FormId value, const Entry& entry) { return value < entry.mId; });
+        if (it == mIndex.begin() || std::prev(it)->mId != id)
+            return std::nullopt;
+
+        const std::size_t offset = std::prev(it)->mOffset;
+        if (mSizePrefixed)
+        {
+            if (offset > mData.size() || mData.size() - offset < sizeof(std::uint32_t))
+                throw std::runtime_error("ESM4::StringTable invalid string offset: " + mPath);
+            const std::uint32_t size = readAt<std::uint32_t>(mData, offset);
+            if (mData.size() - offset - sizeof(std::uint32_t) < size)
+                throw std::runtime_error("ESM4::StringTable invalid string size: " + mPath);
+            std::string_view result = mData.substr(offset + sizeof(std::uint32_t), size);
+            // The size includes the null terminator
+            if (!result.empty() && result.back() == '\0')
+                result.remove_suffix(1);
+            return result;
+        }
+
+        const std::size_t end = offset < mData.size() ? mData.find('\0', offset) : std::string_view::npos;
+        if (end == std::string_view::npos)
+            throw std::runtime_error("ESM4::StringTable unterminated string: " + mPath);
+        return mData.substr(offset, end - offset);
+    }
+}
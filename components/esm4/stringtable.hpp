@@ -0,0 +1,54 @@
+#ifndef OPENMW_COMPONENTS_ESM4_STRINGTABLE_H
+#define OPENMW_COMPONENTS_ESM4_STRINGTABLE_H
+
+#include "formid.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ESM4
+{
+    // A STRINGS, ILSTRINGS or DLSTRINGS file of a localised master. The file is memory mapped and its directory is
+    // only read by the first lookup, so that unused string files cost nothing. Strings are views into the mapping
+    // and stay valid as long as the table.
+    class StringTable
+    {
+        public:
+            // STRINGS files have null terminated strings, ILSTRINGS and DLSTRINGS files have the size before
+            // each string
+            StringTable(const std::string& path, bool sizePrefixed);
+            ~StringTable();
+
+            // Thread safe. Throws if the file can't be mapped or is invalid.
+            // @return the string without its null terminator
+            std::optional<std::string_view> find(FormId id) const;
+
+            const std::string& getPath() const { return mPath; }
+
+        private:
+            struct Mapping;
+
+            struct Entry
+            {
+                FormId mId;
+                std::uint32_t mOffset; // from the start of the string data
+            };
+
+            const std::string mPath;
+            const bool mSizePrefixed;
+            mutable std::once_flag mLoaded;
+            mutable std::unique_ptr<Mapping> mMapping;
+            mutable std::string_view mData; // string data, after the directory
+            mutable std::vector<Entry> mIndex; // sorted by id
+
+            void load() const;
+    };
+}
+
+#endif
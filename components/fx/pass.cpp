@@ -1,5 +1,6 @@
 #include "pass.hpp"
 
+#include <algorithm>
 #include <unordered_set>
 #include <string>
 #include <sstream>
@@ -11,6 +12,8 @@
 #include <osg/BindImageTexture>
 #include <osg/FrameBufferObject>
 
+#include <SDL_opengl_glext.h>
+
 #include <components/misc/stringops.hpp>
 #include <components/sceneutil/util.hpp>
 #include <components/sceneutil/lightmanager.hpp>
@@ -48,6 +51,31 @@ namespace fx
     {
     }
 
+    std::optional<GLenum> Pass::getImageFormat(GLint internalFormat)
+    {
+        switch (internalFormat)
+        {
+            case GL_RED:
+            case GL_R8:
+                return GL_R8;
+            case GL_RG:
+            case GL_RG8:
+                return GL_RG8;
+            case GL_RGBA:
+            case GL_RGBA8:
+                return GL_RGBA8;
+            case GL_R16F:
+            case GL_R32F:
+            case GL_RG16F:
+            case GL_RG32F:
+            case GL_RGBA16F:
+            case GL_RGBA32F:
+                return internalFormat;
+            default:
+                return std::nullopt;
+        }
+    }
+
     std::string Pass::getPassHeader(Technique& technique, std::string_view preamble, bool fragOut)
     {
         std::string header = R"GLSL(
@@ -72,6 +100,7 @@ namespace fx
 #define omw_FragColor @fragColor
 
 @fragBinding
+@computeBinding
 
 uniform @builtinSampler omw_SamplerLastShader;
 uniform @builtinSampler omw_SamplerLastPass;
@@ -167,13 +196,18 @@ float omw_GetPointLightRadius(int index)
     }
 )GLSL";
 
+        const std::string computeBinding = "#define OMW_WORK_GROUP_SIZE " + std::to_string(sComputeWorkGroupSize) + R"GLSL(
+layout(local_size_x = OMW_WORK_GROUP_SIZE, local_size_y = OMW_WORK_GROUP_SIZE) in;
+layout(binding = 0) uniform writeonly image2D omw_ImageOutput;
+)GLSL";
+
         std::stringstream extBlock;
         for (const auto& extension : technique.getGLSLExtensions())
             extBlock << "#ifdef " << extension << '\n' << "\t#extension " << extension << ": enable" << '\n' << "#endif" << '\n';
 
         const std::vector<std::pair<std::string,std::string>> defines = {
             {"@pointLightCount", std::to_string(SceneUtil::PPLightBuffer::sMaxPPLightsArraySize)},
-            {"@version", std::to_string(technique.getGLSLVersion())},
+            {"@version", std::to_string(mType == Type::Compute ? std::max(technique.getGLSLVersion(), 430) : technique.getGLSLVersion())},
             {"@multiview", Stereo::getMultiview() ? "1" : "0"},
             {"@builtinSampler", Stereo::getMultiview() ? "sampler2DArray" : "sampler2D"},
             {"@profile", technique.getGLSLProfile()},
@@ -193,7 +227,8 @@ float omw_GetPointLightRadius(int index)
             {"@vertex", mLegacyGLSL ? "gl_Vertex" : "_omw_Vertex"},
             {"@fragColor", mLegacyGLSL ? "gl_FragColor" : "_omw_FragColor"},
             {"@useBindings", mLegacyGLSL ? "0" : "1"},
-            {"@fragBinding", mLegacyGLSL ? "" : "out vec4 omw_FragColor;"}
+            {"@fragBinding", mLegacyGLSL || mType == Type::Compute ? "" : "out vec4 omw_FragColor;"},
+            {"@computeBinding", mType == Type::Compute ? computeBinding : ""}
         };
 
         for (const auto& [define, value]: defines)
@@ -227,7 +262,7 @@ float omw_GetPointLightRadius(int index)
 
         program->setName(name);
 
-        if (!mLegacyGLSL)
+        if (!mLegacyGLSL && mType == Type::Pixel)
         {
             program->addBindFragDataLocation("_omw_FragColor", 0);
             program->addBindAttribLocation("_omw_Vertex", 0);
@@ -258,7 +293,7 @@ float omw_GetPointLightRadius(int index)
         if (mCompiled)
             return;
 
-        mLegacyGLSL = technique.getGLSLVersion() != 330;
+        mLegacyGLSL = technique.getGLSLVersion() != 330 && mType != Type::Compute;
 
         if (mType == Type::Pixel)
         {
@@ -39,6 +39,12 @@ namespace fx
 
         friend class Technique;
 
+        // Width and height of the work groups that compute passes are dispatched in
+        static constexpr int sComputeWorkGroupSize = 16;
+
+        // Format to bind a texture with the given internal format to the image written by compute passes
+        static std::optional<GLenum> getImageFormat(GLint internalFormat);
+
         Pass(Type type=Type::Pixel, Order order=Order::Post, bool ubo = false);
 
         void compile(Technique& technique, std::string_view preamble);
@@ -49,6 +55,8 @@ namespace fx
 
         std::string getName() const { return mName; }
 
+        Type getType() const { return mType; }
+
         void dirty();
 
     private:
@@ -0,0 +1,355 @@
+#include "passfusion.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <unordered_set>
+
+namespace
+{
+    bool isIdentifierStart(char c)
+    {
+        return std::isalpha(static_cast<unsigned char>(c)) || c == '_';
+    }
+
+    bool isIdentifierChar(char c)
+    {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+    }
+
+    bool isSpace(char c)
+    {
+        return std::isspace(static_cast<unsigned char>(c));
+    }
+
+    // Replaces comments with spaces, keeping newlines so that offsets and line numbers don't change
+    std::string stripComments(std::string_view source)
+    {
+        std::string result(source);
+        for (std::size_t i = 0; i + 1 < result.size(); ++i)
+        {
+            if (result[i] != '/' || (result[i + 1] != '/' && result[i + 1] != '*'))
+                continue;
+            const bool block = result[i + 1] == '*';
+            std::size_t end = block ? result.find("*/", i + 2) : result.find('\n', i);
+            end = end == std::string::npos ? result.size() : end + (block ? 2 : 0);
+            for (; i < end; ++i)
+                if (result[i] != '\n')
+                    result[i] = ' ';
+            --i;
+        }
+        return result;
+    }
+
+    std::size_t skipToken(std::string_view text, std::size_t i)
+    {
+        // Numbers like 1.0e5 or 2u must not be taken for identifiers
+        const bool number = std::isdigit(static_cast<unsigned char>(text[i])) || text[i] == '.';
+        if (!number && !isIdentifierStart(text[i]))
+            return i + 1;
+        while (i < text.size() && (isIdentifierChar(text[i]) || (number && text[i] == '.')))
+            ++i;
+        return i;
+    }
+
+    std::string normalizeSpaces(std::string_view text)
+    {
+        std::string result;
+        for (const char c : text)
+        {
+            if (!isSpace(c))
+                result += c;
+            else if (!result.empty() && result.back() != ' ')
+                result += ' ';
+        }
+        if (!result.empty() && result.back() == ' ')
+            result.pop_back();
+        return result;
+    }
+
+    struct Declaration
+    {
+        std::size_t mBegin = 0;
+        std::size_t mEnd = 0;
+        bool mFunction = false;
+        std::vector<std::string> mNames;
+    };
+
+    struct Shader
+    {
+        std::string mSource;
+        std::vector<Declaration> mDeclarations;
+        bool mDiscards = false;
+    };
+
+    // Splits a shader into its top level declarations and function definitions
+    std::optional<Shader> parseShader(std::string_view source)
+    {
+        Shader shader;
+        shader.mSource = stripComments(source);
+        const std::string_view text = shader.mSource;
+
+        int braces = 0;
+        int parentheses = 0;
+        bool lineStart = true;
+        bool parameters = false;
+        bool pendingName = true;
+        std::string_view lastIdentifier;
+        std::optional<Declaration> current;
+
+        const auto captureName = [&]
+        {
+            if (pendingName && !lastIdentifier.empty())
+            {
+                current->mNames.emplace_back(lastIdentifier);
+                pendingName = false;
+            }
+            lastIdentifier = {};
+        };
+
+        const auto finishDeclaration = [&] (std::size_t end)
+        {
+            current->mEnd = end;
+            shader.mDeclarations.push_back(std::move(*current));
+            current.reset();
+            parameters = false;
+            pendingName = true;
+            lastIdentifier = {};
+        };
+
+        for (std::size_t i = 0; i < text.size();)
+        {
+            const char c = text[i];
+
+            if (isSpace(c))
+            {
+                lineStart = lineStart || c == '\n';
+                ++i;
+                continue;
+            }
+
+            if (c == '#' && lineStart)
+            {
+                std::size_t begin = i + 1;
+                while (begin < text.size() && (text[begin] == ' ' || text[begin] == '\t'))
+                    ++begin;
+                std::size_t end = begin;
+                while (end < text.size() && isIdentifierChar(text[end]))
+                    ++end;
+                const std::string_view directive = text.substr(begin, end - begin);
+
+                // Other directives would change the meaning of the shaders fused after this one
+                const bool conditional = directive == "if" || directive == "ifdef" || directive == "ifndef"
+                    || directive == "elif" || directive == "else" || directive == "endif";
+                if (directive != "line" && (braces == 0 || !conditional))
+                    return std::nullopt;
+
+                i = text.find('\n', i);
+                if (i == std::string_view::npos)
+                    i = text.size();
+                continue;
+            }
+
+            lineStart = false;
+
+            if (braces == 0 && !current)
+            {
+                current = Declaration();
+                current->mBegin = i;
+            }
+
+            const std::size_t next = skipToken(text, i);
+
+            if (isIdentifierStart(c))
+            {
+                const std::string_view identifier = text.substr(i, next - i);
+                if (identifier == "discard")
+                    shader.mDiscards = true;
+                if (braces == 0 && parentheses == 0)
+                    lastIdentifier = identifier;
+                i = next;
+                continue;
+            }
+
+            if (braces == 0)
+            {
+                switch (c)
+                {
+                    case '(':
+                        if (parentheses++ == 0 && lastIdentifier != "layout")
+                        {
+                            parameters = !lastIdentifier.empty();
+                            captureName();
+                        }
+                        lastIdentifier = {};
+                        break;
+                    case ')':
+                        if (--parentheses < 0)
+                            return std::nullopt;
+                        break;
+                    case '=':
+                    case '[':
+                        if (parentheses == 0)
+                            captureName();
+                        break;
+                    case ',':
+                        if (parentheses == 0)
+                        {
+                            captureName();
+                            pendingName = true;
+                        }
+                        break;
+                    case ';':
+                        if (parentheses == 0)
+                        {
+                            captureName();
+                            finishDeclaration(i + 1);
+                        }
+                        break;
+                    case '{':
+                        captureName();
+                        current->mFunction = parameters;
+                        ++braces;
+                        break;
+                    case '}':
+                        return std::nullopt;
+                }
+            }
+            else if (c == '{')
+                ++braces;
+            else if (c == '}' && --braces == 0)
+            {
+                if (current->mFunction)
+                    finishDeclaration(i + 1);
+                else
+                    pendingName = true;
+            }
+
+            i = next;
+        }
+
+        if (braces != 0 || parentheses != 0 || current)
+            return std::nullopt;
+
+        return shader;
+    }
+}
+
+namespace fx
+{
+    bool readsLastPassPerFragment(std::string_view source)
+    {
+        const std::string stripped = stripComments(source);
+        const std::string_view text = stripped;
+
+        for (std::size_t i = 0; i < text.size();)
+        {
+            const std::size_t next = skipToken(text, i);
+            const std::string_view token = text.substr(i, next - i);
+            i = next;
+
+            if (token == "omw_SamplerLastPass")
+                return false;
+
+            if (token != "omw_GetLastPass")
+                continue;
+
+            while (i < text.size() && isSpace(text[i]))
+                ++i;
+            if (i == text.size() || text[i] != '(')
+                return false;
+
+            const std::size_t begin = ++i;
+            for (int depth = 1; i < text.size() && depth > 0; ++i)
+            {
+                if (text[i] == '(')
+                    ++depth;
+                else if (text[i] == ')')
+                    --depth;
+            }
+
+            if (normalizeSpaces(text.substr(begin, i - 1 - begin)) != "omw_TexCoord")
+                return false;
+        }
+
+        return true;
+    }
+
+    std::optional<std::string> fuseFragmentShaders(const std::vector<std::string_view>& sources)
+    {
+        std::unordered_set<std::string> declarations;
+        std::unordered_set<std::string> names;
+
+        std::string result = "\nvec4 _omw_FusedLastPass;\n";
+
+        for (std::size_t i = 0; i < sources.size(); ++i)
+        {
+            std::optional<Shader> shader = parseShader(sources[i]);
+            if (!shader)
+                return std::nullopt;
+
+            // A discarded fragment would also skip the passes fused after this one
+            if (shader->mDiscards && i + 1 < sources.size())
+                return std::nullopt;
+
+            if (i > 0 && !readsLastPassPerFragment(sources[i]))
+                return std::nullopt;
+
+            const auto isMain = [] (const Declaration& declaration)
+            {
+                return declaration.mFunction && declaration.mNames == std::vector<std::string> {"main"};
+            };
+            if (std::find_if(shader->mDeclarations.begin(), shader->mDeclarations.end(), isMain) == shader->mDeclarations.end())
+                return std::nullopt;
+
+            std::string& body = shader->mSource;
+            std::vector<std::string> newNames;
+
+            for (const Declaration& declaration : shader->mDeclarations)
+            {
+                if (!declaration.mFunction)
+                {
+                    // Inputs like omw_TexCoord are declared by every pass
+                    const std::string text = normalizeSpaces(
+                        std::string_view(body).substr(declaration.mBegin, declaration.mEnd - declaration.mBegin));
+                    if (!declarations.insert(text).second)
+                    {
+                        for (std::size_t j = declaration.mBegin; j < declaration.mEnd; ++j)
+                            if (body[j] != '\n')
+                                body[j] = ' ';
+                        continue;
+                    }
+                }
+
+                for (const std::string& name : declaration.mNames)
+                {
+                    if (name == "main")
+                        continue;
+                    if (names.count(name))
+                        return std::nullopt;
+                    newNames.push_back(name);
+                }
+            }
+
+            names.insert(newNames.begin(), newNames.end());
+
+            if (i == 1)
+                result += "#define omw_GetLastPass(uv) _omw_FusedLastPass\n";
+
+            result += "#define main _omw_FusedPass" + std::to_string(i) + "\n";
+            result += body;
+            result += "\n#undef main\n";
+        }
+
+        result += "\nvoid main()\n{\n";
+        for (std::size_t i = 0; i < sources.size(); ++i)
+        {
+            if (i > 0)
+                // Unfused passes hand their output over in an 8 bit normalized buffer
+                result += "    _omw_FusedLastPass = clamp(omw_FragColor, 0.0, 1.0);\n";
+            result += "    _omw_FusedPass" + std::to_string(i) + "();\n";
+        }
+        result += "}\n";
+
+        return result;
+    }
+}
@@ -0,0 +1,23 @@
+#ifndef OPENMW_COMPONENTS_FX_PASSFUSION_H
+#define OPENMW_COMPONENTS_FX_PASSFUSION_H
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fx
+{
+    // Whether a fragment shader reads the output of the previous pass only at the fragment it shades, so that it can
+    // take that output from the same program instead of a texture.
+    bool readsLastPassPerFragment(std::string_view source);
+
+    // Combines the fragment shaders of consecutive passes into one that runs their main functions in order. Every
+    // shader but the first one must read the previous pass only at the shaded fragment, which is clamped to [0, 1]
+    // like the buffers between unfused passes. Declarations repeated with the same text are kept once.
+    // @return std::nullopt if the shaders can't share a program, e.g. because they declare the same names or use
+    // preprocessor directives outside of functions
+    std::optional<std::string> fuseFragmentShaders(const std::vector<std::string_view>& sources);
+}
+
+#endif
@@ -18,6 +18,7 @@
 #include <components/debug/debuglog.hpp>
 
 #include "parse_constants.hpp"
+#include "passfusion.hpp"
 
 namespace
 {
@@ -37,7 +38,7 @@ namespace
 
 namespace fx
 {
-    Technique::Technique(const VFS::Manager& vfs, Resource::ImageManager& imageManager, const std::string& name, int width, int height, bool ubo, bool supportsNormals)
+    Technique::Technique(const VFS::Manager& vfs, Resource::ImageManager& imageManager, const std::string& name, int width, int height, bool ubo, bool supportsNormals, bool supportsCompute)
         : mName(name)
         , mFileName((std::filesystem::path(Technique::sSubdir) / (mName + Technique::sExt)).string())
         , mLastModificationTime(std::filesystem::file_time_type())
@@ -47,6 +48,7 @@ namespace fx
         , mImageManager(imageManager)
         , mUBO(ubo)
         , mSupportsNormals(supportsNormals)
+        , mSupportsCompute(supportsCompute)
     {
         clear();
     }
@@ -60,6 +62,7 @@ namespace fx
         mHDR = false;
         mNormals = false;
         mLights = false;
+        mFusePasses = true;
         mEnabled = true;
         mPassMap.clear();
         mPasses.clear();
@@ -125,6 +128,14 @@ namespace fx
                 if (it == mPassMap.end())
                     error(Misc::StringUtils::format("pass '%s' was found in the pass list, but there was no matching 'fragment', 'vertex' or 'compute' block", std::string(name)));
 
+                if (it->second->mType == Pass::Type::Compute && !mSupportsCompute)
+                {
+                    if (!it->second->mFragment)
+                        error(Misc::StringUtils::format("compute shaders are unsupported and pass '%s' has no 'fragment' block to fall back to", std::string(name)));
+
+                    it->second->mType = Pass::Type::Pixel;
+                }
+
                 if (mLastAppliedType != Pass::Type::None && mLastAppliedType != it->second->mType)
                 {
                     swaps++;
@@ -141,13 +152,14 @@ namespace fx
                     mGLSLExtensions.insert("GL_EXT_texture_array");
                 }
 
-                it->second->compile(*this, mShared);
-
                 if (!it->second->mTarget.empty())
                 {
                     auto rtIt = mRenderTargets.find(it->second->mTarget);
                     if (rtIt == mRenderTargets.end())
                         error(Misc::StringUtils::format("target '%s' not defined", std::string(it->second->mTarget)));
+
+                    if (it->second->mType == Pass::Type::Compute && !Pass::getImageFormat(rtIt->second.mTarget->getInternalFormat()))
+                        error(Misc::StringUtils::format("target '%s' of compute pass '%s' must have an internal format of red, rg, rgba or their floating point variants", std::string(it->second->mTarget), std::string(name)));
                 }
 
                 mPasses.emplace_back(it->second);
@@ -156,6 +168,12 @@ namespace fx
             if (mPasses.empty())
                 error("invalid pass list, no passes defined for technique");
 
+            if (mFusePasses)
+                fusePasses();
+
+            for (const auto& pass : mPasses)
+                pass->compile(*this, mShared);
+
             mValid = true;
         }
         catch(const std::runtime_error& e)
@@ -170,6 +188,60 @@ namespace fx
         return mValid;
     }
 
+    void Technique::fusePasses()
+    {
+        const auto isFusable = [] (const Pass& pass)
+        {
+            return pass.mType == Pass::Type::Pixel && pass.mFragment && !pass.mVertex && pass.mTarget.empty()
+                && !pass.mBlendSource && !pass.mBlendEq && !pass.mClearColor;
+        };
+
+        PassList passes;
+
+        for (auto begin = mPasses.begin(); begin != mPasses.end();)
+        {
+            auto end = begin + 1;
+            std::optional<std::string> fused;
+
+            if (isFusable(**begin))
+            {
+                std::vector<std::string_view> sources = { (*begin)->mFragment->getShaderSource() };
+
+                for (; end != mPasses.end() && isFusable(**end); ++end)
+                {
+                    sources.push_back((*end)->mFragment->getShaderSource());
+
+                    std::optional<std::string> source = fuseFragmentShaders(sources);
+                    if (!source)
+                        break;
+
+                    fused = std::move(source);
+                }
+            }
+
+            if (!fused)
+            {
+                passes.push_back(*begin);
+                begin = end;
+                continue;
+            }
+
+            auto pass = std::make_shared<Pass>(Pass::Type::Pixel, Pass::Order::Post, mUBO);
+
+            for (auto it = begin; it != end; ++it)
+                pass->mName += (it == begin ? "" : "+") + (*it)->mName;
+
+            pass->mFragment = new osg::Shader(osg::Shader::FRAGMENT, *fused);
+
+            Log(Debug::Verbose) << "Technique '" << mName << "' runs passes " << pass->mName << " in one program";
+
+            passes.push_back(std::move(pass));
+            begin = end;
+        }
+
+        mPasses = std::move(passes);
+    }
+
     std::string Technique::getName() const
     {
         return mName;
@@ -241,6 +313,8 @@ namespace fx
                 mNormals = parseBool() && mSupportsNormals;
             else if (key == "pass_lights")
                 mLights = parseBool();
+            else if (key == "fuse_passes")
+                mFusePasses = parseBool();
             else if (key == "glsl_profile")
             {
                 expect<Lexer::String>();
@@ -368,14 +442,14 @@ namespace fx
 
         pass->mName = mBlockName;
 
-        if (pass->mCompute)
-            error(Misc::StringUtils::format("'compute' block already defined. Usage is ambiguous."));
-        else if (!pass->mVertex)
+        if (!pass->mVertex)
             pass->mVertex = new osg::Shader(osg::Shader::VERTEX, getBlockWithLineDirective());
         else
             error(Misc::StringUtils::format("duplicate vertex shader for block '%s'", std::string(mBlockName)));
 
-        pass->mType = Pass::Type::Pixel;
+        // Alongside a 'compute' block this is the fallback used where compute shaders are unsupported
+        if (!pass->mCompute)
+            pass->mType = Pass::Type::Pixel;
     }
 
     template<>
@@ -392,14 +466,13 @@ namespace fx
         pass->mUBO = mUBO;
         pass->mName = mBlockName;
 
-        if (pass->mCompute)
-            error(Misc::StringUtils::format("'compute' block already defined. Usage is ambiguous."));
-        else if (!pass->mFragment)
+        if (!pass->mFragment)
             pass->mFragment = new osg::Shader(osg::Shader::FRAGMENT, getBlockWithLineDirective());
         else
             error(Misc::StringUtils::format("duplicate vertex shader for block '%s'", std::string(mBlockName)));
 
-        pass->mType = Pass::Type::Pixel;
+        if (!pass->mCompute)
+            pass->mType = Pass::Type::Pixel;
     }
 
     template<>
@@ -413,16 +486,13 @@ namespace fx
         if (!pass)
             pass = std::make_shared<fx::Pass>();
 
+        pass->mUBO = mUBO;
         pass->mName = mBlockName;
 
-        if (pass->mFragment)
-            error(Misc::StringUtils::format("'fragment' block already defined. Usage is ambiguous."));
-        else if (pass->mVertex)
-            error(Misc::StringUtils::format("'vertex' block already defined. Usage is ambiguous."));
-        else if (!pass->mFragment)
+        if (!pass->mCompute)
             pass->mCompute = new osg::Shader(osg::Shader::COMPUTE, getBlockWithLineDirective());
         else
-            error(Misc::StringUtils::format("duplicate vertex shader for block '%s'", std::string(mBlockName)));
+            error(Misc::StringUtils::format("duplicate compute shader for block '%s'", std::string(mBlockName)));
 
         pass->mType = Pass::Type::Compute;
     }
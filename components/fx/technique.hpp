@@ -59,9 +59,12 @@ namespace fx
             osg::ref_ptr<osg::StateSet> mStateSet = new osg::StateSet;
             osg::ref_ptr<osg::FrameBufferObject> mRenderTarget;
             osg::ref_ptr<osg::Texture2D> mRenderTexture;
+            // Dispatched as a compute shader writing to the image of the target instead of drawn
+            bool mCompute = false;
 
             SubPass(const SubPass& other, const osg::CopyOp& copyOp = osg::CopyOp::SHALLOW_COPY)
                 : mStateSet(new osg::StateSet(*other.mStateSet, copyOp))
+                , mCompute(other.mCompute)
             {
                 if (other.mRenderTarget)
                     mRenderTarget = new osg::FrameBufferObject(*other.mRenderTarget, copyOp);
@@ -109,7 +112,7 @@ namespace fx
         static constexpr FlagsType Flag_Disable_SunGlare = (1 << 4);
         static constexpr FlagsType Flag_Hidden = (1 << 5);
 
-        Technique(const VFS::Manager& vfs, Resource::ImageManager& imageManager, const std::string& name, int width, int height, bool ubo, bool supportsNormals);
+        Technique(const VFS::Manager& vfs, Resource::ImageManager& imageManager, const std::string& name, int width, int height, bool ubo, bool supportsNormals, bool supportsCompute);
 
         bool compile();
 
@@ -131,6 +134,8 @@ namespace fx
 
         bool getLights() const { return mLights; }
 
+        bool getFusePasses() const { return mFusePasses; }
+
         const PassList& getPasses() { return mPasses; }
 
         const TexList& getTextures() const { return mTextures; }
@@ -168,6 +173,9 @@ namespace fx
 
         void clear();
 
+        // Replaces runs of passes that only read the previous pass at the shaded fragment with one pass running them all
+        void fusePasses();
+
         std::string_view asLiteral() const;
 
         template<class T>
@@ -256,6 +264,7 @@ namespace fx
         bool mHDR;
         bool mNormals;
         bool mLights;
+        bool mFusePasses;
         int mWidth;
         int mHeight;
 
@@ -276,6 +285,7 @@ namespace fx
         Resource::ImageManager& mImageManager;
         bool mUBO;
         bool mSupportsNormals;
+        bool mSupportsCompute;
 
         std::string mBuffer;
 
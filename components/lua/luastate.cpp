@@ -4,6 +4,7 @@
 #include <luajit.h>
 #endif // NO_LUAJIT
 
+#include <cstdlib>
 #include <filesystem>
 
 #include <components/debug/debuglog.hpp>
@@ -49,7 +50,14 @@ namespace LuaUtil
         "type", "unpack", "xpcall", "rawequal", "rawget", "rawset", "setmetatable"};
     static const std::string safePackages[] = {"coroutine", "math", "string", "table"};
 
+#ifdef NO_LUAJIT
+    LuaState::LuaState(const VFS::Manager* vfs, const ScriptsConfiguration* conf)
+        : mLua(sol::default_at_panic, &LuaState::allocate, this)
+        , mConf(conf)
+        , mVFS(vfs)
+#else
     LuaState::LuaState(const VFS::Manager* vfs, const ScriptsConfiguration* conf) : mConf(conf), mVFS(vfs)
+#endif
     {
         mLua.open_libraries(sol::lib::base, sol::lib::coroutine, sol::lib::math, sol::lib::bit32,
                             sol::lib::string, sol::lib::table, sol::lib::os, sol::lib::debug);
@@ -146,6 +154,70 @@ namespace LuaUtil
         mSandboxEnv = sol::nil;
     }
 
+    void* LuaState::allocate(void* ud, void* ptr, std::size_t osize, std::size_t nsize)
+    {
+        if (nsize == 0)
+        {
+            std::free(ptr);
+            return nullptr;
+        }
+        void* result = std::realloc(ptr, nsize);
+        if (result != nullptr)
+        {
+            // If ptr is nullptr, osize is the type of the object rather than its size
+            const std::size_t oldSize = ptr == nullptr ? 0 : osize;
+            if (nsize > oldSize)
+                static_cast<LuaState*>(ud)->mAllocatedBytes += nsize - oldSize;
+        }
+        return result;
+    }
+
+    std::uint64_t LuaState::getAllocatedBytes() const
+    {
+#ifdef NO_LUAJIT
+        return mAllocatedBytes;
+#else
+        return getMemoryUsage();
+#endif
+    }
+
+    std::size_t LuaState::getMemoryUsage() const
+    {
+        lua_State* L = mLua.lua_state();
+        return static_cast<std::size_t>(lua_gc(L, LUA_GCCOUNT, 0)) * 1024 + lua_gc(L, LUA_GCCOUNTB, 0);
+    }
+
+    void LuaState::resetScriptStats()
+    {
+        mScriptStats.clear();
+        mTotalStats = ScriptStats();
+    }
+
+    LuaState::StatsScope::StatsScope(LuaState& lua, int scriptId)
+        : mLua(lua)
+        , mScriptId(scriptId)
+        , mAllocatedBytes(lua.getAllocatedBytes())
+        , mStart(std::chrono::steady_clock::now())
+    {
+    }
+
+    LuaState::StatsScope::~StatsScope()
+    {
+        const double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - mStart).count();
+        const std::uint64_t allocatedBytes = mLua.getAllocatedBytes();
+        // Can decrease if LuaJIT collected garbage during the call
+        const std::uint64_t allocated = allocatedBytes > mAllocatedBytes ? allocatedBytes - mAllocatedBytes : 0;
+
+        if (mLua.mScriptStats.size() <= static_cast<std::size_t>(mScriptId))
+            mLua.mScriptStats.resize(mScriptId + 1);
+        for (ScriptStats* stats : {&mLua.mScriptStats[mScriptId], &mLua.mTotalStats})
+        {
+            stats->mTime += time;
+            stats->mCalls += 1;
+            stats->mAllocatedBytes += allocated;
+        }
+    }
+
     sol::table makeReadOnly(const sol::table& table, bool strictIndex)
     {
         if (table == sol::nil)
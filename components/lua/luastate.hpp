@@ -1,7 +1,10 @@
 #ifndef COMPONENTS_LUA_LUASTATE_H
 #define COMPONENTS_LUA_LUASTATE_H
 
+#include <chrono>
+#include <cstdint>
 #include <map>
+#include <vector>
 
 #include <sol/sol.hpp>
 
@@ -82,6 +85,39 @@ namespace LuaUtil
         sol::function loadFromVFS(const std::string& path);
         sol::environment newInternalLibEnvironment();
 
+        struct ScriptStats
+        {
+            double mTime = 0;  // in seconds
+            std::uint64_t mCalls = 0;
+            std::uint64_t mAllocatedBytes = 0;
+        };
+
+        // Time, number of calls and memory allocated by engine handlers, event handlers and timers of every script.
+        // Indexed by script id (i.e. index in ScriptsConfiguration), summed over all containers the script runs in.
+        const std::vector<ScriptStats>& getScriptStats() const { return mScriptStats; }
+        const ScriptStats& getTotalStats() const { return mTotalStats; }
+        void resetScriptStats();
+
+        // Number of bytes currently used by Lua.
+        std::size_t getMemoryUsage() const;
+
+        // Adds the time and the memory allocated during its lifetime to the stats of a script.
+        class StatsScope
+        {
+        public:
+            StatsScope(LuaState& lua, int scriptId);
+            ~StatsScope();
+
+            StatsScope(const StatsScope&) = delete;
+            StatsScope& operator=(const StatsScope&) = delete;
+
+        private:
+            LuaState& mLua;
+            int mScriptId;
+            std::uint64_t mAllocatedBytes;
+            std::chrono::steady_clock::time_point mStart;
+        };
+
     private:
         static sol::protected_function_result throwIfError(sol::protected_function_result&&);
         template <typename... Args>
@@ -89,6 +125,16 @@ namespace LuaUtil
 
         sol::function loadScriptAndCache(const std::string& path);
 
+        // Total number of bytes allocated since the creation of the state. Without custom allocator (LuaJIT only
+        // supports it on some platforms) it is the current memory usage, so only the growth is accounted.
+        std::uint64_t getAllocatedBytes() const;
+        static void* allocate(void* ud, void* ptr, std::size_t osize, std::size_t nsize);
+
+        // Must be initialized before mLua
+        std::uint64_t mAllocatedBytes = 0;
+        std::vector<ScriptStats> mScriptStats;
+        ScriptStats mTotalStats;
+
         sol::state mLua;
         const ScriptsConfiguration* mConf;
         sol::table mSandboxEnv;
@@ -273,9 +273,25 @@ namespace LuaUtil
             Log(Debug::Error) << mNamePrefix << " can not parse eventData for '" << eventName << "': " << e.what();
             return;
         }
-        EventHandlerList& list = it->second;
+        callEventHandlers(it->second, eventName, data);
+    }
+
+    void ScriptsContainer::receiveEvent(std::string_view eventName, const sol::object& eventData)
+    {
+        auto it = mEventHandlers.find(eventName);
+        if (it == mEventHandlers.end())
+        {
+            Log(Debug::Warning) << mNamePrefix << " has received event '" << eventName << "', but there are no handlers for this event";
+            return;
+        }
+        callEventHandlers(it->second, eventName, eventData);
+    }
+
+    void ScriptsContainer::callEventHandlers(EventHandlerList& list, std::string_view eventName, const sol::object& data)
+    {
         for (int i = list.size() - 1; i >= 0; --i)
         {
+            LuaState::StatsScope stats(mLua, list[i].mScriptId);
             try
             {
                 sol::object res = LuaUtil::call(list[i].mFn, data);
@@ -490,6 +506,7 @@ namespace LuaUtil
 
     void ScriptsContainer::callTimer(const Timer& t)
     {
+        LuaState::StatsScope stats(mLua, t.mScriptId);
         try
         {
             Script& script = getScript(t.mScriptId);
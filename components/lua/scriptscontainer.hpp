@@ -111,6 +111,10 @@ namespace LuaUtil
         // (including `nil`) has no effect.
         void receiveEvent(std::string_view eventName, std::string_view eventData);
 
+        // Same as above, but `eventData` is passed to the handlers as is. It must be a value that the handlers
+        // can't share with the sender, see `LuaUtil::copy`.
+        void receiveEvent(std::string_view eventName, const sol::object& eventData);
+
         // Serializer defines how to serialize/deserialize userdata. If serializer is not provided,
         // only built-in types and types from util package can be serialized.
         void setSerializer(const UserdataSerializer* serializer) { mSerializer = serializer; }
@@ -167,6 +171,7 @@ namespace LuaUtil
         {
             for (Handler& handler : handlers.mList)
             {
+                LuaState::StatsScope stats(mLua, handler.mScriptId);
                 try { LuaUtil::call(handler.mFn, args...); }
                 catch (std::exception& e)
                 {
@@ -218,6 +223,7 @@ namespace LuaUtil
         const std::string& scriptPath(int scriptId) const { return mLua.getConfiguration()[scriptId].mScriptPath; }
         void callOnInit(int scriptId, const sol::function& onInit);
         void callTimer(const Timer& t);
+        void callEventHandlers(EventHandlerList& list, std::string_view eventName, const sol::object& data);
         void updateTimerQueue(std::vector<Timer>& timerQueue, double time);
         static void insertTimer(std::vector<Timer>& timerQueue, Timer&& t);
         static void insertHandler(std::vector<Handler>& list, int scriptId, sol::function fn);
@@ -316,6 +316,73 @@ namespace LuaUtil
         throw std::runtime_error("Unknown type in serialized data: " + std::to_string(type));
     }
 
+    static void copyUserdata(lua_State* lua, int index, const UserdataSerializer* customSerializer,
+                             const UserdataSerializer* customDeserializer)
+    {
+        sol::userdata data(lua, index);
+        if (data.is<osg::Vec2f>())
+            sol::stack::push<osg::Vec2f>(lua, data.as<osg::Vec2f>());
+        else if (data.is<osg::Vec3f>())
+            sol::stack::push<osg::Vec3f>(lua, data.as<osg::Vec3f>());
+        else if (data.is<TransformM>())
+            sol::stack::push<TransformM>(lua, data.as<TransformM>());
+        else if (data.is<TransformQ>())
+            sol::stack::push<TransformQ>(lua, data.as<TransformQ>());
+        else if (data.is<osg::Vec4f>())
+            sol::stack::push<osg::Vec4f>(lua, data.as<osg::Vec4f>());
+        else if (data.is<Misc::Color>())
+            sol::stack::push<Misc::Color>(lua, data.as<Misc::Color>());
+        else
+        {
+            BinaryData binaryData;
+            if (!customSerializer || !customSerializer->serialize(binaryData, data))
+                throw std::runtime_error("Value is not serializable.");
+            std::string_view view(binaryData);
+            deserializeImpl(lua, view, customDeserializer, false);
+        }
+    }
+
+    // Pushes a copy of the value at the given absolute stack index
+    static void copyImpl(lua_State* lua, int index, const UserdataSerializer* customSerializer,
+                         const UserdataSerializer* customDeserializer, int recursionCounter)
+    {
+        if (!lua_checkstack(lua, 4))
+            throw std::runtime_error("Lua stack overflow.");
+        switch (lua_type(lua, index))
+        {
+            case LUA_TNUMBER:
+            case LUA_TSTRING:
+            case LUA_TBOOLEAN:
+                lua_pushvalue(lua, index);
+                return;
+            case LUA_TTABLE:
+            {
+                if (recursionCounter >= 32)
+                    throw std::runtime_error("Can not serialize more than 32 nested tables. Likely the table contains itself.");
+                lua_createtable(lua, 0, 0);
+                const int result = lua_gettop(lua);
+                lua_pushnil(lua);
+                while (lua_next(lua, index) != 0)
+                {
+                    const int value = lua_gettop(lua);
+                    copyImpl(lua, value - 1, customSerializer, customDeserializer, recursionCounter + 1);
+                    copyImpl(lua, value, customSerializer, customDeserializer, recursionCounter + 1);
+                    lua_rawset(lua, result);
+                    lua_pop(lua, 1);  // keep the key for lua_next
+                }
+                return;
+            }
+            case LUA_TUSERDATA:
+                copyUserdata(lua, index, customSerializer, customDeserializer);
+                return;
+            case LUA_TLIGHTUSERDATA:
+                throw std::runtime_error("Light userdata is not allowed to be serialized.");
+            case LUA_TFUNCTION:
+                throw std::runtime_error("Functions are not allowed to be serialized.");
+        }
+        throw std::runtime_error("Unknown Lua type.");
+    }
+
     BinaryData serialize(const sol::object& obj, const UserdataSerializer* customSerializer)
     {
         if (obj == sol::nil)
@@ -326,6 +393,25 @@ namespace LuaUtil
         return res;
     }
 
+    BinaryData serializeTable(const std::vector<std::pair<std::string_view, std::string_view>>& fields)
+    {
+        BinaryData res;
+        res.push_back(FORMAT_VERSION);
+        appendType(res, SerializedType::TABLE_START);
+        for (const auto& [key, value] : fields)
+        {
+            if (value.empty())
+                continue;
+            if (value[0] != FORMAT_VERSION)
+                throw std::runtime_error("Incorrect version of Lua serialization format: " +
+                                         std::to_string(static_cast<unsigned>(value[0])));
+            appendString(res, key);
+            res.append(value.data() + 1, value.size() - 1);
+        }
+        appendType(res, SerializedType::TABLE_END);
+        return res;
+    }
+
     sol::object deserialize(lua_State* lua, std::string_view binaryData,
                             const UserdataSerializer* customSerializer, bool readOnly)
     {
@@ -341,4 +427,25 @@ namespace LuaUtil
         return sol::stack::pop<sol::object>(lua);
     }
 
+    sol::object copy(lua_State* lua, const sol::object& obj, const UserdataSerializer* customSerializer,
+                     const UserdataSerializer* customDeserializer)
+    {
+        if (obj == sol::nil)
+            return sol::nil;
+        const int top = lua_gettop(lua);
+        obj.push(lua);
+        try
+        {
+            copyImpl(lua, top + 1, customSerializer, customDeserializer, 0);
+        }
+        catch (...)
+        {
+            lua_settop(lua, top);
+            throw;
+        }
+        sol::object result = sol::stack::pop<sol::object>(lua);
+        lua_settop(lua, top);
+        return result;
+    }
+
 }
@@ -1,6 +1,10 @@
 #ifndef COMPONENTS_LUA_SERIALIZATION_H
 #define COMPONENTS_LUA_SERIALIZATION_H
 
+#include <string_view>
+#include <utility>
+#include <vector>
+
 #include <sol/sol.hpp>
 
 namespace LuaUtil
@@ -30,6 +34,19 @@ namespace LuaUtil
     sol::object deserialize(lua_State* lua, std::string_view binaryData,
                             const UserdataSerializer* customSerializer = nullptr, bool readOnly = false);
 
+    // Serializes a table with string keys from values that are serialized already (results of `serialize`), without
+    // decoding them. The result is the same as of `serialize` of the table with the deserialized values, except for the
+    // order of the fields. Empty values (serialized nil) are skipped.
+    BinaryData serializeTable(const std::vector<std::pair<std::string_view, std::string_view>>& fields);
+
+    // Makes a deep copy of the object, the same as `deserialize(lua, serialize(obj, customSerializer), customDeserializer)`
+    // would, but without encoding values that don't need it. Numbers, strings and booleans are immutable in Lua and
+    // are shared with the source, tables are copied recursively. Custom userdata still goes through the serializers,
+    // as the deserializer may convert it to a different type.
+    // Throws the same errors as `serialize`. The object must belong to `lua`.
+    sol::object copy(lua_State* lua, const sol::object& obj, const UserdataSerializer* customSerializer = nullptr,
+                     const UserdataSerializer* customDeserializer = nullptr);
+
 }
 
 #endif // COMPONENTS_LUA_SERIALIZATION_H
@@ -15,9 +15,21 @@ namespace LuaUtil
 {
     LuaStorage::Value LuaStorage::Section::sEmpty;
 
+    void LuaStorage::Value::set(const sol::object& value)
+    {
+        mSerializedValue = serialize(value);
+        mValue = sol::nil;
+        mReadOnlyValue = sol::nil;
+    }
+
     sol::object LuaStorage::Value::getCopy(lua_State* L) const
     {
-        return deserialize(L, mSerializedValue);
+        if (mSerializedValue.empty())
+            return sol::nil;
+        if (mValue == sol::nil)
+            mValue = deserialize(L, mSerializedValue);
+        // Copying a Lua value is cheaper than decoding it, and for numbers, strings and booleans it is free
+        return copy(L, mValue);
     }
 
     sol::object LuaStorage::Value::getReadOnly(lua_State* L) const
@@ -31,11 +43,31 @@ namespace LuaUtil
     {
         auto it = mValues.find(key);
         if (it != mValues.end())
-            return it->second;
+            return *it->second;
         else
             return sEmpty;
     }
 
+    void LuaStorage::Section::setChanged()
+    {
+        mSerializedValuesValid = false;
+        mStorage->mSavedPath.clear();
+    }
+
+    const BinaryData& LuaStorage::Section::getSerialized() const
+    {
+        if (!mSerializedValuesValid)
+        {
+            std::vector<std::pair<std::string_view, std::string_view>> fields;
+            fields.reserve(mValues.size());
+            for (const auto& [key, value] : mValues)
+                fields.emplace_back(key, value->getSerialized());
+            mSerializedValues = serializeTable(fields);
+            mSerializedValuesValid = true;
+        }
+        return mSerializedValues;
+    }
+
     void LuaStorage::Section::runCallbacks(sol::optional<std::string_view> changedKey)
     {
         mStorage->mRunningCallbacks = true;
@@ -53,14 +85,22 @@ namespace LuaUtil
     {
         if (mStorage->mRunningCallbacks)
             throw std::runtime_error("Not allowed to change storage in storage handlers because it can lead to an infinite recursion");
+        auto it = mValues.find(key);
         if (value != sol::nil)
-            mValues[std::string(key)] = Value(value);
-        else
         {
-            auto it = mValues.find(key);
             if (it != mValues.end())
-                mValues.erase(it);
+                it->second->set(value);
+            else
+            {
+                auto newValue = std::make_unique<Value>(key);
+                newValue->set(value);
+                std::string_view newKey = newValue->getKey();
+                mValues.emplace(newKey, std::move(newValue));
+            }
         }
+        else if (it != mValues.end())
+            mValues.erase(it);
+        setChanged();
         if (mStorage->mListener)
             mStorage->mListener->valueChanged(mSectionName, key, value);
         runCallbacks(key);
@@ -70,12 +110,19 @@ namespace LuaUtil
     {
         if (mStorage->mRunningCallbacks)
             throw std::runtime_error("Not allowed to change storage in storage handlers because it can lead to an infinite recursion");
-        mValues.clear();
+        std::unordered_map<std::string_view, std::unique_ptr<Value>> newValues;
         if (values)
         {
             for (const auto& [k, v] : *values)
-                mValues[k.as<std::string>()] = Value(v);
+            {
+                auto value = std::make_unique<Value>(k.as<std::string>());
+                value->set(v);
+                std::string_view key = value->getKey();
+                newValues.emplace(key, std::move(value));
+            }
         }
+        mValues = std::move(newValues);
+        setChanged();
         if (mStorage->mListener)
             mStorage->mListener->sectionReplaced(mSectionName, values);
         runCallbacks(sol::nullopt);
@@ -85,7 +132,7 @@ namespace LuaUtil
     {
         sol::table res(mStorage->mLua, sol::create);
         for (const auto& [k, v] : mValues)
-            res[k] = v.getCopy(mStorage->mLua);
+            res[k] = v->getCopy(mStorage->mLua);
         return res;
     }
 
@@ -124,6 +171,7 @@ namespace LuaUtil
             if (section.mReadOnly)
                 throw std::runtime_error("Access to storage is read only");
             section.mSection->mPermanent = false;
+            section.mSection->mStorage->mSavedPath.clear();
         };
         sview["set"] = [](const SectionView& section, std::string_view key, const sol::object& value)
         {
@@ -164,6 +212,7 @@ namespace LuaUtil
                 for (const auto& [key, value] : sol::table(sectionTable))
                     section->set(key.as<std::string_view>(), value);
             }
+            mSavedPath = path;
         }
         catch (std::exception& e)
         {
@@ -173,17 +222,24 @@ namespace LuaUtil
 
     void LuaStorage::save(const std::string& path) const
     {
-        sol::table data(mLua, sol::create);
+        if (path == mSavedPath && std::filesystem::exists(path))
+        {
+            Log(Debug::Verbose) << "Lua storage \"" << path << "\" is not changed";
+            return;
+        }
+        std::vector<std::pair<std::string_view, std::string_view>> sections;
         for (const auto& [sectionName, section] : mData)
         {
             if (section->mPermanent && !section->mValues.empty())
-                data[sectionName] = section->asTable();
+                sections.emplace_back(sectionName, section->getSerialized());
         }
-        std::string serializedData = serialize(data);
+        std::string serializedData = serializeTable(sections);
         Log(Debug::Info) << "Saving Lua storage \"" << path << "\" (" << serializedData.size() << " bytes)";
         std::ofstream fout(path, std::fstream::binary);
         fout.write(serializedData.data(), serializedData.size());
         fout.close();
+        if (fout)
+            mSavedPath = path;
     }
 
     const std::shared_ptr<LuaStorage::Section>& LuaStorage::getSection(std::string_view sectionName)
@@ -2,6 +2,9 @@
 #define COMPONENTS_LUA_STORAGE_H
 
 #include <map>
+#include <memory>
+#include <unordered_map>
+
 #include <sol/sol.hpp>
 
 #include "scriptscontainer.hpp"
@@ -19,6 +22,8 @@ namespace LuaUtil
 
         void clearTemporaryAndRemoveCallbacks();
         void load(const std::string& path);
+        // Sections are serialized again only if they were changed. The file is not rewritten if nothing was changed
+        // since the previous `save` or `load` with the same path.
         void save(const std::string& path) const;
 
         sol::object getSection(std::string_view sectionName, bool readOnly);
@@ -44,13 +49,19 @@ namespace LuaUtil
         class Value
         {
         public:
-            Value() {}
-            Value(const sol::object& value) : mSerializedValue(serialize(value)) {}
+            explicit Value(std::string_view key = {}) : mKey(key) {}
+            const std::string& getKey() const { return mKey; }
+            const BinaryData& getSerialized() const { return mSerializedValue; }
+            void set(const sol::object& value);
             sol::object getCopy(lua_State* L) const;
             sol::object getReadOnly(lua_State* L) const;
 
         private:
-            std::string mSerializedValue;
+            std::string mKey;
+            BinaryData mSerializedValue;
+            // Both are deserialized on first use and dropped when the value changes.
+            // mValue is never given to scripts, `getCopy` returns copies of it.
+            mutable sol::object mValue = sol::nil;
             mutable sol::object mReadOnlyValue = sol::nil;
         };
 
@@ -62,12 +73,17 @@ namespace LuaUtil
             void setAll(const sol::optional<sol::table>& values);
             sol::table asTable();
             void runCallbacks(sol::optional<std::string_view> changedKey);
+            void setChanged();
+            const BinaryData& getSerialized() const;
 
             LuaStorage* mStorage;
             std::string mSectionName;
-            std::map<std::string, Value, std::less<>> mValues;
+            // Keys point to Value::mKey
+            std::unordered_map<std::string_view, std::unique_ptr<Value>> mValues;
             std::vector<Callback> mCallbacks;
             bool mPermanent = true;
+            mutable BinaryData mSerializedValues;
+            mutable bool mSerializedValuesValid = false;
             static Value sEmpty;
         };
         struct SectionView
@@ -82,6 +98,8 @@ namespace LuaUtil
         std::map<std::string_view, std::shared_ptr<Section>> mData;
         const Listener* mListener = nullptr;
         bool mRunningCallbacks = false;
+        // Path of the file that matches the current permanent sections
+        mutable std::string mSavedPath;
     };
 
 }
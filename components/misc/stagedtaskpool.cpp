@@ -0,0 +1,141 @@
+#include "stagedtaskpool.hpp"
+
+#include <components/debug/trace.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+namespace Misc
+{
+    namespace
+    {
+        // More chunks than threads, so that threads finishing early can take over the work of the slow ones
+        constexpr std::size_t sChunksPerThread = 4;
+    }
+
+    StagedTaskPool::StagedTaskPool(unsigned int numThreads, const std::string& threadName)
+        : mChunkSize(1)
+        , mNextItem(0)
+        , mUnfinishedItems(0)
+        , mBusy(false)
+        , mNeedsAdvance(false)
+        , mStop(false)
+    {
+        mStage.mSize = 0;
+        for (unsigned int i = 0; i < numThreads; ++i)
+            mThreads.emplace_back([this, threadName]
+            {
+                Debug::setTraceThreadName(threadName);
+                run();
+            });
+    }
+
+    StagedTaskPool::~StagedTaskPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mStop = true;
+        }
+        mHasWork.notify_all();
+        for (std::thread& thread : mThreads)
+            thread.join();
+    }
+
+    void StagedTaskPool::start(NextStage&& nextStage)
+    {
+        if (mThreads.empty())
+        {
+            while (std::optional<Stage> stage = nextStage())
+            {
+                if (stage->mSize > 0)
+                    stage->mRun(0, stage->mSize);
+            }
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            assert(!mBusy);
+            mNextStage = std::move(nextStage);
+            mBusy = true;
+            mNeedsAdvance = true;
+        }
+        mHasWork.notify_one();
+    }
+
+    void StagedTaskPool::wait()
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mDone.wait(lock, [this] { return !mBusy; });
+    }
+
+    bool StagedTaskPool::isBusy() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mBusy;
+    }
+
+    void StagedTaskPool::advance(std::unique_lock<std::mutex>& lock)
+    {
+        while (true)
+        {
+            // Other threads may only sleep meanwhile: there is no chunk left and mUnfinishedItems is 0
+            lock.unlock();
+            std::optional<Stage> stage = mNextStage();
+            lock.lock();
+
+            if (!stage)
+            {
+                mNextStage = nullptr;
+                mStage = Stage {0, 1, nullptr};
+                mNextItem = 0;
+                mBusy = false;
+                mDone.notify_all();
+                return;
+            }
+            if (stage->mSize == 0)
+                continue;
+
+            mStage = std::move(*stage);
+            mNextItem = 0;
+            mUnfinishedItems = mStage.mSize;
+            const std::size_t numThreads = mThreads.size();
+            mChunkSize = std::max(mStage.mMinChunkSize,
+                (mStage.mSize + numThreads * sChunksPerThread - 1) / (numThreads * sChunksPerThread));
+            if (mStage.mSize > mChunkSize)
+                mHasWork.notify_all();
+            return;
+        }
+    }
+
+    void StagedTaskPool::run()
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        while (true)
+        {
+            mHasWork.wait(lock, [this] { return mStop || mNeedsAdvance || hasChunk(); });
+            if (mStop)
+                return;
+
+            if (mNeedsAdvance)
+            {
+                mNeedsAdvance = false;
+                advance(lock);
+                continue;
+            }
+
+            const std::size_t begin = mNextItem;
+            const std::size_t end = std::min(begin + mChunkSize, mStage.mSize);
+            mNextItem = end;
+
+            // mStage is not replaced before all its items are finished
+            lock.unlock();
+            mStage.mRun(begin, end);
+            lock.lock();
+
+            mUnfinishedItems -= end - begin;
+            if (mUnfinishedItems == 0)
+                advance(lock);
+        }
+    }
+}
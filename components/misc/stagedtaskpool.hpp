@@ -0,0 +1,74 @@
+#ifndef OPENMW_COMPONENTS_MISC_STAGEDTASKPOOL_H
+#define OPENMW_COMPONENTS_MISC_STAGEDTASKPOOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Misc
+{
+    /// @brief Runs a sequence of stages on a pool of persistent threads. Each stage is a range of independent items
+    ///     split into chunks, any idle thread takes the next chunk.
+    /// @par There is no barrier between the stages: the thread that finishes the last chunk of a stage requests the
+    ///     next stage and continues with it, the other threads go back to sleep and are woken only if the new stage
+    ///     has more than one chunk. A stage with a single item therefore runs serially without waking anyone.
+    class StagedTaskPool
+    {
+        public:
+            struct Stage
+            {
+                /// Number of items, 0 means the stage is skipped
+                std::size_t mSize = 1;
+                /// Minimal number of items processed by a thread at once, stages with cheap items should use more
+                std::size_t mMinChunkSize = 1;
+                /// Processes the items [begin, end)
+                std::function<void(std::size_t begin, std::size_t end)> mRun;
+            };
+
+            /// Returns the stage following the finished one, or std::nullopt if the work is done.
+            /// Never called concurrently, so it may update the state shared by the stages.
+            using NextStage = std::function<std::optional<Stage>()>;
+
+            /// @param numThreads number of threads, if 0 the work is done by the thread calling start.
+            /// @param threadName name of the threads in traces
+            explicit StagedTaskPool(unsigned int numThreads, const std::string& threadName = "StagedTaskPool");
+            ~StagedTaskPool();
+
+            unsigned int getNumThreads() const { return static_cast<unsigned int>(mThreads.size()); }
+
+            /// Start working on the stages returned by nextStage. Returns immediately unless there are no threads.
+            /// @note The previous work has to be finished.
+            void start(NextStage&& nextStage);
+
+            /// Block until the work started last is done.
+            void wait();
+
+            bool isBusy() const;
+
+        private:
+            bool hasChunk() const { return mNextItem < mStage.mSize; }
+            void run();
+            // Requests stages until one with items is found or the work is done, called with mMutex locked
+            void advance(std::unique_lock<std::mutex>& lock);
+
+            NextStage mNextStage;
+            Stage mStage;
+            std::size_t mChunkSize;
+            std::size_t mNextItem;
+            std::size_t mUnfinishedItems;
+            bool mBusy;
+            bool mNeedsAdvance;
+            bool mStop;
+            mutable std::mutex mMutex;
+            std::condition_variable mHasWork;
+            std::condition_variable mDone;
+            std::vector<std::thread> mThreads;
+    };
+}
+
+#endif
@@ -5,8 +5,11 @@
 
 #include "nifstream.hpp"
 
+#include <algorithm>
+#include <cmath>
 #include <sstream>
-#include <map>
+#include <utility>
+#include <vector>
 
 #include "niffile.hpp"
 
@@ -43,13 +46,22 @@ using QuaternionKey = KeyT<osg::Quat>;
 
 template<typename T, T (NIFStream::*getValue)()>
 struct KeyMapT {
-    using MapType = std::map<float, KeyT<T>>;
-
     using ValueType = T;
     using KeyType = KeyT<T>;
 
     unsigned int mInterpolationType = InterpolationType_Unknown;
-    MapType mKeys;
+
+    /// Key times in ascending order without duplicates.
+    /// @note Kept apart from the values so that finding a key only touches the times.
+    std::vector<float> mTimes;
+    /// Key values, in the same order as mTimes.
+    std::vector<KeyType> mValues;
+    /// Number of keys per time unit if the keys are evenly spaced, 0 otherwise.
+    /// Allows looking up keys without searching.
+    float mRate = 0.f;
+
+    std::size_t size() const { return mTimes.size(); }
+    bool empty() const { return mTimes.empty(); }
 
     //Read in a KeyGroup (see http://niftools.sourceforge.net/doc/nif/NiKeyframeData.html)
     void read(NIFStream *nif, bool morph = false)
@@ -65,6 +77,7 @@ struct KeyMapT {
             mInterpolationType = nif->getUInt();
 
         KeyType key = {};
+        std::vector<std::pair<float, KeyType>> keys;
 
         if (mInterpolationType == InterpolationType_Linear || mInterpolationType == InterpolationType_Constant)
         {
@@ -72,7 +85,7 @@ struct KeyMapT {
             {
                 float time = nif->getFloat();
                 readValue(*nif, key);
-                mKeys[time] = key;
+                keys.emplace_back(time, key);
             }
         }
         else if (mInterpolationType == InterpolationType_Quadratic)
@@ -81,7 +94,7 @@ struct KeyMapT {
             {
                 float time = nif->getFloat();
                 readQuadratic(*nif, key);
-                mKeys[time] = key;
+                keys.emplace_back(time, key);
             }
         }
         else if (mInterpolationType == InterpolationType_TBC)
@@ -90,7 +103,7 @@ struct KeyMapT {
             {
                 float time = nif->getFloat();
                 readTBC(*nif, key);
-                mKeys[time] = key;
+                keys.emplace_back(time, key);
             }
         }
         else if (mInterpolationType == InterpolationType_XYZ)
@@ -108,6 +121,8 @@ struct KeyMapT {
             nif->file->fail(error.str());
         }
 
+        setKeys(std::move(keys));
+
         if (morph && nif->getVersion() > NIFStream::generateVersion(10,1,0,0))
         {
             if (nif->getVersion() >= NIFStream::generateVersion(10,1,0,104) &&
@@ -116,6 +131,40 @@ struct KeyMapT {
         }
     }
 
+    /// Replace the keys with the given (time, key) pairs, which do not need to be sorted.
+    /// Later keys replace earlier ones with the same time.
+    void setKeys(std::vector<std::pair<float, KeyType>>&& keys)
+    {
+        std::stable_sort(keys.begin(), keys.end(), [] (const auto& a, const auto& b) { return a.first < b.first; });
+        mTimes.clear();
+        mValues.clear();
+        mTimes.reserve(keys.size());
+        mValues.reserve(keys.size());
+        for (auto& [time, key] : keys)
+        {
+            if (!mTimes.empty() && mTimes.back() == time)
+            {
+                mValues.back() = key;
+                continue;
+            }
+            mTimes.push_back(time);
+            mValues.push_back(key);
+        }
+
+        mRate = 0.f;
+        if (mTimes.size() < 2)
+            return;
+        const float interval = (mTimes.back() - mTimes.front()) / (mTimes.size() - 1);
+        if (interval <= 0.f)
+            return;
+        for (std::size_t i = 1; i < mTimes.size() - 1; ++i)
+        {
+            if (std::abs(mTimes[i] - (mTimes.front() + i * interval)) > interval * 0.01f)
+                return;
+        }
+        mRate = 1.f / interval;
+    }
+
 private:
     static void readValue(NIFStream &nif, KeyT<T> &key)
     {
@@ -164,52 +164,59 @@ osg::Vec3f KeyframeController::getTranslation(float time) const
 void KeyframeController::operator() (NifOsg::MatrixTransform* node, osg::NodeVisitor* nv)
 {
     if (hasInput())
-    {
-        osg::Matrix mat = node->getMatrix();
+        apply(node, getInputValue(nv));
 
-        float time = getInputValue(nv);
+    traverse(node, nv);
+}
 
-        Nif::Matrix3& rot = node->mRotationScale;
+void KeyframeController::applyBatched(osg::Node* node, osg::NodeVisitor* nv)
+{
+    if (hasInput())
+        apply(static_cast<NifOsg::MatrixTransform*>(node), getInputValue(nv));
+}
 
-        bool setRot = false;
-        if(!mRotations.empty())
-        {
-            mat.setRotate(mRotations.interpKey(time));
-            setRot = true;
-        }
-        else if (!mXRotations.empty() || !mYRotations.empty() || !mZRotations.empty())
-        {
-            mat.setRotate(getXYZRotation(time));
-            setRot = true;
-        }
-        else
-        {
-            // no rotation specified, use the previous value
-            for (int i=0;i<3;++i)
-                for (int j=0;j<3;++j)
-                    mat(j,i) = rot.mValues[i][j]; // NB column/row major difference
-        }
+void KeyframeController::apply(NifOsg::MatrixTransform* node, float time) const
+{
+    osg::Matrix mat = node->getMatrix();
 
-        if (setRot) // copy the new values back
-            for (int i=0;i<3;++i)
-                for (int j=0;j<3;++j)
-                    rot.mValues[i][j] = mat(j,i); // NB column/row major difference
+    Nif::Matrix3& rot = node->mRotationScale;
 
-        float& scale = node->mScale;
-        if(!mScales.empty())
-            scale = mScales.interpKey(time);
+    bool setRot = false;
+    if(!mRotations.empty())
+    {
+        mat.setRotate(mRotations.interpKey(time));
+        setRot = true;
+    }
+    else if (!mXRotations.empty() || !mYRotations.empty() || !mZRotations.empty())
+    {
+        mat.setRotate(getXYZRotation(time));
+        setRot = true;
+    }
+    else
+    {
+        // no rotation specified, use the previous value
+        for (int i=0;i<3;++i)
+            for (int j=0;j<3;++j)
+                mat(j,i) = rot.mValues[i][j]; // NB column/row major difference
+    }
 
+    if (setRot) // copy the new values back
         for (int i=0;i<3;++i)
             for (int j=0;j<3;++j)
-                mat(i,j) *= scale;
+                rot.mValues[i][j] = mat(j,i); // NB column/row major difference
 
-        if(!mTranslations.empty())
-            mat.setTrans(mTranslations.interpKey(time));
+    float& scale = node->mScale;
+    if(!mScales.empty())
+        scale = mScales.interpKey(time);
 
-        node->setMatrix(mat);
-    }
+    for (int i=0;i<3;++i)
+        for (int j=0;j<3;++j)
+            mat(i,j) *= scale;
 
-    traverse(node, nv);
+    if(!mTranslations.empty())
+        mat.setTrans(mTranslations.interpKey(time));
+
+    node->setMatrix(mat);
 }
 
 GeomMorpherController::GeomMorpherController()
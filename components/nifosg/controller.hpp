@@ -6,12 +6,15 @@
 #include <components/nif/controller.hpp>
 #include <components/nif/data.hpp>
 
+#include <components/sceneutil/animationbatch.hpp>
 #include <components/sceneutil/keyframe.hpp>
 #include <components/sceneutil/nodecallback.hpp>
 #include <components/sceneutil/statesetupdater.hpp>
 
+#include <algorithm>
 #include <set>
 #include <type_traits>
+#include <vector>
 
 #include <osg/Texture2D>
 
@@ -40,23 +43,38 @@ namespace NifOsg
     template <typename MapT>
     class ValueInterpolator
     {
-        typename MapT::MapType::const_iterator retrieveKey(float time) const
+        /// @return index of the first key at or after \a time
+        /// @note \a time must be between the first and the last key.
+        std::size_t retrieveKey(float time) const
         {
-            // retrieve the current position in the map, optimized for the most common case
+            const std::vector<float>& times = mKeys->mTimes;
+
+            // evenly spaced keys can be found directly, correct for rounding errors
+            if (mKeys->mRate > 0.f)
+            {
+                std::size_t index = std::clamp<std::size_t>(static_cast<std::size_t>((time - times.front()) * mKeys->mRate) + 1, 1, times.size() - 1);
+                while (index > 1 && times[index - 1] >= time)
+                    --index;
+                while (times[index] < time)
+                    ++index;
+                return index;
+            }
+
+            // otherwise start from the previous position, optimized for the most common case
             // where time moves linearly along the keyframe track
-            if (mLastHighKey != mKeys->mKeys.end())
+            std::size_t index = mLastHighKey;
+            if (index > 0 && index < times.size())
             {
-                if (time > mLastHighKey->first)
+                if (time > times[index] && index + 1 < times.size())
                 {
                     // try if we're there by incrementing one
-                    ++mLastLowKey;
-                    ++mLastHighKey;
+                    ++index;
                 }
-                if (mLastHighKey != mKeys->mKeys.end() && time >= mLastLowKey->first && time <= mLastHighKey->first)
-                    return mLastHighKey;
+                if (time >= times[index - 1] && time <= times[index])
+                    return index;
             }
 
-            return mKeys->mKeys.lower_bound(time);
+            return std::lower_bound(times.begin(), times.end(), time) - times.begin();
         }
 
     public:
@@ -84,22 +102,12 @@ namespace NifOsg
             if (interpolator->data.empty())
                 return;
             mKeys = interpolator->data->mKeyList;
-            if (mKeys)
-            {
-                mLastLowKey = mKeys->mKeys.end();
-                mLastHighKey = mKeys->mKeys.end();
-            }
         }
 
         ValueInterpolator(std::shared_ptr<const MapT> keys, ValueT defaultVal = ValueT())
             : mKeys(keys)
             , mDefaultVal(defaultVal)
         {
-            if (keys)
-            {
-                mLastLowKey = mKeys->mKeys.end();
-                mLastHighKey = mKeys->mKeys.end();
-            }
         }
 
         ValueT interpKey(float time) const
@@ -107,31 +115,30 @@ namespace NifOsg
             if (empty())
                 return mDefaultVal;
 
-            const typename MapT::MapType & keys = mKeys->mKeys;
+            const std::vector<float>& times = mKeys->mTimes;
+            const std::vector<typename MapT::KeyType>& values = mKeys->mValues;
 
-            if(time <= keys.begin()->first)
-                return keys.begin()->second.mValue;
+            if (time <= times.front())
+                return values.front().mValue;
 
-            typename MapT::MapType::const_iterator it = retrieveKey(time);
+            if (time > times.back())
+                return values.back().mValue;
 
             // now do the actual interpolation
-            if (it != keys.end())
-            {
-                // cache for next time
-                mLastHighKey = it;
-                mLastLowKey = --it;
+            const std::size_t high = retrieveKey(time);
+            const std::size_t low = high - 1;
 
-                float a = (time - mLastLowKey->first) / (mLastHighKey->first - mLastLowKey->first);
+            // cache for next time
+            mLastHighKey = high;
 
-                return interpolate(mLastLowKey->second, mLastHighKey->second, a, mKeys->mInterpolationType);
-            }
+            float a = (time - times[low]) / (times[high] - times[low]);
 
-            return keys.rbegin()->second.mValue;
+            return interpolate(values[low], values[high], a, mKeys->mInterpolationType);
         }
 
         bool empty() const
         {
-            return !mKeys || mKeys->mKeys.empty();
+            return !mKeys || mKeys->empty();
         }
 
     private:
@@ -180,8 +187,7 @@ namespace NifOsg
             }
         }
 
-        mutable typename MapT::MapType::const_iterator mLastLowKey;
-        mutable typename MapT::MapType::const_iterator mLastHighKey;
+        mutable std::size_t mLastHighKey = 0;
 
         std::shared_ptr<const MapT> mKeys;
 
@@ -231,7 +237,8 @@ namespace NifOsg
         std::vector<FloatInterpolator> mKeyFrames;
     };
 
-    class KeyframeController : public SceneUtil::KeyframeController, public SceneUtil::NodeCallback<KeyframeController, NifOsg::MatrixTransform*>
+    class KeyframeController : public SceneUtil::KeyframeController, public SceneUtil::NodeCallback<KeyframeController, NifOsg::MatrixTransform*>,
+                               public SceneUtil::BatchedCallback
     {
     public:
         KeyframeController();
@@ -245,6 +252,8 @@ namespace NifOsg
 
         void operator() (NifOsg::MatrixTransform*, osg::NodeVisitor*);
 
+        void applyBatched(osg::Node* node, osg::NodeVisitor* nv) override;
+
     private:
         QuaternionInterpolator mRotations;
 
@@ -258,6 +267,8 @@ namespace NifOsg
         Nif::NiKeyframeData::AxisOrder mAxisOrder{Nif::NiKeyframeData::AxisOrder::Order_XYZ};
 
         osg::Quat getXYZRotation(float time) const;
+
+        void apply(NifOsg::MatrixTransform* node, float time) const;
     };
 
     class UVController : public SceneUtil::StateSetUpdater, public SceneUtil::Controller
@@ -472,7 +472,7 @@ namespace NifOsg
             else
             {
                 std::string filename = Misc::ResourceHelpers::correctTexturePath(st->filename, imageManager->getVFS());
-                image = imageManager->getImage(filename);
+                image = imageManager->getStreamedImage(filename);
             }
             return image;
         }
@@ -956,7 +956,7 @@ namespace NifOsg
 
         void handleParticlePrograms(Nif::NiParticleModifierPtr affectors, Nif::NiParticleModifierPtr colliders, osg::Group *attachTo, osgParticle::ParticleSystem* partsys, osgParticle::ParticleProcessor::ReferenceFrame rf)
         {
-            osgParticle::ModularProgram* program = new osgParticle::ModularProgram;
+            osgParticle::ModularProgram* program = new ParticleProgram;
             attachTo->addChild(program);
             program->setParticleSystem(partsys);
             program->setReferenceFrame(rf);
@@ -1786,7 +1786,7 @@ namespace NifOsg
                     }
                 }
                 std::string filename = Misc::ResourceHelpers::correctTexturePath(textureSet->textures[i], imageManager->getVFS());
-                osg::ref_ptr<osg::Image> image = imageManager->getImage(filename);
+                osg::ref_ptr<osg::Image> image = imageManager->getStreamedImage(filename);
                 osg::ref_ptr<osg::Texture2D> texture2d = new osg::Texture2D(image);
                 if (image)
                     texture2d->setTextureSize(image->s(), image->t());
@@ -1983,7 +1983,7 @@ namespace NifOsg
                         boundTextures.clear();
                     }
                     std::string filename = Misc::ResourceHelpers::correctTexturePath(texprop->filename, imageManager->getVFS());
-                    osg::ref_ptr<osg::Image> image = imageManager->getImage(filename);
+                    osg::ref_ptr<osg::Image> image = imageManager->getStreamedImage(filename);
                     osg::ref_ptr<osg::Texture2D> texture2d = new osg::Texture2D(image);
                     texture2d->setName("diffuseMap");
                     if (image)
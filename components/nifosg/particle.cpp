@@ -1,5 +1,6 @@
 #include "particle.hpp"
 
+#include <algorithm>
 #include <limits>
 #include <optional>
 
@@ -96,6 +97,62 @@ namespace
         std::optional<osg::Matrix> mLastMatrix;
         osg::Transform* mLastAppliedTransform = nullptr;
     };
+
+    std::vector<osg::observer_ptr<osg::Node>> toCachedPath(const osg::NodePath& path)
+    {
+        return std::vector<osg::observer_ptr<osg::Node>>(path.begin(), path.end());
+    }
+
+    // Returns false if the path was not cached yet, or if any of its nodes were deleted or re-parented since
+    bool getCachedPath(const std::vector<osg::observer_ptr<osg::Node>>& cached, osg::NodePath& path)
+    {
+        path.clear();
+        if (cached.empty())
+            return false;
+
+        for (const osg::observer_ptr<osg::Node>& node : cached)
+        {
+            osg::ref_ptr<osg::Node> locked;
+            if (!node.lock(locked))
+                return false;
+
+            if (!path.empty())
+            {
+                const osg::Node::ParentList& parents = locked->getParents();
+                if (std::find(parents.begin(), parents.end(), path.back()) == parents.end())
+                    return false;
+            }
+
+            // Kept alive by the scene graph as long as the path is valid
+            path.push_back(locked.get());
+        }
+        return true;
+    }
+
+    // Small enough for the particles to stay in the cache until the last operator is applied to them
+    constexpr int sParticleBatchSize = 64;
+
+    // The operators of this file are final, so that the call isn't virtual for them
+    template <class T>
+    void operateRange(osgParticle::Operator* op, osgParticle::ParticleSystem* partsys, int begin, int end, double dt)
+    {
+        T* const concreteOp = static_cast<T*>(op);
+        for (int i = begin; i < end; ++i)
+        {
+            osgParticle::Particle* particle = partsys->getParticle(i);
+            if (particle->isAlive())
+                concreteOp->operate(particle, dt);
+        }
+    }
+
+    template <class T, class ... Other>
+    auto getOperateRange(osgParticle::Operator* op)
+    {
+        if constexpr (sizeof...(Other) == 0)
+            return &operateRange<T>;
+        else
+            return dynamic_cast<T*>(op) ? &operateRange<T> : getOperateRange<Other...>(op);
+    }
 }
 
 namespace NifOsg
@@ -209,6 +266,40 @@ void ParticleShooter::shoot(osgParticle::Particle *particle) const
     particle->setLifeTime(std::max(std::numeric_limits<float>::epsilon(), mLifetime + mLifetimeRandom * Misc::Rng::rollClosedProbability()));
 }
 
+ParticleProgram::ParticleProgram(const ParticleProgram& copy, const osg::CopyOp& copyop)
+    : osgParticle::ModularProgram(copy, copyop)
+{
+}
+
+void ParticleProgram::execute(double dt)
+{
+    mEnabledOperators.clear();
+    for (int i = 0; i < numOperators(); ++i)
+    {
+        osgParticle::Operator* op = getOperator(i);
+        if (!op->isEnabled())
+            continue;
+        op->beginOperate(this);
+        mEnabledOperators.push_back({op, getOperateRange<GrowFadeAffector, ParticleColorAffector, GravityAffector,
+            PlanarCollider, SphericalCollider, osgParticle::Operator>(op)});
+    }
+
+    if (!mEnabledOperators.empty())
+    {
+        osgParticle::ParticleSystem* partsys = getParticleSystem();
+        const int numParticles = partsys->numParticles();
+        for (int begin = 0; begin < numParticles; begin += sParticleBatchSize)
+        {
+            const int end = std::min(begin + sParticleBatchSize, numParticles);
+            for (const EnabledOperator& op : mEnabledOperators)
+                op.mOperateRange(op.mOperator, partsys, begin, end, dt);
+        }
+    }
+
+    for (const EnabledOperator& op : mEnabledOperators)
+        op.mOperator->endOperate();
+}
+
 GrowFadeAffector::GrowFadeAffector(float growTime, float fadeTime)
     : mGrowTime(growTime)
     , mFadeTime(fadeTime)
@@ -384,11 +475,22 @@ void Emitter::emitParticles(double dt)
     osg::Matrix worldToPs;
 
     // maybe this could be optimized by halting at the lowest common ancestor of the particle and emitter nodes
-    osg::NodePathList partsysNodePaths = getParticleSystem()->getParentalNodePaths();
-    if (!partsysNodePaths.empty())
+    osg::NodePath partsysNodePath;
+    if (!getCachedPath(mCachedParticleSystemPath, partsysNodePath) || partsysNodePath.front()->getNumParents() != 0)
+    {
+        osg::NodePathList partsysNodePaths = getParticleSystem()->getParentalNodePaths();
+        partsysNodePath = partsysNodePaths.empty() ? osg::NodePath() : partsysNodePaths[0];
+        mCachedParticleSystemPath = toCachedPath(partsysNodePath);
+    }
+    if (!partsysNodePath.empty())
     {
-        osg::Matrix psToWorld = osg::computeLocalToWorld(partsysNodePaths[0]);
-        worldToPs = osg::Matrix::inverse(psToWorld);
+        const osg::Matrix psToWorld = osg::computeLocalToWorld(partsysNodePath);
+        if (psToWorld != mCachedPsToWorld)
+        {
+            mCachedPsToWorld = psToWorld;
+            mCachedWorldToPs = osg::Matrix::inverse(psToWorld);
+        }
+        worldToPs = mCachedWorldToPs;
     }
 
     const osg::Matrix& ltw = getLocalToWorldMatrix();
@@ -415,14 +517,24 @@ void Emitter::emitParticles(double dt)
             recIndex = mTargets[randomIndex];
         }
 
-        // we could use a map here for faster lookup
-        FindGroupByRecIndex visitor(recIndex);
-        getParent(0)->accept(visitor);
-
-        if (!visitor.mFound)
+        osg::ref_ptr<osg::Group> found;
+        osg::NodePath path;
+        CachedTarget& target = mCachedTargets[recIndex];
+        if (!target.mGroup.lock(found) || !getCachedPath(target.mPath, path) || path.front() != getParent(0))
         {
-            Log(Debug::Info) << "Can't find emitter node" << recIndex;
-            return;
+            FindGroupByRecIndex visitor(recIndex);
+            getParent(0)->accept(visitor);
+
+            if (!visitor.mFound)
+            {
+                Log(Debug::Info) << "Can't find emitter node" << recIndex;
+                return;
+            }
+
+            found = visitor.mFound;
+            path = visitor.mFoundPath;
+            target.mGroup = found;
+            target.mPath = toCachedPath(path);
         }
 
         if (useGeometryEmitter)
@@ -430,7 +542,7 @@ void Emitter::emitParticles(double dt)
             if (!mCachedGeometryEmitter.lock(geometryVertices))
             {
                 FindFirstGeometry geometryVisitor;
-                visitor.mFound->accept(geometryVisitor);
+                found->accept(geometryVisitor);
 
                 if (geometryVisitor.mGeometry)
                 {
@@ -443,7 +555,6 @@ void Emitter::emitParticles(double dt)
             }
         }
 
-        osg::NodePath path = visitor.mFoundPath;
         path.erase(path.begin());
         if (!useGeometryEmitter && (mFlags & Nif::NiNode::BSPArrayController_AtNode) && path.size())
         {
@@ -1,8 +1,11 @@
 #ifndef OPENMW_COMPONENTS_NIFOSG_PARTICLE_H
 #define OPENMW_COMPONENTS_NIFOSG_PARTICLE_H
 
+#include <map>
 #include <optional>
+#include <vector>
 
+#include <osgParticle/ModularProgram>
 #include <osgParticle/Particle>
 #include <osgParticle/Shooter>
 #include <osgParticle/Operator>
@@ -100,7 +103,34 @@ namespace NifOsg
         float mLifetimeRandom;
     };
 
-    class PlanarCollider : public osgParticle::Operator
+    // Subclass ModularProgram to apply all operators to small batches of particles in turn, in a single pass over the
+    // particles, rather than iterating over all particles once per operator. The operators of this file are applied
+    // without a virtual call per particle.
+    // @note Only suitable for operators that don't override operateParticles.
+    class ParticleProgram : public osgParticle::ModularProgram
+    {
+    public:
+        ParticleProgram() = default;
+        ParticleProgram(const ParticleProgram& copy, const osg::CopyOp& copyop = osg::CopyOp::SHALLOW_COPY);
+
+        META_Node(NifOsg, ParticleProgram)
+
+    protected:
+        void execute(double dt) override;
+
+    private:
+        using OperateRange = void (*)(osgParticle::Operator* op, osgParticle::ParticleSystem* partsys, int begin, int end, double dt);
+
+        struct EnabledOperator
+        {
+            osgParticle::Operator* mOperator;
+            OperateRange mOperateRange;
+        };
+
+        std::vector<EnabledOperator> mEnabledOperators;
+    };
+
+    class PlanarCollider final : public osgParticle::Operator
     {
     public:
         PlanarCollider(const Nif::NiPlanarCollider* collider);
@@ -121,7 +151,7 @@ namespace NifOsg
         osg::Plane mPlane, mPlaneInParticleSpace;
     };
 
-    class SphericalCollider : public osgParticle::Operator
+    class SphericalCollider final : public osgParticle::Operator
     {
     public:
         SphericalCollider(const Nif::NiSphericalCollider* collider);
@@ -138,7 +168,7 @@ namespace NifOsg
         osg::BoundingSphere mSphereInParticleSpace;
     };
 
-    class GrowFadeAffector : public osgParticle::Operator
+    class GrowFadeAffector final : public osgParticle::Operator
     {
     public:
         GrowFadeAffector(float growTime, float fadeTime);
@@ -159,7 +189,7 @@ namespace NifOsg
         float mCachedDefaultSize;
     };
 
-    class ParticleColorAffector : public osgParticle::Operator
+    class ParticleColorAffector final : public osgParticle::Operator
     {
     public:
         ParticleColorAffector(const Nif::NiColorData* clrdata);
@@ -176,7 +206,7 @@ namespace NifOsg
         Vec4Interpolator mData;
     };
 
-    class GravityAffector : public osgParticle::Operator
+    class GravityAffector final : public osgParticle::Operator
     {
     public:
         GravityAffector(const Nif::NiGravity* gravity);
@@ -256,6 +286,22 @@ namespace NifOsg
 
         std::optional<int> mGeometryEmitterTarget;
         osg::observer_ptr<osg::Vec3Array> mCachedGeometryEmitter;
+
+        // Node paths looked up on the first emission, reused as long as the scene graph doesn't change
+        using CachedNodePath = std::vector<osg::observer_ptr<osg::Node>>;
+
+        struct CachedTarget
+        {
+            osg::observer_ptr<osg::Group> mGroup;
+            CachedNodePath mPath;
+        };
+
+        CachedNodePath mCachedParticleSystemPath;
+        std::map<int, CachedTarget> mCachedTargets;
+
+        // The inverse is only computed again when the particle system has moved
+        osg::Matrix mCachedPsToWorld;
+        osg::Matrix mCachedWorldToPs;
     };
 
 }
@@ -7,6 +7,7 @@
 #include <components/misc/pathhelpers.hpp>
 #include <components/vfs/manager.hpp>
 
+#include "imageresidency.hpp"
 #include "objectcache.hpp"
 
 #ifdef OSG_LIBRARY_STATIC
@@ -47,6 +48,7 @@ namespace Resource
 
     ImageManager::ImageManager(const VFS::Manager *vfs)
         : ResourceManager(vfs)
+        , mResidency(std::make_unique<ImageResidency>(vfs))
         , mWarningImage(createWarningImage())
         , mOptions(new osgDB::Options("dds_flip dds_dxt1_detect_rgba ignoreTga2Fields"))
         , mOptionsNoFlip(new osgDB::Options("dds_dxt1_detect_rgba ignoreTga2Fields"))
@@ -188,14 +190,87 @@ namespace Resource
         }
     }
 
+    osg::ref_ptr<osg::Image> ImageManager::getStreamedImage(const std::string &filename)
+    {
+        if (!mResidency->isEnabled())
+            return getImage(filename);
+
+        const std::string normalized = mVFS->normalizeFilename(filename);
+
+        osg::ref_ptr<osg::Object> obj = mCache->getRefFromObjectCache(normalized);
+        if (obj)
+            return osg::ref_ptr<osg::Image>(static_cast<osg::Image*>(obj.get()));
+
+        osg::ref_ptr<osg::Image> image;
+        try
+        {
+            image = mResidency->load(normalized, true);
+        }
+        catch (std::exception&)
+        {
+            // let getImage() report the error
+        }
+
+        if (!image || !checkSupported(image, filename))
+            return getImage(filename);
+
+        mCache->addEntryToObjectCache(normalized, image);
+        return image;
+    }
+
     osg::Image *ImageManager::getWarningImage()
     {
         return mWarningImage;
     }
 
+    void ImageManager::updateCache(double referenceTime)
+    {
+        ResourceManager::updateCache(referenceTime);
+
+        if (mResidency->isEnabled())
+            mResidency->update();
+    }
+
     void ImageManager::reportStats(unsigned int frameNumber, osg::Stats *stats) const
     {
         stats->setAttribute(frameNumber, "Image", mCache->getCacheSize());
+
+        struct CountBytes
+        {
+            const ImageResidency& mResidency;
+            std::size_t mTextures = 0;
+            std::size_t mIcons = 0;
+            std::size_t mBookArt = 0;
+            std::size_t mOther = 0;
+
+            void operator()(const std::string& name, osg::Object* object)
+            {
+                const osg::Image* image = static_cast<const osg::Image*>(object);
+                // reported separately, their size is changed by the draw thread
+                if (mResidency.isEnabled() && mResidency.isStreamed(*image))
+                    return;
+                const std::size_t size = image->getTotalSizeInBytesIncludingMipmaps();
+                if (name.rfind("textures/", 0) == 0)
+                    mTextures += size;
+                else if (name.rfind("icons/", 0) == 0)
+                    mIcons += size;
+                else if (name.rfind("bookart/", 0) == 0)
+                    mBookArt += size;
+                else
+                    mOther += size;
+            }
+        };
+
+        CountBytes count {*mResidency};
+        mCache->call(count);
+
+        constexpr double mebibyte = 1024.0 * 1024.0;
+        stats->setAttribute(frameNumber, "Image MiB Textures", count.mTextures / mebibyte);
+        stats->setAttribute(frameNumber, "Image MiB Icons", count.mIcons / mebibyte);
+        stats->setAttribute(frameNumber, "Image MiB BookArt", count.mBookArt / mebibyte);
+        stats->setAttribute(frameNumber, "Image MiB Other", count.mOther / mebibyte);
+        if (mResidency->isEnabled())
+            stats->setAttribute(frameNumber, "Image MiB Streamed", mResidency->getResidentBytes() / mebibyte);
     }
 
 }
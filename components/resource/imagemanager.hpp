@@ -3,6 +3,7 @@
 
 #include <string>
 #include <map>
+#include <memory>
 
 #include <osg/ref_ptr>
 #include <osg/Image>
@@ -17,6 +18,7 @@ namespace osgDB
 
 namespace Resource
 {
+    class ImageResidency;
 
     /// @brief Handles loading/caching of Images.
     /// @note May be used from any thread.
@@ -30,11 +32,23 @@ namespace Resource
         /// Returns the dummy image if the given image is not found.
         osg::ref_ptr<osg::Image> getImage(const std::string& filename, bool disableFlip = false);
 
+        /// Create or retrieve an Image used by a model.
+        /// If texture streaming is enabled, large DDS images are loaded without their higher mip levels at first,
+        /// these are streamed in by the ImageResidency once the models using them are seen up close.
+        osg::ref_ptr<osg::Image> getStreamedImage(const std::string& filename);
+
+        ImageResidency& getResidency() { return *mResidency; }
+
         osg::Image* getWarningImage();
 
+        /// Clear unused cache entries and update the mip levels of streamed images.
+        void updateCache(double referenceTime) override;
+
         void reportStats(unsigned int frameNumber, osg::Stats* stats) const override;
 
     private:
+        std::unique_ptr<ImageResidency> mResidency;
+
         osg::ref_ptr<osg::Image> mWarningImage;
         osg::ref_ptr<osgDB::Options> mOptions;
         osg::ref_ptr<osgDB::Options> mOptionsNoFlip;
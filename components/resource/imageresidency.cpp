@@ -0,0 +1,438 @@
+#include "imageresidency.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <memory>
+
+#include <osg/NodeVisitor>
+#include <osg/Texture>
+#include <osgUtil/CullVisitor>
+
+#include <components/debug/debuglog.hpp>
+#include <components/misc/pathhelpers.hpp>
+#include <components/sceneutil/nodecallback.hpp>
+#include <components/vfs/manager.hpp>
+
+namespace
+{
+    constexpr std::size_t ddsHeaderSize = 128;
+
+    constexpr std::uint32_t ddpfFourCC = 0x4;
+    constexpr std::uint32_t ddsCaps2CubeMap = 0x200;
+    constexpr std::uint32_t ddsCaps2Volume = 0x200000;
+
+    std::uint32_t readUInt32(const unsigned char* data)
+    {
+        return static_cast<std::uint32_t>(data[0])
+            | (static_cast<std::uint32_t>(data[1]) << 8)
+            | (static_cast<std::uint32_t>(data[2]) << 16)
+            | (static_cast<std::uint32_t>(data[3]) << 24);
+    }
+
+    struct DdsInfo
+    {
+        unsigned int mWidth;
+        unsigned int mHeight;
+        unsigned int mNumLevels;
+        GLenum mFormat;
+    };
+
+    /// Read the header of a DDS file, only accepts 2D DXT1/3/5 images with a mip chain.
+    bool readDdsInfo(std::istream& stream, DdsInfo& info)
+    {
+        unsigned char header[ddsHeaderSize];
+        stream.read(reinterpret_cast<char*>(header), ddsHeaderSize);
+        if (stream.gcount() != static_cast<std::streamsize>(ddsHeaderSize) || std::memcmp(header, "DDS ", 4) != 0)
+            return false;
+
+        if (readUInt32(header + 112) & (ddsCaps2CubeMap | ddsCaps2Volume))
+            return false;
+        if (!(readUInt32(header + 80) & ddpfFourCC))
+            return false;
+
+        const unsigned char* fourCC = header + 84;
+        if (std::memcmp(fourCC, "DXT1", 4) == 0)
+            info.mFormat = GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+        else if (std::memcmp(fourCC, "DXT3", 4) == 0)
+            info.mFormat = GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+        else if (std::memcmp(fourCC, "DXT5", 4) == 0)
+            info.mFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        else
+            return false;
+
+        info.mHeight = readUInt32(header + 12);
+        info.mWidth = readUInt32(header + 16);
+        info.mNumLevels = readUInt32(header + 28);
+        return info.mWidth > 0 && info.mHeight > 0 && info.mNumLevels > 1;
+    }
+
+    /// Mimics the dds_dxt1_detect_rgba option of the OSG dds plugin: DXT1 images using
+    /// punch-through alpha in any of their blocks are treated as RGBA.
+    bool hasDxt1Alpha(const unsigned char* data, std::size_t size)
+    {
+        for (std::size_t block = 0; block + 8 <= size; block += 8)
+        {
+            const unsigned int color0 = data[block] | (data[block + 1] << 8);
+            const unsigned int color1 = data[block + 2] | (data[block + 3] << 8);
+            if (color0 > color1)
+                continue;
+            const std::uint32_t indices = readUInt32(data + block + 4);
+            for (unsigned int i = 0; i < 16; ++i)
+                if (((indices >> (i * 2)) & 0x3) == 0x3)
+                    return true;
+        }
+        return false;
+    }
+
+    unsigned int getLevelDimension(unsigned int size, unsigned int level)
+    {
+        return std::max(size >> level, 1u);
+    }
+
+    std::size_t getLevelsSize(GLenum format, unsigned int width, unsigned int height, unsigned int firstLevel, unsigned int endLevel)
+    {
+        std::size_t size = 0;
+        for (unsigned int level = firstLevel; level < endLevel; ++level)
+            size += Resource::getCompressedLevelSize(format, width, height, level);
+        return size;
+    }
+
+    class StreamingCullCallback : public SceneUtil::NodeCallback<StreamingCullCallback, osg::Node*, osgUtil::CullVisitor*>
+    {
+    public:
+        StreamingCullCallback(std::vector<osg::ref_ptr<Resource::StreamedImage>>&& images)
+            : mImages(std::move(images))
+        {
+        }
+
+        void operator()(osg::Node* node, osgUtil::CullVisitor* cv)
+        {
+            const float pixels = cv->clampedPixelSize(node->getBound());
+            for (const osg::ref_ptr<Resource::StreamedImage>& image : mImages)
+                image->requestSize(pixels);
+            traverse(node, cv);
+        }
+
+    private:
+        std::vector<osg::ref_ptr<Resource::StreamedImage>> mImages;
+    };
+
+    class CollectStreamedImagesVisitor : public osg::NodeVisitor
+    {
+    public:
+        CollectStreamedImagesVisitor(const std::map<std::string, osg::ref_ptr<Resource::StreamedImage>>& images)
+            : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN)
+            , mImages(images)
+        {
+        }
+
+        void apply(osg::Node& node) override
+        {
+            if (const osg::StateSet* stateset = node.getStateSet())
+                collect(*stateset);
+            traverse(node);
+        }
+
+        void collect(const osg::StateSet& stateset)
+        {
+            for (const osg::StateSet::AttributeList& attributes : stateset.getTextureAttributeList())
+            {
+                for (const auto& [type, attribute] : attributes)
+                {
+                    const osg::Texture* texture = attribute.first->asTexture();
+                    if (!texture)
+                        continue;
+                    for (unsigned int i = 0; i < texture->getNumImages(); ++i)
+                    {
+                        const osg::Image* image = texture->getImage(i);
+                        if (!image)
+                            continue;
+                        const auto found = mImages.find(image->getFileName());
+                        if (found == mImages.end() || found->second->mImage.get() != image)
+                            continue;
+                        if (std::find(mResult.begin(), mResult.end(), found->second) == mResult.end())
+                            mResult.push_back(found->second);
+                    }
+                }
+            }
+        }
+
+        std::vector<osg::ref_ptr<Resource::StreamedImage>> mResult;
+
+    private:
+        const std::map<std::string, osg::ref_ptr<Resource::StreamedImage>>& mImages;
+    };
+}
+
+namespace Resource
+{
+
+    std::size_t getCompressedLevelSize(GLenum format, unsigned int width, unsigned int height, unsigned int level)
+    {
+        const std::size_t blockSize = (format == GL_COMPRESSED_RGB_S3TC_DXT1_EXT || format == GL_COMPRESSED_RGBA_S3TC_DXT1_EXT) ? 8 : 16;
+        const std::size_t blocksX = (getLevelDimension(width, level) + 3) / 4;
+        const std::size_t blocksY = (getLevelDimension(height, level) + 3) / 4;
+        return blocksX * blocksY * blockSize;
+    }
+
+    StreamedImage::StreamedImage(const std::string& fileName, bool flip, unsigned int width, unsigned int height,
+                                 unsigned int numLevels, unsigned int baseLevel, GLenum format)
+        : mFileName(fileName)
+        , mFlip(flip)
+        , mWidth(width)
+        , mHeight(height)
+        , mNumLevels(numLevels)
+        , mBaseLevel(baseLevel)
+        , mFormat(format)
+        , mRequestedSize(0.f)
+        , mResidentLevel(baseLevel)
+        , mLastRequestedSize(0.f)
+        , mLastSeen(0)
+    {
+    }
+
+    void StreamedImage::requestSize(float pixels)
+    {
+        float current = mRequestedSize.load(std::memory_order_relaxed);
+        while (pixels > current && !mRequestedSize.compare_exchange_weak(current, pixels, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    ImageResidency::ImageResidency(const VFS::Manager* vfs)
+        : mVFS(vfs)
+        , mEnabled(false)
+        , mBaseSize(256)
+        , mBudget(1024 * 1024 * 1024)
+        , mResidentBytes(0)
+        , mNumUpdates(0)
+    {
+    }
+
+    ImageResidency::~ImageResidency() = default;
+
+    osg::ref_ptr<osg::Image> ImageResidency::load(const std::string& normalized, bool flip)
+    {
+        if (!mEnabled || Misc::getFileExtension(normalized) != "dds")
+            return nullptr;
+
+        Files::IStreamPtr stream = mVFS->get(normalized);
+        DdsInfo info;
+        if (!readDdsInfo(*stream, info) || std::max(info.mWidth, info.mHeight) <= mBaseSize)
+            return nullptr;
+
+        unsigned int baseLevel = 0;
+        while (baseLevel + 1 < info.mNumLevels && std::max(getLevelDimension(info.mWidth, baseLevel), getLevelDimension(info.mHeight, baseLevel)) > mBaseSize)
+            ++baseLevel;
+
+        osg::ref_ptr<StreamedImage> streamed = new StreamedImage(normalized, flip, info.mWidth, info.mHeight,
+                                                                 info.mNumLevels, baseLevel, info.mFormat);
+        osg::ref_ptr<osg::Image> image = loadLevels(*streamed, baseLevel);
+        if (!image)
+            return nullptr;
+        streamed->mImage = image;
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        osg::ref_ptr<StreamedImage>& entry = mImages[normalized];
+        // Another thread may have loaded the same file in the meantime, the image it returned has to stay streamed
+        osg::ref_ptr<osg::Image> existing;
+        if (entry != nullptr && entry->mImage.lock(existing))
+            return existing;
+        entry = streamed;
+        return image;
+    }
+
+    osg::ref_ptr<osg::Image> ImageResidency::loadLevels(const StreamedImage& image, unsigned int firstLevel) const
+    {
+        Files::IStreamPtr stream = mVFS->get(image.mFileName);
+        stream->seekg(ddsHeaderSize + getLevelsSize(image.mFormat, image.mWidth, image.mHeight, 0, firstLevel));
+
+        const std::size_t size = getLevelsSize(image.mFormat, image.mWidth, image.mHeight, firstLevel, image.mNumLevels);
+        std::unique_ptr<unsigned char[]> data(new unsigned char[size]);
+        stream->read(reinterpret_cast<char*>(data.get()), size);
+        if (stream->gcount() != static_cast<std::streamsize>(size))
+        {
+            Log(Debug::Error) << "Error loading " << image.mFileName << ": unexpected end of file";
+            return nullptr;
+        }
+
+        GLenum format = image.mFormat;
+        if (format == GL_COMPRESSED_RGB_S3TC_DXT1_EXT && hasDxt1Alpha(data.get(), size))
+            format = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+
+        osg::Image::MipmapDataType mipmaps;
+        std::size_t offset = 0;
+        for (unsigned int level = firstLevel; level + 1 < image.mNumLevels; ++level)
+        {
+            offset += getCompressedLevelSize(image.mFormat, image.mWidth, image.mHeight, level);
+            mipmaps.push_back(static_cast<unsigned int>(offset));
+        }
+
+        osg::ref_ptr<osg::Image> result = new osg::Image;
+        result->setFileName(image.mFileName);
+        result->setImage(getLevelDimension(image.mWidth, firstLevel), getLevelDimension(image.mHeight, firstLevel), 1,
+                         format, format, GL_UNSIGNED_BYTE, data.release(), osg::Image::USE_NEW_DELETE);
+        result->setMipmapLevels(mipmaps);
+        if (image.mFlip)
+            result->flipVertical();
+        return result;
+    }
+
+    void ImageResidency::addCullCallback(osg::Node& node)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        CollectStreamedImagesVisitor visitor(mImages);
+        node.accept(visitor);
+        if (!visitor.mResult.empty())
+            node.addCullCallback(new StreamingCullCallback(std::move(visitor.mResult)));
+    }
+
+    bool ImageResidency::isStreamed(const osg::Image& image) const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        const auto found = mImages.find(image.getFileName());
+        return found != mImages.end() && found->second->mImage.get() == &image;
+    }
+
+    void ImageResidency::update()
+    {
+        ++mNumUpdates;
+
+        std::vector<osg::ref_ptr<StreamedImage>> images;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            for (auto it = mImages.begin(); it != mImages.end();)
+            {
+                if (!it->second->mImage.valid())
+                    it = mImages.erase(it);
+                else
+                {
+                    images.push_back(it->second);
+                    ++it;
+                }
+            }
+        }
+
+        std::vector<unsigned int> levels;
+        std::vector<unsigned int> wantedLevels;
+        levels.reserve(images.size());
+        wantedLevels.reserve(images.size());
+        std::size_t totalBytes = 0;
+        for (const osg::ref_ptr<StreamedImage>& image : images)
+        {
+            image->mLastRequestedSize = image->mRequestedSize.exchange(0.f, std::memory_order_relaxed);
+
+            unsigned int wanted = image->mBaseLevel;
+            if (image->mLastRequestedSize > 0.f)
+            {
+                const float texels = static_cast<float>(std::max(image->mWidth, image->mHeight));
+                const float level = std::floor(std::log2(std::max(texels / image->mLastRequestedSize, 1.f)));
+                wanted = std::min(static_cast<unsigned int>(level), image->mBaseLevel);
+                image->mLastSeen = mNumUpdates;
+            }
+            // keep the levels that are already loaded as long as they fit into the budget
+            const unsigned int level = std::min(wanted, image->mResidentLevel);
+            levels.push_back(level);
+            wantedLevels.push_back(wanted);
+            totalBytes += getLevelsSize(image->mFormat, image->mWidth, image->mHeight, level, image->mNumLevels);
+        }
+
+        if (totalBytes > mBudget)
+        {
+            // reduce the least recently seen and then the least visible images first
+            std::vector<std::size_t> order(images.size());
+            for (std::size_t i = 0; i < order.size(); ++i)
+                order[i] = i;
+            std::sort(order.begin(), order.end(), [&] (std::size_t lhs, std::size_t rhs)
+            {
+                if (images[lhs]->mLastSeen != images[rhs]->mLastSeen)
+                    return images[lhs]->mLastSeen < images[rhs]->mLastSeen;
+                return images[lhs]->mLastRequestedSize < images[rhs]->mLastRequestedSize;
+            });
+
+            // drop the levels that aren't wanted anymore before those that are shown
+            for (const bool wantedOnly : {true, false})
+            {
+                for (std::size_t i : order)
+                {
+                    const StreamedImage& image = *images[i];
+                    const unsigned int lowest = wantedOnly ? wantedLevels[i] : image.mBaseLevel;
+                    while (totalBytes > mBudget && levels[i] < lowest)
+                    {
+                        totalBytes -= getCompressedLevelSize(image.mFormat, image.mWidth, image.mHeight, levels[i]);
+                        ++levels[i];
+                    }
+                    if (totalBytes <= mBudget)
+                        break;
+                }
+            }
+        }
+
+        mResidentBytes = totalBytes;
+
+        std::vector<Pending> pending;
+        for (std::size_t i = 0; i < images.size(); ++i)
+        {
+            StreamedImage& image = *images[i];
+            if (levels[i] == image.mResidentLevel)
+                continue;
+
+            try
+            {
+                osg::ref_ptr<osg::Image> loaded = loadLevels(image, levels[i]);
+                if (!loaded)
+                    continue;
+                image.mResidentLevel = levels[i];
+                pending.push_back(Pending {images[i], std::move(loaded)});
+            }
+            catch (const std::exception& e)
+            {
+                Log(Debug::Error) << "Failed to stream image " << image.mFileName << ": " << e.what();
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        mPending.insert(mPending.end(), std::make_move_iterator(pending.begin()), std::make_move_iterator(pending.end()));
+    }
+
+    void ImageResidency::apply()
+    {
+        std::vector<Pending> pending;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            pending.swap(mPending);
+        }
+
+        for (const Pending& update : pending)
+        {
+            osg::ref_ptr<osg::Image> image;
+            if (!update.mStreamedImage->mImage.lock(image))
+                continue;
+
+            const osg::Image& levels = *update.mLevels;
+
+            // The data is handed over to the streamed image
+            update.mLevels->setAllocationMode(osg::Image::NO_DELETE);
+
+            // a changed size makes the textures using this image reload it from scratch
+            image->setImage(levels.s(), levels.t(), levels.r(), levels.getInternalTextureFormat(), levels.getPixelFormat(),
+                            levels.getDataType(), const_cast<unsigned char*>(levels.data()), osg::Image::USE_NEW_DELETE, levels.getPacking());
+            image->setMipmapLevels(levels.getMipmapLevels());
+        }
+    }
+
+    ApplyImageResidencyOperation::ApplyImageResidencyOperation(ImageResidency& residency)
+        : osg::GraphicsOperation("ApplyImageResidencyOperation", true)
+        , mResidency(residency)
+    {
+    }
+
+    void ApplyImageResidencyOperation::operator()(osg::GraphicsContext* /*graphicsContext*/)
+    {
+        mResidency.apply();
+    }
+
+}
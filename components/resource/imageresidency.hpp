@@ -0,0 +1,146 @@
+#ifndef OPENMW_COMPONENTS_RESOURCE_IMAGERESIDENCY_H
+#define OPENMW_COMPONENTS_RESOURCE_IMAGERESIDENCY_H
+
+#include <atomic>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <osg/GraphicsThread>
+#include <osg/Image>
+#include <osg/observer_ptr>
+#include <osg/ref_ptr>
+
+namespace VFS
+{
+    class Manager;
+}
+
+namespace osg
+{
+    class Node;
+}
+
+namespace Resource
+{
+
+    /// @brief Mip level residency of a single streamed image.
+    class StreamedImage : public osg::Referenced
+    {
+    public:
+        StreamedImage(const std::string& fileName, bool flip, unsigned int width, unsigned int height,
+                      unsigned int numLevels, unsigned int baseLevel, GLenum format);
+
+        /// Report that the image is shown with roughly this size in pixels.
+        /// @note May be called from any thread.
+        void requestSize(float pixels);
+
+        const std::string mFileName;
+        const bool mFlip;
+        /// Size of the largest mip level of the file.
+        const unsigned int mWidth;
+        const unsigned int mHeight;
+        const unsigned int mNumLevels;
+        /// Largest mip level that is always resident.
+        const unsigned int mBaseLevel;
+        const GLenum mFormat;
+
+        osg::observer_ptr<osg::Image> mImage;
+
+    private:
+        friend class ImageResidency;
+
+        std::atomic<float> mRequestedSize;
+
+        // Accessed by the thread updating the residency only
+        unsigned int mResidentLevel;
+        float mLastRequestedSize;
+        std::size_t mLastSeen;
+    };
+
+    /// @brief Streams mip levels of large DDS images in and out depending on their size on screen.
+    /// @par Images are initially loaded without the mip levels larger than the base size. Cull callbacks
+    ///     installed by addCullCallback() report the on-screen size of the models using them, higher levels
+    ///     are then loaded by update() and swapped in by apply(). Loaded levels are kept until the resident
+    ///     images exceed the memory budget, then the least recently seen ones are reduced to lower levels again.
+    class ImageResidency
+    {
+    public:
+        ImageResidency(const VFS::Manager* vfs);
+        ~ImageResidency();
+
+        void setEnabled(bool enabled) { mEnabled = enabled; }
+        bool isEnabled() const { return mEnabled; }
+
+        /// Largest width or height of the mip levels loaded initially.
+        void setBaseSize(unsigned int size) { mBaseSize = size; }
+
+        /// Memory budget for all streamed images, in bytes.
+        void setBudget(std::size_t bytes) { mBudget = bytes; }
+
+        /// Load the low mip levels of a streamable image.
+        /// @return nullptr if the file is not a DDS file with a mip chain larger than the base size.
+        /// @note May be called from any thread.
+        osg::ref_ptr<osg::Image> load(const std::string& normalized, bool flip);
+
+        /// Install a cull callback on the given model reporting its size on screen to the streamed images used by it.
+        /// @note Call before the model is shared between threads.
+        void addCullCallback(osg::Node& node);
+
+        /// Pick the resident mip levels of all streamed images and load those that changed.
+        /// @note Called from a worker thread, only one thread may call it at a time.
+        void update();
+
+        /// Swap the mip levels loaded by update() into their images.
+        /// @note Call from the draw thread between frames, see ApplyImageResidencyOperation.
+        void apply();
+
+        /// Whether the mip levels of this image are changed by apply(), so its data may only be used by the draw thread.
+        bool isStreamed(const osg::Image& image) const;
+
+        /// Size of all streamed images, in bytes.
+        std::size_t getResidentBytes() const { return mResidentBytes; }
+
+    private:
+        struct Pending
+        {
+            osg::ref_ptr<StreamedImage> mStreamedImage;
+            osg::ref_ptr<osg::Image> mLevels;
+        };
+
+        const VFS::Manager* mVFS;
+        bool mEnabled;
+        unsigned int mBaseSize;
+        std::size_t mBudget;
+        std::atomic<std::size_t> mResidentBytes;
+        std::size_t mNumUpdates;
+
+        mutable std::mutex mMutex;
+        std::map<std::string, osg::ref_ptr<StreamedImage>> mImages;
+        std::vector<Pending> mPending;
+
+        osg::ref_ptr<osg::Image> loadLevels(const StreamedImage& image, unsigned int firstLevel) const;
+    };
+
+    /// @brief Applies the mip levels streamed by an ImageResidency after each frame is drawn.
+    /// @par Textures upload their images on the draw thread, so that is the only thread that may swap the data.
+    ///     Add to the graphics context, the ImageResidency has to outlive the viewer.
+    class ApplyImageResidencyOperation : public osg::GraphicsOperation
+    {
+    public:
+        ApplyImageResidencyOperation(ImageResidency& residency);
+
+        void operator()(osg::GraphicsContext* graphicsContext) override;
+
+    private:
+        ImageResidency& mResidency;
+    };
+
+    /// Size in bytes of the given mip level of an image in the given compressed format.
+    std::size_t getCompressedLevelSize(GLenum format, unsigned int width, unsigned int height, unsigned int level);
+
+}
+
+#endif
@@ -43,6 +43,7 @@
 #include <components/files/memorystream.hpp>
 
 #include "imagemanager.hpp"
+#include "imageresidency.hpp"
 #include "niffilemanager.hpp"
 #include "objectcache.hpp"
 
@@ -412,10 +413,12 @@ namespace Resource
     {
         mLightingMethod = method;
 
-        if (mLightingMethod == SceneUtil::LightingMethod::SingleUBO)
+        if (mLightingMethod == SceneUtil::LightingMethod::SingleUBO || mLightingMethod == SceneUtil::LightingMethod::Clustered)
         {
             osg::ref_ptr<osg::Program> program = new osg::Program;
             program->addBindUniformBlock("LightBufferBinding", static_cast<int>(UBOBinding::LightBuffer));
+            if (mLightingMethod == SceneUtil::LightingMethod::Clustered)
+                program->addBindUniformBlock("ClusterBufferBinding", static_cast<int>(UBOBinding::ClusterBuffer));
             mShaderManager->setProgramTemplate(program);
         }
     }
@@ -712,6 +715,9 @@ namespace Resource
             else
                 shareState(loaded);
 
+            if (mImageManager->getResidency().isEnabled())
+                mImageManager->getResidency().addCullCallback(*loaded);
+
             if (compile && mIncrementalCompileOperation)
                 mIncrementalCompileOperation->add(loaded);
             else
@@ -115,7 +115,8 @@ namespace Resource
         {
             // If we add more UBO's, we should probably assign their bindings dynamically according to the current count of UBO's in the programTemplate
             LightBuffer,
-            PostProcessor
+            PostProcessor,
+            ClusterBuffer
         };
         void setLightingMethod(SceneUtil::LightingMethod method);
         SceneUtil::LightingMethod getLightingMethod() const;
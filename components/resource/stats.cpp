@@ -379,6 +379,11 @@ void StatsHandler::setUpScene(osgViewer::ViewerBase *viewer)
             "Shape",
             "Shape Instance",
             "Image",
+            "Image MiB Textures",
+            "Image MiB Icons",
+            "Image MiB BookArt",
+            "Image MiB Other",
+            "Image MiB Streamed",
             "Nif",
             "Keyframe",
             "",
@@ -407,6 +412,20 @@ void StatsHandler::setUpScene(osgViewer::ViewerBase *viewer)
             "Physics Objects",
             "Physics Projectiles",
             "Physics HeightFields",
+            "Physics LOS Queries",
+            "Physics LOS Raycasts",
+            "Physics LOS Cache",
+            "",
+            "Preload Cells",
+            "Preload Jobs",
+            "Preload Hits",
+            "Preload Missed Cells",
+            "Preload Late",
+            "",
+            "Lua Calls",
+            "Lua Allocated KiB",
+            "Lua Memory KiB",
+            "Lua Deferred",
         });
 
         static const auto longest = std::max_element(statNames.begin(), statNames.end(),
@@ -0,0 +1,185 @@
+#include "animationbatch.hpp"
+
+#include <algorithm>
+
+#include <osg/NodeVisitor>
+#include <osg/observer_ptr>
+
+#include "skeleton.hpp"
+
+namespace SceneUtil
+{
+
+    class AnimationBatchGroup::RootCallback : public SceneUtil::NodeCallback<RootCallback>
+    {
+    public:
+        explicit RootCallback(AnimationBatchGroup* group)
+            : mGroup(group)
+        {
+        }
+
+        void operator()(osg::Node* node, osg::NodeVisitor* nv)
+        {
+            osg::ref_ptr<AnimationBatchGroup> group;
+            if (mGroup.lock(group))
+            {
+                group->mLastVisit = nv->getTraversalNumber();
+                group->update(nv);
+            }
+            traverse(node, nv);
+        }
+
+    private:
+        osg::observer_ptr<AnimationBatchGroup> mGroup;
+    };
+
+    AnimationBatchGroup::AnimationBatchGroup()
+        : mSkeleton(nullptr)
+        , mUpdateBoneMatrices(true)
+        , mLastUpdate(0)
+        , mLastVisit(0)
+    {
+        mRootCallback = new RootCallback(this);
+    }
+
+    void AnimationBatchGroup::add(osg::Node* node, osg::Callback* callback, BatchedCallback* batched)
+    {
+        mNodes.push_back(node);
+        mCallbacks.push_back(batched);
+        mReferences.emplace_back(node, callback);
+    }
+
+    bool AnimationBatchGroup::contains(const osg::Node* node) const
+    {
+        return std::find(mNodes.begin(), mNodes.end(), node) != mNodes.end();
+    }
+
+    void AnimationBatchGroup::clear()
+    {
+        mNodes.clear();
+        mCallbacks.clear();
+        mReferences.clear();
+        mSkeleton = nullptr;
+        mUpdateBoneMatrices = true;
+        // Evaluate the new callbacks even if the old ones were evaluated in this frame
+        mLastUpdate = 0;
+    }
+
+    void AnimationBatchGroup::update(osg::NodeVisitor* nv)
+    {
+        const unsigned int traversalNumber = nv->getTraversalNumber();
+        if (mLastUpdate.exchange(traversalNumber) == traversalNumber)
+            return;
+
+        if (mSkeleton && !mSkeleton->isUpdateNeeded(traversalNumber))
+            return;
+
+        for (std::size_t i = 0; i < mNodes.size(); ++i)
+            mCallbacks[i]->applyBatched(mNodes[i], nv);
+
+        // Nothing moves the bones after this point, so the matrices used for skinning can be computed right away
+        // instead of during the cull traversal
+        if (mSkeleton && mUpdateBoneMatrices)
+            mSkeleton->updateBoneMatrices(traversalNumber);
+    }
+
+    AnimationBatch::AnimationBatch(unsigned int numThreads)
+        : mVisitor(nullptr)
+        , mNextGroup(0)
+        , mGeneration(0)
+        , mBusyThreads(0)
+        , mStop(false)
+    {
+        for (unsigned int i = 0; i < numThreads; ++i)
+            mThreads.emplace_back([this] { run(); });
+    }
+
+    AnimationBatch::~AnimationBatch()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mStop = true;
+        }
+        mHasWork.notify_all();
+        for (std::thread& thread : mThreads)
+            thread.join();
+    }
+
+    void AnimationBatch::addGroup(AnimationBatchGroup* group)
+    {
+        mGroups.emplace_back(group);
+    }
+
+    void AnimationBatch::operator()(osg::Node* node, osg::NodeVisitor* nv)
+    {
+        const unsigned int traversalNumber = nv->getTraversalNumber();
+
+        mGroups.erase(std::remove_if(mGroups.begin(), mGroups.end(),
+            [] (const osg::ref_ptr<AnimationBatchGroup>& group) { return group->referenceCount() == 1; }), mGroups.end());
+
+        // Only update the groups that were reached by the previous update traversal, others are not part of the scene
+        // or are hidden. Groups that become visible are updated by their root callback instead.
+        mActive.clear();
+        for (const osg::ref_ptr<AnimationBatchGroup>& group : mGroups)
+        {
+            if (!group->empty() && group->mLastVisit + 1 >= traversalNumber)
+                mActive.push_back(group.get());
+        }
+
+        mVisitor = nv;
+        mNextGroup = 0;
+
+        if (mThreads.empty() || mActive.size() < 2)
+            process();
+        else
+        {
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mBusyThreads = mThreads.size();
+                ++mGeneration;
+            }
+            mHasWork.notify_all();
+
+            process();
+
+            std::unique_lock<std::mutex> lock(mMutex);
+            mWorkDone.wait(lock, [this] { return mBusyThreads == 0; });
+        }
+
+        mVisitor = nullptr;
+
+        traverse(node, nv);
+    }
+
+    void AnimationBatch::process()
+    {
+        while (true)
+        {
+            const std::size_t index = mNextGroup++;
+            if (index >= mActive.size())
+                return;
+            mActive[index]->update(mVisitor);
+        }
+    }
+
+    void AnimationBatch::run()
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        unsigned int generation = mGeneration;
+        while (true)
+        {
+            mHasWork.wait(lock, [&] { return mStop || mGeneration != generation; });
+            if (mStop)
+                return;
+            generation = mGeneration;
+
+            lock.unlock();
+            process();
+            lock.lock();
+
+            if (--mBusyThreads == 0)
+                mWorkDone.notify_one();
+        }
+    }
+
+}
@@ -0,0 +1,130 @@
+#ifndef OPENMW_COMPONENTS_SCENEUTIL_ANIMATIONBATCH_H
+#define OPENMW_COMPONENTS_SCENEUTIL_ANIMATIONBATCH_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <osg/Node>
+#include <osg/ref_ptr>
+#include <osg/Referenced>
+
+#include <components/sceneutil/nodecallback.hpp>
+
+namespace osg
+{
+    class NodeVisitor;
+}
+
+namespace SceneUtil
+{
+    class Skeleton;
+
+    /// @brief Interface of update callbacks that can be evaluated by an AnimationBatch instead of the update traversal.
+    class BatchedCallback
+    {
+    public:
+        virtual ~BatchedCallback() = default;
+
+        /// Update the node like the callback would during the update traversal, without traversing the node.
+        /// @note May be called from worker threads, but never concurrently for callbacks of the same AnimationBatchGroup.
+        virtual void applyBatched(osg::Node* node, osg::NodeVisitor* nv) = 0;
+    };
+
+    /// @brief The batched callbacks of a single animated object.
+    class AnimationBatchGroup : public osg::Referenced
+    {
+    public:
+        AnimationBatchGroup();
+
+        /// @param skeleton skeleton moved by the callbacks or nullptr. Its bone matrices are updated with the callbacks,
+        ///     unless setUpdateBoneMatrices(false) was called.
+        void setSkeleton(Skeleton* skeleton) { mSkeleton = skeleton; }
+
+        /// Set whether the bone matrices can be updated right after the callbacks. Disable this if other update callbacks
+        /// modify the bones later on, the matrices are then updated on demand during the cull traversal as usual.
+        void setUpdateBoneMatrices(bool update) { mUpdateBoneMatrices = update; }
+
+        /// Add a callback for the given node. Callbacks are evaluated in the order they are added, so those of parent
+        /// nodes must be added before those of their children.
+        void add(osg::Node* node, osg::Callback* callback, BatchedCallback* batched);
+
+        /// @return true if the node has a callback in this group.
+        bool contains(const osg::Node* node) const;
+
+        void clear();
+
+        bool empty() const { return mNodes.empty(); }
+
+        /// Evaluate all callbacks, unless it was done already in this frame.
+        void update(osg::NodeVisitor* nv);
+
+        /// Update callback to install on the root of the animated object, used to find out whether it is still part of
+        /// the scene. It also updates the group if the batch did not, e.g. in the frame the group was added.
+        osg::Callback* getRootCallback() { return mRootCallback; }
+
+    private:
+        friend class AnimationBatch;
+
+        class RootCallback;
+
+        Skeleton* mSkeleton;
+        bool mUpdateBoneMatrices;
+
+        // Packed by the order of evaluation
+        std::vector<osg::Node*> mNodes;
+        std::vector<BatchedCallback*> mCallbacks;
+        std::vector<std::pair<osg::ref_ptr<osg::Node>, osg::ref_ptr<osg::Callback>>> mReferences;
+
+        std::atomic<unsigned int> mLastUpdate;
+        unsigned int mLastVisit;
+
+        osg::ref_ptr<osg::Callback> mRootCallback;
+    };
+
+    /// @brief Evaluates the keyframe and bone controllers of all animated objects in a single pass at the beginning of
+    ///     the update traversal, rather than in individual update callbacks spread over the scene graph.
+    /// @par The pass can be split across worker threads, each object is updated by one thread only.
+    /// @note Install as update callback of the scene root.
+    class AnimationBatch : public SceneUtil::NodeCallback<AnimationBatch>
+    {
+    public:
+        /// @param numThreads number of worker threads, if 0 the pass runs in the calling thread only.
+        explicit AnimationBatch(unsigned int numThreads);
+        ~AnimationBatch();
+
+        /// @note Groups are released once they are no longer referenced elsewhere, so their owners can be destroyed
+        ///     from any thread.
+        void addGroup(AnimationBatchGroup* group);
+
+        void operator()(osg::Node* node, osg::NodeVisitor* nv);
+
+        std::size_t getNumGroups() const { return mGroups.size(); }
+        std::size_t getNumUpdated() const { return mActive.size(); }
+
+    private:
+        void process();
+        void run();
+
+        std::vector<osg::ref_ptr<AnimationBatchGroup>> mGroups;
+        std::vector<AnimationBatchGroup*> mActive;
+
+        osg::NodeVisitor* mVisitor;
+        std::atomic<std::size_t> mNextGroup;
+
+        std::mutex mMutex;
+        std::condition_variable mHasWork;
+        std::condition_variable mWorkDone;
+        unsigned int mGeneration;
+        std::size_t mBusyThreads;
+        bool mStop;
+        std::vector<std::thread> mThreads;
+    };
+
+}
+
+#endif
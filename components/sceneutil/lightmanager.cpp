@@ -1,6 +1,7 @@
 #include "lightmanager.hpp"
 
 #include <array>
+#include <cmath>
 #include <cstring>
 #include <algorithm>
 #include <iterator>
@@ -244,6 +245,65 @@ namespace SceneUtil
         osg::Vec4 mCachedSunPos;
     };
 
+    // Light indices of the view space clusters of a camera, laid out as a std140 uniform block:
+    // ivec4 ClusterGrid[sGridSize] holds the offset and count of the lights of each cluster,
+    // ivec4 ClusterIndices[sIndicesSize] holds the light buffer indices of all clusters, packed in pairs of 16 bits.
+    class ClusterBuffer : public osg::Referenced
+    {
+    public:
+        static constexpr int sTilesX = 16;
+        static constexpr int sTilesY = 8;
+        static constexpr int sSlices = 16;
+        static constexpr int sNumClusters = sTilesX * sTilesY * sSlices;
+        static constexpr int sMaxIndices = 4096;
+        static constexpr int sGridSize = sNumClusters / 4;
+        static constexpr int sIndicesSize = sMaxIndices / 8;
+
+        ClusterBuffer()
+            : mData(new osg::IntArray((sGridSize + sIndicesSize) * 4))
+        {
+            osg::ref_ptr<osg::UniformBufferObject> ubo = new osg::UniformBufferObject;
+            ubo->setUsage(GL_STREAM_DRAW);
+            mData->setBufferObject(ubo);
+
+#if OSG_VERSION_GREATER_OR_EQUAL(3,5,7)
+            mBinding = new osg::UniformBufferBinding(static_cast<int>(Resource::SceneManager::UBOBinding::ClusterBuffer), mData, 0, mData->getTotalDataSize());
+#else
+            mBinding = new osg::UniformBufferBinding(static_cast<int>(Resource::SceneManager::UBOBinding::ClusterBuffer), ubo, 0, mData->getTotalDataSize());
+#endif
+        }
+
+        ClusterBuffer(const ClusterBuffer&) = delete;
+
+        void setCluster(int cluster, int offset, int count)
+        {
+            (*mData)[cluster] = offset | (count << 16);
+        }
+
+        void setIndex(int index, int lightIndex)
+        {
+            int& packed = (*mData)[sGridSize * 4 + index / 2];
+            if (index % 2 == 0)
+                packed = lightIndex;
+            else
+                packed |= lightIndex << 16;
+        }
+
+        void dirty()
+        {
+            mData->dirty();
+        }
+
+        osg::UniformBufferBinding* getBinding()
+        {
+            return mBinding;
+        }
+
+    private:
+        osg::ref_ptr<osg::IntArray> mData;
+        osg::ref_ptr<osg::UniformBufferBinding> mBinding;
+    };
+
     struct LightStateCache
     {
         std::vector<osg::Light*> lastAppliedLight;
@@ -279,6 +339,7 @@ namespace SceneUtil
                 break;
             }
         case LightingMethod::SingleUBO:
+        case LightingMethod::Clustered:
             {
                 osg::ref_ptr<LightBuffer> buffer = new LightBuffer(lightManager->getMaxLightsInScene());
 
@@ -301,6 +362,58 @@ namespace SceneUtil
         }
     }
 
+    std::optional<ClusterRange> getClusterRange(const osg::Vec3f& center, float radius, const osg::Matrix& projectionMatrix,
+        const osg::Vec2f& depthParams, int tilesX, int tilesY, int slices)
+    {
+        const float minDepth = -center.z() - radius;
+        const float maxDepth = -center.z() + radius;
+        if (maxDepth <= 0.f)
+            return std::nullopt;
+
+        auto getSlice = [&] (float depth)
+        {
+            if (depth <= depthParams.x())
+                return 0;
+            return std::min(static_cast<int>(std::log(depth / depthParams.x()) * depthParams.y()), slices - 1);
+        };
+        auto getTile = [] (float ndc, int numTiles)
+        {
+            return std::clamp(static_cast<int>((ndc * 0.5f + 0.5f) * numTiles), 0, numTiles - 1);
+        };
+
+        ClusterRange range;
+        range.mMinZ = getSlice(minDepth);
+        range.mMaxZ = getSlice(maxDepth);
+
+        if (minDepth <= 0.f)
+        {
+            // The camera is inside the bounds of the light, which can cover the whole screen
+            range.mMinX = range.mMinY = 0;
+            range.mMaxX = tilesX - 1;
+            range.mMaxY = tilesY - 1;
+            return range;
+        }
+
+        // Project the corners of the view space bounding box
+        osg::Vec2f minNdc(1.f, 1.f);
+        osg::Vec2f maxNdc(-1.f, -1.f);
+        for (int i = 0; i < 8; ++i)
+        {
+            osg::Vec4f corner(center.x() + (i & 1 ? radius : -radius), center.y() + (i & 2 ? radius : -radius), center.z() + (i & 4 ? radius : -radius), 1.f);
+            osg::Vec4f clip = corner * projectionMatrix;
+            osg::Vec2f ndc(clip.x() / clip.w(), clip.y() / clip.w());
+            minNdc = osg::Vec2f(std::min(minNdc.x(), ndc.x()), std::min(minNdc.y(), ndc.y()));
+            maxNdc = osg::Vec2f(std::max(maxNdc.x(), ndc.x()), std::max(maxNdc.y(), ndc.y()));
+        }
+        if (minNdc.x() > 1.f || minNdc.y() > 1.f || maxNdc.x() < -1.f || maxNdc.y() < -1.f)
+            return std::nullopt;
+        range.mMinX = getTile(minNdc.x(), tilesX);
+        range.mMaxX = getTile(maxNdc.x(), tilesX);
+        range.mMinY = getTile(minNdc.y(), tilesY);
+        range.mMaxY = getTile(maxNdc.y(), tilesY);
+        return range;
+    }
+
     class DisableLight : public osg::StateAttribute
     {
     public:
@@ -599,7 +712,7 @@ namespace SceneUtil
         {
             osg::ref_ptr<osg::StateSet> stateset = new osg::StateSet;
 
-            if (node->getLightingMethod() == LightingMethod::SingleUBO)
+            if (node->getLightingMethod() == LightingMethod::SingleUBO || node->getLightingMethod() == LightingMethod::Clustered)
             {
                 auto buffer = node->getUBOManager()->getLightBuffer(cv->getTraversalNumber());
 
@@ -617,6 +730,16 @@ namespace SceneUtil
                     buffer->setDiffuse(0, sun->getDiffuse());
                     buffer->setSpecular(0, sun->getSpecular());
                 }
+
+                if (node->getLightingMethod() == LightingMethod::Clustered)
+                {
+                    bool clustered = cv->getCurrentCamera()->getName() == Constants::SceneCamera;
+                    if (clustered)
+                        node->updateClusters(cv, cv->getTraversalNumber());
+
+                    stateset->setAttributeAndModes(node->getClusterBuffer(cv->getTraversalNumber())->getBinding(), osg::StateAttribute::ON);
+                    stateset->addUniform(new osg::Uniform("ClusteredLighting", clustered));
+                }
             }
             else if (node->getLightingMethod() == LightingMethod::PerObjectUniform)
             {
@@ -757,6 +880,7 @@ namespace SceneUtil
          {"legacy", LightingMethod::FFP}
         ,{"shaders compatibility", LightingMethod::PerObjectUniform}
         ,{"shaders", LightingMethod::SingleUBO}
+        ,{"clustered", LightingMethod::Clustered}
     };
 
     LightingMethod LightManager::getLightingMethodFromString(const std::string& value)
@@ -782,6 +906,7 @@ namespace SceneUtil
         : mStartLight(0)
         , mLightingMask(~0u)
         , mSun(nullptr)
+        , mClusterCamera(nullptr)
         , mPointLightRadiusMultiplier(1.f)
         , mPointLightFadeEnd(0.f)
         , mPointLightFadeStart(0.f)
@@ -793,6 +918,7 @@ namespace SceneUtil
         mSupported[static_cast<int>(LightingMethod::FFP)] = true;
         mSupported[static_cast<int>(LightingMethod::PerObjectUniform)] = true;
         mSupported[static_cast<int>(LightingMethod::SingleUBO)] = supportsUBO && supportsGPU4;
+        mSupported[static_cast<int>(LightingMethod::Clustered)] = supportsUBO && supportsGPU4;
 
         setUpdateCallback(new LightManagerUpdateCallback);
 
@@ -807,7 +933,7 @@ namespace SceneUtil
 
         static bool hasLoggedWarnings = false;
 
-        if (lightingMethod == LightingMethod::SingleUBO && !hasLoggedWarnings)
+        if ((lightingMethod == LightingMethod::SingleUBO || lightingMethod == LightingMethod::Clustered) && !hasLoggedWarnings)
         {
             if (!supportsUBO)
                 Log(Debug::Warning) << "GL_ARB_uniform_buffer_object not supported: switching to shader compatibility lighting mode";
@@ -820,6 +946,8 @@ namespace SceneUtil
 
         if (!supportsUBO || !supportsGPU4 || lightingMethod == LightingMethod::PerObjectUniform)
             initPerObjectUniform(targetLights);
+        else if (lightingMethod == LightingMethod::Clustered)
+            initClustered(targetLights);
         else
             initSingleUBO(targetLights);
 
@@ -835,6 +963,7 @@ namespace SceneUtil
         , mStartLight(copy.mStartLight)
         , mLightingMask(copy.mLightingMask)
         , mSun(copy.mSun)
+        , mClusterCamera(nullptr)
         , mLightingMethod(copy.mLightingMethod)
         , mPointLightRadiusMultiplier(copy.mPointLightRadiusMultiplier)
         , mPointLightFadeEnd(copy.mPointLightFadeEnd)
@@ -878,12 +1007,19 @@ namespace SceneUtil
         defines["maxLightsInScene"] = std::to_string(getMaxLightsInScene());
         defines["lightingMethodFFP"] = getLightingMethod() == LightingMethod::FFP ? "1" : "0";
         defines["lightingMethodPerObjectUniform"] = getLightingMethod() == LightingMethod::PerObjectUniform ? "1" : "0";
-        defines["lightingMethodUBO"] = getLightingMethod() == LightingMethod::SingleUBO ? "1" : "0";
-        defines["useUBO"] = std::to_string(getLightingMethod() == LightingMethod::SingleUBO);
+        bool useUBO = getLightingMethod() == LightingMethod::SingleUBO || getLightingMethod() == LightingMethod::Clustered;
+        defines["lightingMethodUBO"] = useUBO ? "1" : "0";
+        defines["lightingMethodClustered"] = getLightingMethod() == LightingMethod::Clustered ? "1" : "0";
+        defines["useUBO"] = std::to_string(useUBO);
         // exposes bitwise operators
-        defines["useGPUShader4"] = std::to_string(getLightingMethod() == LightingMethod::SingleUBO);
+        defines["useGPUShader4"] = std::to_string(useUBO);
         defines["getLight"] = getLightingMethod() == LightingMethod::FFP ? "gl_LightSource" : "LightBuffer";
-        defines["startLight"] =  getLightingMethod() == LightingMethod::SingleUBO ? "0" : "1";
+        defines["startLight"] =  useUBO ? "0" : "1";
+        defines["clusterTilesX"] = std::to_string(ClusterBuffer::sTilesX);
+        defines["clusterTilesY"] = std::to_string(ClusterBuffer::sTilesY);
+        defines["clusterSlices"] = std::to_string(ClusterBuffer::sSlices);
+        defines["clusterGridSize"] = std::to_string(ClusterBuffer::sGridSize);
+        defines["clusterIndicesSize"] = std::to_string(ClusterBuffer::sIndicesSize);
         defines["endLight"] = getLightingMethod() == LightingMethod::FFP ? defines["maxLights"] : "PointLightCount";
 
         return defines;
@@ -924,6 +1060,9 @@ namespace SceneUtil
             mPointLightFadeStart = std::clamp(Settings::Manager::getFloat("light fade start", "Shaders"), 0.f, 1.f);
             mPointLightFadeStart = mPointLightFadeEnd * mPointLightFadeStart;
         }
+
+        if (getLightingMethod() == LightingMethod::Clustered)
+            getOrCreateStateSet()->getOrCreateUniform("ClusterDepthParams", osg::Uniform::FLOAT_VEC2)->set(getClusterDepthParams());
     }
 
     void LightManager::initFFP(int targetLights)
@@ -952,6 +1091,18 @@ namespace SceneUtil
         getOrCreateStateSet()->setAttributeAndModes(mUBOManager);
     }
 
+    void LightManager::initClustered(int targetLights)
+    {
+        initSingleUBO(targetLights);
+        setLightingMethod(LightingMethod::Clustered);
+
+        for (auto& buffer : mClusterBuffers)
+            buffer = new ClusterBuffer;
+
+        getOrCreateStateSet()->setAttributeAndModes(mClusterBuffers[0]->getBinding());
+        getOrCreateStateSet()->addUniform(new osg::Uniform("ClusteredLighting", false));
+    }
+
     void LightManager::setLightingMethod(LightingMethod method)
     {
         mLightingMethod = method;
@@ -961,6 +1112,7 @@ namespace SceneUtil
             mStateSetGenerator = std::make_unique<StateSetGeneratorFFP>();
             break;
         case LightingMethod::SingleUBO:
+        case LightingMethod::Clustered:
             mStateSetGenerator = std::make_unique<StateSetGeneratorSingleUBO>();
             break;
         case LightingMethod::PerObjectUniform:
@@ -1009,6 +1161,7 @@ namespace SceneUtil
         getLightIndexMap(frameNum).clear();
         mLights.clear();
         mLightsInViewSpace.clear();
+        mClusterCamera = nullptr;
 
         // Do an occasional cleanup for orphaned lights.
         for (int i = 0; i < 2; ++i)
@@ -1059,7 +1212,7 @@ namespace SceneUtil
 
         // possible optimization: return a StateSet containing all requested lights plus some extra lights (if a suitable one exists)
 
-        if (getLightingMethod() == LightingMethod::SingleUBO)
+        if (getLightingMethod() == LightingMethod::SingleUBO || getLightingMethod() == LightingMethod::Clustered)
         {
             for (size_t i = 0; i < lightList.size(); ++i)
             {
@@ -1151,7 +1304,7 @@ namespace SceneUtil
             }
         }
 
-        if (getLightingMethod() == LightingMethod::SingleUBO)
+        if (getLightingMethod() == LightingMethod::SingleUBO || getLightingMethod() == LightingMethod::Clustered)
         {
             if (it->second.size() > static_cast<size_t>(getMaxLightsInScene() - 1))
             {
@@ -1176,6 +1329,101 @@ namespace SceneUtil
         buf->setPosition(index, light->getPosition() * (*viewMatrix));
     }
 
+    osg::Vec2f LightManager::getClusterDepthParams() const
+    {
+        // Everything closer than the first slice shares it, the slices beyond grow exponentially up to the light fade distance
+        constexpr float near = 64.f;
+        float far = std::max(near * 2.f, mPointLightFadeEnd > 0.f ? mPointLightFadeEnd : 8192.f);
+        return osg::Vec2f(near, ClusterBuffer::sSlices / std::log(far / near));
+    }
+
+    void LightManager::updateClusters(osgUtil::CullVisitor* cv, size_t frameNum)
+    {
+        mClusterCamera = cv->getCurrentCamera();
+
+        const osg::RefMatrix* viewMatrix = cv->getCurrentRenderStage()->getInitialViewMatrix();
+        const osg::Matrix& projectionMatrix = *cv->getProjectionMatrix();
+        const std::vector<LightSourceViewBound>& lights = getLightsInViewSpace(cv, viewMatrix, frameNum);
+
+        // Nearest lights first, so that the furthest ones are dropped from full clusters
+        LightList lightList;
+        lightList.reserve(lights.size());
+        for (const auto& light : lights)
+            lightList.push_back(&light);
+        std::sort(lightList.begin(), lightList.end(), sortLights);
+
+        const osg::Vec2f depthParams = getClusterDepthParams();
+
+        struct LightRange
+        {
+            int mLightIndex;
+            ClusterRange mClusters;
+        };
+        std::vector<LightRange> ranges;
+        ranges.reserve(lightList.size());
+        std::array<int, ClusterBuffer::sNumClusters> counts {};
+
+        auto& lightIndexMap = getLightIndexMap(frameNum);
+        for (const LightSourceViewBound* light : lightList)
+        {
+            auto id = light->mLightSource->getId();
+            auto found = lightIndexMap.find(id);
+            if (found == lightIndexMap.end())
+            {
+                int index = lightIndexMap.size() + 1;
+                if (index >= getMaxLightsInScene())
+                    continue;
+                updateGPUPointLight(index, light->mLightSource, frameNum, viewMatrix);
+                found = lightIndexMap.emplace(id, index).first;
+            }
+
+            // Point lights in the shaders reach twice their radius, see perLightPoint in lighting.glsl. The view bound
+            // scaled by the light bounds multiplier can be smaller, which would leave seams at the edges of clusters.
+            const std::optional<ClusterRange> clusters = getClusterRange(light->mViewBound.center(),
+                2.f * light->mLightSource->getRadius(), projectionMatrix, depthParams,
+                ClusterBuffer::sTilesX, ClusterBuffer::sTilesY, ClusterBuffer::sSlices);
+            if (!clusters)
+                continue;
+
+            const ClusterRange& range = *clusters;
+            for (int z = range.mMinZ; z <= range.mMaxZ; ++z)
+                for (int y = range.mMinY; y <= range.mMaxY; ++y)
+                    for (int x = range.mMinX; x <= range.mMaxX; ++x)
+                        ++counts[(z * ClusterBuffer::sTilesY + y) * ClusterBuffer::sTilesX + x];
+            ranges.push_back({found->second, range});
+        }
+
+        ClusterBuffer* buffer = getClusterBuffer(frameNum);
+        std::array<int, ClusterBuffer::sNumClusters> offsets;
+        int offset = 0;
+        for (int i = 0; i < ClusterBuffer::sNumClusters; ++i)
+        {
+            counts[i] = std::clamp(std::min(counts[i], getMaxLights()), 0, ClusterBuffer::sMaxIndices - offset);
+            offsets[i] = offset;
+            buffer->setCluster(i, offset, counts[i]);
+            offset += counts[i];
+        }
+
+        std::array<int, ClusterBuffer::sNumClusters> filled {};
+        for (const auto& [lightIndex, range] : ranges)
+        {
+            for (int z = range.mMinZ; z <= range.mMaxZ; ++z)
+            {
+                for (int y = range.mMinY; y <= range.mMaxY; ++y)
+                {
+                    for (int x = range.mMinX; x <= range.mMaxX; ++x)
+                    {
+                        int cluster = (z * ClusterBuffer::sTilesY + y) * ClusterBuffer::sTilesX + x;
+                        if (filled[cluster] < counts[cluster])
+                            buffer->setIndex(offsets[cluster] + filled[cluster]++, lightIndex);
+                    }
+                }
+            }
+        }
+
+        buffer->dirty();
+    }
+
     osg::ref_ptr<osg::Uniform> LightManager::generateLightBufferUniform(const osg::Matrixf& sun)
     {
         osg::ref_ptr<osg::Uniform> uniform = new osg::Uniform(osg::Uniform::FLOAT_MAT4, "LightBuffer", getMaxLights());
@@ -1233,6 +1481,10 @@ namespace SceneUtil
         if (!(cv->getTraversalMask() & mLightManager->getLightingMask()))
             return false;
 
+        // The lights are looked up in the clusters by the shaders
+        if (mLightManager->isClusteredCamera(cv->getCurrentCamera()))
+            return false;
+
         // Possible optimizations:
         // - organize lights in a quad tree
 
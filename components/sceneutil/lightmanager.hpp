@@ -5,6 +5,7 @@
 #include <unordered_map>
 #include <memory>
 #include <array>
+#include <optional>
 
 #include <osg/Light>
 #include <osg/Group>
@@ -24,6 +25,7 @@ namespace osgUtil
 namespace SceneUtil
 {
     class LightBuffer;
+    class ClusterBuffer;
     struct StateSetGenerator;
 
     class PPLightBuffer
@@ -89,6 +91,7 @@ namespace SceneUtil
         FFP,
         PerObjectUniform,
         SingleUBO,
+        Clustered,
     };
 
     /// LightSource managed by a LightManager.
@@ -225,7 +228,7 @@ namespace SceneUtil
         };
 
         using LightList = std::vector<const LightSourceViewBound*>;
-        using SupportedMethods = std::array<bool, 3>;
+        using SupportedMethods = std::array<bool, 4>;
 
         META_Node(SceneUtil, LightManager)
 
@@ -254,6 +257,18 @@ namespace SceneUtil
 
         osg::ref_ptr<osg::StateSet> getLightListStateSet(const LightList& lightList, size_t frameNum, const osg::RefMatrix* viewMatrix);
 
+        /// Bin the lights visible to the camera into its view space clusters, see LightingMethod::Clustered.
+        /// @note Only the camera of the main scene uses clusters, other cameras get per-object light lists.
+        void updateClusters(osgUtil::CullVisitor* cv, size_t frameNum);
+
+        /// Whether objects rendered by the camera get their lights from the clusters instead of light lists.
+        bool isClusteredCamera(const osg::Camera* camera) const { return camera == mClusterCamera; }
+
+        ClusterBuffer* getClusterBuffer(size_t frameNum) { return mClusterBuffers[frameNum%2]; }
+
+        /// Depth of the first cluster slice and the scale to get the slice from the logarithm of the depth.
+        osg::Vec2f getClusterDepthParams() const;
+
         void setSunlight(osg::ref_ptr<osg::Light> sun);
         osg::ref_ptr<osg::Light> getSunlight();
 
@@ -294,6 +309,7 @@ namespace SceneUtil
         void initFFP(int targetLights);
         void initPerObjectUniform(int targetLights);
         void initSingleUBO(int targetLights);
+        void initClustered(int targetLights);
 
         void updateSettings();
 
@@ -333,6 +349,9 @@ namespace SceneUtil
 
         osg::ref_ptr<UBOManager> mUBOManager;
 
+        std::array<osg::ref_ptr<ClusterBuffer>, 2> mClusterBuffers;
+        const osg::Camera* mClusterCamera;
+
         LightingMethod mLightingMethod;
 
         float mPointLightRadiusMultiplier;
@@ -392,6 +411,19 @@ namespace SceneUtil
 
     void configureStateSetSunOverride(LightManager* lightManager, const osg::Light* light, osg::StateSet* stateset, int mode = osg::StateAttribute::ON|osg::StateAttribute::OVERRIDE);
 
+    struct ClusterRange
+    {
+        int mMinX, mMaxX, mMinY, mMaxY, mMinZ, mMaxZ;
+    };
+
+    /// Get the clusters of a grid with the given number of tiles and depth slices that a point light can reach, the
+    /// same way lcalcCluster in lighting_util.glsl finds the cluster of a fragment.
+    /// @param center View space position of the light.
+    /// @param radius Distance at which the light stops affecting fragments.
+    /// @return std::nullopt if the light is behind the camera or off screen.
+    std::optional<ClusterRange> getClusterRange(const osg::Vec3f& center, float radius, const osg::Matrix& projectionMatrix,
+        const osg::Vec2f& depthParams, int tilesX, int tilesY, int slices);
+
 }
 
 #endif
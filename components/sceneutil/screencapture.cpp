@@ -31,6 +31,8 @@ namespace
                 assert(mImpl != nullptr);
             }
 
+            const char* getTraceName() const override { return "screencapture"; }
+
             void doWork() override
             {
                 if (mAborted)
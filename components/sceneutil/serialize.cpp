@@ -138,6 +138,7 @@ void registerSerializers()
             "NifOsg::FlipController",
             "NifOsg::KeyframeController",
             "NifOsg::Emitter",
+            "NifOsg::ParticleProgram",
             "NifOsg::ParticleColorAffector",
             "NifOsg::ParticleSystem",
             "NifOsg::GravityAffector",
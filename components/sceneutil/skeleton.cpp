@@ -128,6 +128,15 @@ bool Skeleton::getActive() const
     return mActive != Inactive;
 }
 
+bool Skeleton::isUpdateNeeded(unsigned int traversalNumber) const
+{
+    if (mActive == Inactive && mLastFrameNumber != 0)
+        return false;
+    if (mActive == SemiActive && mLastFrameNumber != 0 && mLastCullFrameNumber+3 <= traversalNumber)
+        return false;
+    return true;
+}
+
 void Skeleton::markDirty()
 {
     mLastFrameNumber = 0;
@@ -139,9 +148,7 @@ void Skeleton::traverse(osg::NodeVisitor& nv)
 {
     if (nv.getVisitorType() == osg::NodeVisitor::UPDATE_VISITOR)
     {
-        if (mActive == Inactive && mLastFrameNumber != 0)
-            return;
-        if (mActive == SemiActive && mLastFrameNumber != 0 && mLastCullFrameNumber+3 <= nv.getTraversalNumber())
+        if (!isUpdateNeeded(nv.getTraversalNumber()))
             return;
     }
     else if (nv.getVisitorType() == osg::NodeVisitor::CULL_VISITOR)
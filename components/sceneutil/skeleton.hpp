@@ -61,6 +61,9 @@ namespace SceneUtil
 
         bool getActive() const;
 
+        /// Whether the update traversal of the given frame should update the skeleton, depending on the active flag.
+        bool isUpdateNeeded(unsigned int traversalNumber) const;
+
         void traverse(osg::NodeVisitor& nv) override;
 
         void markDirty();
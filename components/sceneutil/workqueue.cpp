@@ -1,6 +1,7 @@
 #include "workqueue.hpp"
 
 #include <components/debug/debuglog.hpp>
+#include <components/debug/trace.hpp>
 
 #include <numeric>
 
@@ -125,13 +126,17 @@ WorkThread::~WorkThread()
 
 void WorkThread::run()
 {
+    Debug::setTraceThreadName("WorkQueue");
     while (true)
     {
         osg::ref_ptr<WorkItem> item = mWorkQueue->removeWorkItem();
         if (!item)
             return;
         mActive = true;
-        item->doWork();
+        {
+            const Debug::TraceZone zone(item->getTraceName());
+            item->doWork();
+        }
         item->signalDone();
         mActive = false;
     }
@@ -19,6 +19,9 @@ namespace SceneUtil
         /// Override in a derived WorkItem to perform actual work.
         virtual void doWork() {}
 
+        /// Name of the zone doWork() is recorded in by Debug::TraceZone, must outlive the program like a string literal.
+        virtual const char* getTraceName() const { return "workitem"; }
+
         bool isDone() const;
 
         /// Wait until the work is completed. Usually called from the main thread.
@@ -65,6 +68,8 @@ namespace SceneUtil
 
         unsigned int getNumActiveThreads() const;
 
+        std::size_t getNumThreads() const { return mThreads.size(); }
+
     private:
         bool mIsReleased;
         std::deque<osg::ref_ptr<WorkItem> > mQueue;
@@ -17,6 +17,7 @@
 #include "storage.hpp"
 #include "texturemanager.hpp"
 #include "compositemaprenderer.hpp"
+#include "diskcache.hpp"
 
 namespace Terrain
 {
@@ -187,6 +188,9 @@ osg::ref_ptr<osg::Node> ChunkManager::createChunk(float chunkSize, const osg::Ve
 {
     osg::ref_ptr<TerrainDrawable> geometry (new TerrainDrawable);
 
+    std::size_t landHash = 0;
+    bool useDiskCache = !templateGeometry && mDiskCache && mStorage->getLandHash(chunkSize, chunkCenter, landHash);
+
     if (!templateGeometry)
     {
         osg::ref_ptr<osg::Vec3Array> positions (new osg::Vec3Array);
@@ -194,7 +198,15 @@ osg::ref_ptr<osg::Node> ChunkManager::createChunk(float chunkSize, const osg::Ve
         osg::ref_ptr<osg::Vec4ubArray> colors (new osg::Vec4ubArray);
         colors->setNormalize(true);
 
-        mStorage->fillVertexBuffers(lod, chunkSize, chunkCenter, positions, normals, colors);
+        if (!useDiskCache || !mDiskCache->loadVertexBuffers(chunkSize, chunkCenter, lod, landHash, *positions, *normals, *colors))
+        {
+            positions->clear();
+            normals->clear();
+            colors->clear();
+            mStorage->fillVertexBuffers(lod, chunkSize, chunkCenter, positions, normals, colors);
+            if (useDiskCache)
+                mDiskCache->saveVertexBuffers(chunkSize, chunkCenter, lod, landHash, *positions, *normals, *colors);
+        }
 
         osg::ref_ptr<osg::VertexBufferObject> vbo (new osg::VertexBufferObject);
         positions->setVertexBufferObject(vbo);
@@ -257,9 +269,31 @@ osg::ref_ptr<osg::Node> ChunkManager::createChunk(float chunkSize, const osg::Ve
             osg::ref_ptr<CompositeMap> compositeMap = new CompositeMap;
             compositeMap->mTexture = createCompositeMapRTT();
 
-            createCompositeMapGeometry(chunkSize, chunkCenter, osg::Vec4f(0,0,1,1), *compositeMap);
-
-            mCompositeMapRenderer->addCompositeMap(compositeMap.get(), false);
+            osg::ref_ptr<osg::Image> cachedImage;
+            if (useDiskCache)
+                cachedImage = mDiskCache->loadCompositeMap(chunkSize, chunkCenter, landHash, mCompositeMapSize);
+
+            if (cachedImage)
+            {
+                compositeMap->mTexture->setImage(cachedImage);
+                compositeMap->mTexture->setUnRefImageDataAfterApply(true);
+            }
+            else
+            {
+                createCompositeMapGeometry(chunkSize, chunkCenter, osg::Vec4f(0,0,1,1), *compositeMap);
+
+                if (useDiskCache)
+                {
+                    // The draw thread may read the map back after the terrain is gone
+                    std::shared_ptr<DiskCache> diskCache = mDiskCache;
+                    compositeMap->mReadBack = [=] (osg::ref_ptr<osg::Image> image)
+                    {
+                        diskCache->saveCompositeMap(chunkSize, chunkCenter, landHash, image);
+                    };
+                }
+
+                mCompositeMapRenderer->addCompositeMap(compositeMap.get(), false);
+            }
 
             geometry->setCompositeMap(compositeMap);
             geometry->setCompositeMapRenderer(mCompositeMapRenderer);
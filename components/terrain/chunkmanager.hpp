@@ -1,6 +1,7 @@
 #ifndef OPENMW_COMPONENTS_TERRAIN_CHUNKMANAGER_H
 #define OPENMW_COMPONENTS_TERRAIN_CHUNKMANAGER_H
 
+#include <memory>
 #include <tuple>
 
 #include <components/resource/resourcemanager.hpp>
@@ -27,6 +28,7 @@ namespace Terrain
     class Storage;
     class CompositeMap;
     class TerrainDrawable;
+    class DiskCache;
 
     typedef std::tuple<osg::Vec2f, unsigned char, unsigned int> ChunkId; // Center, Lod, Lod Flags
 
@@ -42,6 +44,9 @@ namespace Terrain
         void setCompositeMapLevel(float level) { mCompositeMapLevel = level; }
         void setMaxCompositeGeometrySize(float maxCompGeometrySize) { mMaxCompGeometrySize = maxCompGeometrySize; }
 
+        /// Reuse vertex data and composite maps stored on disk by previous sessions. Pass nullptr to disable.
+        void setDiskCache(std::shared_ptr<DiskCache> diskCache) { mDiskCache = std::move(diskCache); }
+
         void setNodeMask(unsigned int mask) { mNodeMask = mask; }
         unsigned int getNodeMask() override { return mNodeMask; }
 
@@ -64,6 +69,7 @@ namespace Terrain
         Resource::SceneManager* mSceneManager;
         TextureManager* mTextureManager;
         CompositeMapRenderer* mCompositeMapRenderer;
+        std::shared_ptr<DiskCache> mDiskCache;
         BufferCache mBufferCache;
 
         osg::ref_ptr<osg::StateSet> mMultiPassRoot;
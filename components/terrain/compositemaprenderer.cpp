@@ -1,6 +1,7 @@
 #include "compositemaprenderer.hpp"
 
 #include <osg/FrameBufferObject>
+#include <osg/Image>
 #include <osg/Texture2D>
 #include <osg/RenderInfo>
 
@@ -92,7 +93,7 @@ void CompositeMapRenderer::compile(CompositeMap &compositeMap, osg::RenderInfo &
 
     osg::FrameBufferAttachment attach (compositeMap.mTexture);
     mFBO->setAttachment(osg::Camera::COLOR_BUFFER, attach);
-    mFBO->apply(state, osg::FrameBufferObject::DRAW_FRAMEBUFFER);
+    mFBO->apply(state, compositeMap.mReadBack ? osg::FrameBufferObject::READ_DRAW_FRAMEBUFFER : osg::FrameBufferObject::DRAW_FRAMEBUFFER);
 
     GLenum status = ext->glCheckFramebufferStatus(GL_FRAMEBUFFER_EXT);
 
@@ -138,8 +139,18 @@ void CompositeMapRenderer::compile(CompositeMap &compositeMap, osg::RenderInfo &
         }
     }
     if (compositeMap.mCompiled == compositeMap.mDrawables.size())
+    {
         compositeMap.mDrawables = std::vector<osg::ref_ptr<osg::Drawable>>();
 
+        if (compositeMap.mReadBack)
+        {
+            osg::ref_ptr<osg::Image> image = new osg::Image;
+            image->readPixels(0, 0, compositeMap.mTexture->getTextureWidth(), compositeMap.mTexture->getTextureHeight(), GL_RGB, GL_UNSIGNED_BYTE);
+            compositeMap.mReadBack(image);
+            compositeMap.mReadBack = nullptr;
+        }
+    }
+
     state.haveAppliedAttribute(osg::StateAttribute::VIEWPORT);
 
     GLuint fboId = state.getGraphicsContext() ? state.getGraphicsContext()->getDefaultFboId() : 0;
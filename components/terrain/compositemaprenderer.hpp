@@ -3,12 +3,14 @@
 
 #include <osg/Drawable>
 
+#include <functional>
 #include <set>
 #include <mutex>
 
 namespace osg
 {
     class FrameBufferObject;
+    class Image;
     class RenderInfo;
     class Texture2D;
 }
@@ -24,6 +26,8 @@ namespace Terrain
         std::vector<osg::ref_ptr<osg::Drawable> > mDrawables;
         osg::ref_ptr<osg::Texture2D> mTexture;
         unsigned int mCompiled;
+        /// Called from the draw thread with the contents of the texture once it is fully rendered
+        std::function<void(osg::ref_ptr<osg::Image>)> mReadBack;
     };
 
     /**
@@ -0,0 +1,222 @@
+#include "diskcache.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include <osgDB/ReaderWriter>
+#include <osgDB/Registry>
+
+#include <components/debug/debuglog.hpp>
+#include <components/misc/hash.hpp>
+
+namespace Terrain
+{
+    namespace
+    {
+        constexpr char sMagic[4] = {'O', 'M', 'W', 'T'};
+        constexpr std::uint32_t sFormatVersion = 1;
+
+        struct Header
+        {
+            char mMagic[4];
+            std::uint32_t mVersion;
+            std::uint64_t mHash;
+            std::uint32_t mCount;
+        };
+
+        std::string makeHeader(std::uint64_t hash, std::uint32_t count)
+        {
+            Header header {};
+            std::memcpy(header.mMagic, sMagic, sizeof(sMagic));
+            header.mVersion = sFormatVersion;
+            header.mHash = hash;
+            header.mCount = count;
+            return std::string(reinterpret_cast<const char*>(&header), sizeof(header));
+        }
+
+        bool readHeader(std::istream& stream, std::uint64_t hash, std::uint32_t& count)
+        {
+            Header header;
+            if (!stream.read(reinterpret_cast<char*>(&header), sizeof(header)))
+                return false;
+            if (std::memcmp(header.mMagic, sMagic, sizeof(sMagic)) != 0 || header.mVersion != sFormatVersion || header.mHash != hash)
+                return false;
+            count = header.mCount;
+            return true;
+        }
+
+        template <class ArrayType>
+        void appendArray(std::string& data, const ArrayType& array)
+        {
+            data.append(static_cast<const char*>(array.getDataPointer()), array.getTotalDataSize());
+        }
+
+        template <class ArrayType>
+        bool readArray(std::istream& stream, ArrayType& array, std::uint32_t count)
+        {
+            array.resize(count);
+            if (count == 0)
+                return true;
+            return static_cast<bool>(stream.read(reinterpret_cast<char*>(&array[0]), array.getTotalDataSize()));
+        }
+    }
+
+    DiskCache::DiskCache(const std::filesystem::path& path, std::size_t contentHash)
+        : mPath(path)
+        , mContentHash(contentHash)
+        , mStop(false)
+    {
+        std::error_code ec;
+        std::filesystem::create_directories(mPath, ec);
+        if (ec)
+            Log(Debug::Warning) << "Failed to create terrain cache directory " << mPath << ": " << ec.message();
+
+        mThread = std::thread([this] { run(); });
+    }
+
+    DiskCache::~DiskCache()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mStop = true;
+        }
+        mHasTask.notify_all();
+        mThread.join();
+    }
+
+    std::filesystem::path DiskCache::getPath(const char* prefix, float size, const osg::Vec2f& center, int lod) const
+    {
+        std::ostringstream stream;
+        stream.precision(10);
+        stream << prefix << '_' << center.x() << '_' << center.y() << '_' << size << '_' << lod << ".bin";
+        return mPath / stream.str();
+    }
+
+    bool DiskCache::loadVertexBuffers(float size, const osg::Vec2f& center, int lod, std::size_t landHash,
+                                      osg::Vec3Array& positions, osg::Vec3Array& normals, osg::Vec4ubArray& colours) const
+    {
+        std::ifstream stream(getPath("vertices", size, center, lod), std::ios::binary);
+        if (!stream.is_open())
+            return false;
+
+        std::uint32_t count = 0;
+        if (!readHeader(stream, landHash, count))
+            return false;
+
+        return readArray(stream, positions, count) && readArray(stream, normals, count) && readArray(stream, colours, count);
+    }
+
+    void DiskCache::saveVertexBuffers(float size, const osg::Vec2f& center, int lod, std::size_t landHash,
+                                      const osg::Vec3Array& positions, const osg::Vec3Array& normals, const osg::Vec4ubArray& colours)
+    {
+        if (normals.size() != positions.size() || colours.size() != positions.size())
+            return;
+
+        std::string data = makeHeader(landHash, positions.size());
+        appendArray(data, positions);
+        appendArray(data, normals);
+        appendArray(data, colours);
+
+        enqueue([this, path = getPath("vertices", size, center, lod), data = std::move(data)] { write(path, data); });
+    }
+
+    osg::ref_ptr<osg::Image> DiskCache::loadCompositeMap(float size, const osg::Vec2f& center, std::size_t landHash, unsigned int resolution) const
+    {
+        std::ifstream stream(getPath("composite", size, center, 0), std::ios::binary);
+        if (!stream.is_open())
+            return nullptr;
+
+        std::size_t hash = landHash;
+        Misc::hashCombine(hash, mContentHash);
+        std::uint32_t count = 0;
+        if (!readHeader(stream, hash, count))
+            return nullptr;
+
+        osgDB::ReaderWriter* readerwriter = osgDB::Registry::instance()->getReaderWriterForExtension("png");
+        if (!readerwriter)
+            return nullptr;
+
+        osgDB::ReaderWriter::ReadResult result = readerwriter->readImage(stream);
+        if (!result.success())
+            return nullptr;
+
+        osg::ref_ptr<osg::Image> image = result.getImage();
+        if (image->s() != static_cast<int>(resolution) || image->t() != static_cast<int>(resolution))
+            return nullptr;
+        return image;
+    }
+
+    void DiskCache::saveCompositeMap(float size, const osg::Vec2f& center, std::size_t landHash, osg::ref_ptr<osg::Image> image)
+    {
+        std::size_t hash = landHash;
+        Misc::hashCombine(hash, mContentHash);
+
+        enqueue([this, path = getPath("composite", size, center, 0), hash, image]
+        {
+            osgDB::ReaderWriter* readerwriter = osgDB::Registry::instance()->getReaderWriterForExtension("png");
+            if (!readerwriter)
+                return;
+
+            std::ostringstream stream;
+            osgDB::ReaderWriter::WriteResult result = readerwriter->writeImage(*image, stream);
+            if (!result.success())
+            {
+                Log(Debug::Warning) << "Failed to encode terrain composite map: " << result.message();
+                return;
+            }
+
+            write(path, makeHeader(hash, 0) + stream.str());
+        });
+    }
+
+    void DiskCache::write(const std::filesystem::path& path, const std::string& data)
+    {
+        // Write to a temporary file first, so that an interrupted write never leaves a truncated entry behind
+        std::filesystem::path tempPath = path;
+        tempPath += ".tmp";
+        {
+            std::ofstream stream(tempPath, std::ios::binary | std::ios::trunc);
+            if (!stream.write(data.data(), data.size()))
+            {
+                Log(Debug::Warning) << "Failed to write terrain cache file " << tempPath;
+                return;
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(tempPath, path, ec);
+        if (ec)
+            Log(Debug::Warning) << "Failed to write terrain cache file " << path << ": " << ec.message();
+    }
+
+    void DiskCache::enqueue(std::function<void()>&& task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mTasks.push_back(std::move(task));
+        }
+        mHasTask.notify_one();
+    }
+
+    void DiskCache::run()
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        while (true)
+        {
+            mHasTask.wait(lock, [this] { return mStop || !mTasks.empty(); });
+            // Finish the pending writes before stopping, they are cheap compared to generating the data again
+            if (mTasks.empty())
+                return;
+
+            std::function<void()> task = std::move(mTasks.front());
+            mTasks.pop_front();
+
+            lock.unlock();
+            task();
+            lock.lock();
+        }
+    }
+
+}
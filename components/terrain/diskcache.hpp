@@ -0,0 +1,68 @@
+#ifndef OPENMW_COMPONENTS_TERRAIN_DISKCACHE_H
+#define OPENMW_COMPONENTS_TERRAIN_DISKCACHE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <osg/Array>
+#include <osg/Image>
+#include <osg/ref_ptr>
+#include <osg/Vec2f>
+
+namespace Terrain
+{
+
+    /// @brief Keeps terrain chunk vertex data and rendered composite maps on disk so they can be reused in later sessions.
+    /// @par There is one file per chunk, it stores the land hash (see Storage::getLandHash) of the data it was made from.
+    ///     Entries with a different hash are stale and replaced by the next save.
+    class DiskCache
+    {
+    public:
+        /// @param path directory of the cache files, created if needed
+        /// @param contentHash hash of the content files, land textures and settings that affect composite maps,
+        ///     composite maps stored with a different hash are discarded
+        DiskCache(const std::filesystem::path& path, std::size_t contentHash);
+        ~DiskCache();
+
+        /// @note May be called from any thread.
+        bool loadVertexBuffers(float size, const osg::Vec2f& center, int lod, std::size_t landHash,
+                               osg::Vec3Array& positions, osg::Vec3Array& normals, osg::Vec4ubArray& colours) const;
+
+        /// @note May be called from any thread, the file is written in the background.
+        void saveVertexBuffers(float size, const osg::Vec2f& center, int lod, std::size_t landHash,
+                               const osg::Vec3Array& positions, const osg::Vec3Array& normals, const osg::Vec4ubArray& colours);
+
+        /// @note May be called from any thread.
+        osg::ref_ptr<osg::Image> loadCompositeMap(float size, const osg::Vec2f& center, std::size_t landHash, unsigned int resolution) const;
+
+        /// @note May be called from any thread, the image is encoded and written in the background.
+        void saveCompositeMap(float size, const osg::Vec2f& center, std::size_t landHash, osg::ref_ptr<osg::Image> image);
+
+    private:
+        std::filesystem::path getPath(const char* prefix, float size, const osg::Vec2f& center, int lod) const;
+
+        void write(const std::filesystem::path& path, const std::string& data);
+
+        void enqueue(std::function<void()>&& task);
+
+        void run();
+
+        const std::filesystem::path mPath;
+        const std::size_t mContentHash;
+
+        std::mutex mMutex;
+        std::condition_variable mHasTask;
+        std::deque<std::function<void()>> mTasks;
+        bool mStop;
+        std::thread mThread;
+    };
+
+}
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef COMPONENTS_TERRAIN_STORAGE_H
 #define COMPONENTS_TERRAIN_STORAGE_H
 
+#include <cstddef>
 #include <vector>
 
 #include <osg/Vec2f>
@@ -83,6 +84,12 @@ namespace Terrain
         virtual int getCellVertices() = 0;
 
         virtual int getBlendmapScale(float chunkSize) = 0;
+
+        /// Get a hash of the land data used by a terrain chunk, including its neighbours needed for normals and blending.
+        /// Used to detect stale entries of the terrain disk cache.
+        /// @note May be called from background threads.
+        /// @return false if the data can not be identified, the chunk is then never cached
+        virtual bool getLandHash(float size, const osg::Vec2f& center, std::size_t& hash) { return false; }
     };
 
 }
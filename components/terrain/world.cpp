@@ -10,6 +10,7 @@
 #include "texturemanager.hpp"
 #include "chunkmanager.hpp"
 #include "compositemaprenderer.hpp"
+#include "diskcache.hpp"
 
 namespace Terrain
 {
@@ -135,6 +136,13 @@ void World::clearAssociatedCaches()
         mChunkManager->clearCache();
 }
 
+void World::setDiskCache(std::unique_ptr<DiskCache>&& diskCache)
+{
+    mDiskCache = std::move(diskCache);
+    if (mChunkManager)
+        mChunkManager->setDiskCache(mDiskCache);
+}
+
 osg::Callback* World::getHeightCullCallback(float highz, unsigned int mask)
 {
     if (!mHeightCullCallback) return nullptr;
@@ -40,6 +40,7 @@ namespace Terrain
     class TextureManager;
     class ChunkManager;
     class CompositeMapRenderer;
+    class DiskCache;
 
     class HeightCullCallback : public SceneUtil::NodeCallback<HeightCullCallback>
     {
@@ -160,9 +161,16 @@ namespace Terrain
 
         void setActiveGrid(const osg::Vec4i &grid) { mActiveGrid = grid; }
 
+        /// Store generated terrain chunks and composite maps on disk and reuse them when they are requested again.
+        /// @note Call before any chunks are created.
+        void setDiskCache(std::unique_ptr<DiskCache>&& diskCache);
+
     protected:
         Storage* mStorage;
 
+        // Declared before the chunk and composite map users so that it is destroyed last
+        std::shared_ptr<DiskCache> mDiskCache;
+
         osg::ref_ptr<osg::Group> mParent;
         osg::ref_ptr<osg::Group> mTerrainRoot;
 
@@ -2,9 +2,16 @@
 
 #include <vector>
 #include <cassert>
+#include <cstdint>
+#include <cstring>
 #include <stdexcept>
 #include <algorithm>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OPENMW_TO_UTF8_SSE2
+#endif
+
 #include <components/debug/debuglog.hpp>
 
 /* This file contains the code to translate from WINDOWS-1252 (native
@@ -36,7 +43,9 @@
    non-ASCII characters are typically starting and ending quotation
    marks.) Within these, almost all the characters are ASCII. For this
    purpose, the library is also optimized for mostly-ASCII contents
-   even in the cases where some conversion is necessary.
+   even in the cases where some conversion is necessary: the characters
+   are checked 16 or 32 at a time, and the blocks of ASCII characters
+   are copied as they are.
  */
 
 
@@ -47,9 +56,65 @@ using namespace ToUTF8;
 
 namespace
 {
+    // Position of the first character that is not ASCII or is the null terminator, or the size of the input
+    std::size_t findNonAscii(std::string_view input)
+    {
+        const char* const end = input.data() + input.size();
+        const char* it = input.data();
+#ifdef OPENMW_TO_UTF8_SSE2
+        // The sign bit of a byte is set for non-ASCII characters and for the comparison with zero
+        const __m128i zero = _mm_setzero_si128();
+        for (; end - it >= 32; it += 32)
+        {
+            const __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it));
+            const __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it + 16));
+            const __m128i nulls = _mm_or_si128(_mm_cmpeq_epi8(first, zero), _mm_cmpeq_epi8(second, zero));
+            if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(first, second), nulls)) != 0)
+                break;
+        }
+        for (; end - it >= 16; it += 16)
+        {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it));
+            if (_mm_movemask_epi8(_mm_or_si128(chunk, _mm_cmpeq_epi8(chunk, zero))) != 0)
+                break;
+        }
+#else
+        // The high bit of a byte is set for non-ASCII characters and for zero after the subtraction
+        constexpr std::uint64_t ones = 0x0101010101010101;
+        constexpr std::uint64_t highBits = 0x8080808080808080;
+        for (; end - it >= 8; it += 8)
+        {
+            std::uint64_t word;
+            std::memcpy(&word, it, sizeof(word));
+            if (((word - ones) | word) & highBits)
+                break;
+        }
+#endif
+        while (it != end && *it != 0 && static_cast<unsigned char>(*it) < 128)
+            ++it;
+        return static_cast<std::size_t>(it - input.data());
+    }
+
+    constexpr std::size_t sBlockSize = 16;
+
+    // Whether the sBlockSize characters are ASCII and not null
+    bool isAsciiBlock(const char* it)
+    {
+#ifdef OPENMW_TO_UTF8_SSE2
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it));
+        return _mm_movemask_epi8(_mm_or_si128(chunk, _mm_cmpeq_epi8(chunk, _mm_setzero_si128()))) == 0;
+#else
+        constexpr std::uint64_t ones = 0x0101010101010101;
+        constexpr std::uint64_t highBits = 0x8080808080808080;
+        std::uint64_t words[2];
+        std::memcpy(words, it, sizeof(words));
+        return ((((words[0] - ones) | words[0]) | ((words[1] - ones) | words[1])) & highBits) == 0;
+#endif
+    }
+
     std::string_view::iterator skipAscii(std::string_view input)
     {
-        return std::find_if(input.begin(), input.end(), [] (unsigned char v) { return v == 0 || v >= 128; });
+        return input.begin() + findNonAscii(input);
     }
 
     std::basic_string_view<signed char> getTranslationArray(FromType sourceEncoding)
@@ -125,9 +190,21 @@ std::string_view StatelessUtf8Encoder::getUtf8(std::string_view input, BufferAll
     resize(outlen, bufferAllocationPolicy, buffer);
     char *out = buffer.data();
 
-    // Translate
-    for (auto it = input.begin(); it != input.end() && *it != 0; ++it)
-        copyFromArray(*it, out);
+    // Translate, copying the ASCII only blocks as they are
+    std::size_t pos = 0;
+    while (pos < input.size() && input[pos] != 0)
+    {
+        if (input.size() - pos >= sBlockSize && isAsciiBlock(input.data() + pos))
+        {
+            std::memcpy(out, input.data() + pos, sBlockSize);
+            out += sBlockSize;
+            pos += sBlockSize;
+            continue;
+        }
+        const std::size_t blockEnd = std::min(input.size(), pos + sBlockSize);
+        for (; pos < blockEnd && input[pos] != 0; ++pos)
+            copyFromArray(input[pos], out);
+    }
 
     // Make sure that we wrote the correct number of bytes
     assert((out - buffer.data()) == (int)outlen);
@@ -190,24 +267,30 @@ std::pair<std::size_t, bool> StatelessUtf8Encoder::getLength(std::string_view in
 {
     // Do away with the ascii part of the string first (this is almost
     // always the entire string.)
-    auto it = skipAscii(input);
+    std::size_t pos = findNonAscii(input);
 
     // If we're not at the null terminator at this point, then there
-    // were some non-ascii characters to deal with. Go to slow-mode for
-    // the rest of the string.
-    if (it == input.end() || *it == 0)
-        return {it - input.begin(), true};
+    // were some non-ascii characters to deal with.
+    if (pos == input.size() || input[pos] == 0)
+        return {pos, true};
 
-    std::size_t len = it - input.begin();
+    std::size_t len = pos;
 
-    do
+    while (pos < input.size() && input[pos] != 0)
     {
-        // Find the translated length of this character in the
+        // Skip the ascii only blocks at once
+        if (input.size() - pos >= sBlockSize && isAsciiBlock(input.data() + pos))
+        {
+            len += sBlockSize;
+            pos += sBlockSize;
+            continue;
+        }
+        // Find the translated length of each character of the block in the
         // lookup table.
-        len += mTranslationArray[static_cast<unsigned char>(*it) * 6];
-        ++it;
+        const std::size_t blockEnd = std::min(input.size(), pos + sBlockSize);
+        for (; pos < blockEnd && input[pos] != 0; ++pos)
+            len += mTranslationArray[static_cast<unsigned char>(input[pos]) * 6];
     }
-    while (it != input.end() && *it != 0);
 
     return {len, false};
 }
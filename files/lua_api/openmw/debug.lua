@@ -41,4 +41,29 @@
 -- @function [parent=#debug] setNavMeshRenderMode
 -- @param #NAV_MESH_RENDER_MODE value
 
+---
+-- Statistics of a script
+-- @type ScriptStats
+-- @field #number time Total time in seconds spent in the engine handlers, event handlers and timers of the script
+-- @field #number calls Number of calls of the engine handlers, event handlers and timers
+-- @field #number allocated Number of bytes allocated during these calls
+
+---
+-- Returns statistics of all scripts that were called since the start of the game or the last call of `resetScriptStats`.
+-- If a script is attached to several objects, the statistics are summed.
+-- @function [parent=#debug] getScriptStats
+-- @return #map<#string, #ScriptStats> script path -> statistics
+-- @usage for path, stats in pairs(debug.getScriptStats()) do
+--     print(path, stats.calls, stats.time / stats.calls)
+-- end
+
+---
+-- Resets the script statistics (will be applied on next frame).
+-- @function [parent=#debug] resetScriptStats
+
+---
+-- Returns the amount of memory used by Lua in bytes.
+-- @function [parent=#debug] getLuaMemoryUsage
+-- @return #number
+
 return nil
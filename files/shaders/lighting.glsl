@@ -75,6 +75,22 @@ void doLighting(vec3 viewPos, vec3 viewNormal, out vec3 diffuseLight, out vec3 a
     diffuseLight = vec3(0.0);
 #endif
 
+#if @lightingMethodClustered
+    if (ClusteredLighting)
+    {
+        int cluster = lcalcCluster(viewPos);
+        int clusterData = ClusterGrid[cluster >> 2][cluster & 3];
+        int offset = clusterData & 0xffff;
+        int count = clusterData >> 16;
+        for (int i = 0; i < count; ++i)
+        {
+            perLightPoint(ambientOut, diffuseOut, lcalcClusterLight(offset + i), viewPos, viewNormal);
+            ambientLight += ambientOut;
+            diffuseLight += diffuseOut;
+        }
+    }
+    else
+#endif
     for (int i = @startLight; i < @endLight; ++i)
     {
 #if @lightingMethodUBO
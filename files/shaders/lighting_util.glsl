@@ -49,6 +49,38 @@ uniform LightBufferBinding
     LightData LightBuffer[@maxLightsInScene];
 };
 
+#if @lightingMethodClustered
+/* Layout:
+ClusterGrid: offset (low 16 bits) and count (high 16 bits) of the lights of each cluster, 4 clusters per element
+ClusterIndices: light buffer indices of all clusters as 16-bit pairs, 8 indices per element
+*/
+layout(std140) uniform ClusterBufferBinding
+{
+    ivec4 ClusterGrid[@clusterGridSize];
+    ivec4 ClusterIndices[@clusterIndicesSize];
+};
+
+uniform bool ClusteredLighting;
+uniform vec2 ClusterDepthParams;
+
+int lcalcCluster(vec3 viewPos)
+{
+    vec4 clipPos = gl_ProjectionMatrix * vec4(viewPos, 1.0);
+    vec2 screenPos = clamp(clipPos.xy / clipPos.w * 0.5 + 0.5, 0.0, 0.9999);
+    float depth = max(-viewPos.z, ClusterDepthParams.x);
+    int slice = int(min(log(depth / ClusterDepthParams.x) * ClusterDepthParams.y, float(@clusterSlices - 1)));
+    int x = int(screenPos.x * float(@clusterTilesX));
+    int y = int(screenPos.y * float(@clusterTilesY));
+    return (slice * @clusterTilesY + y) * @clusterTilesX + x;
+}
+
+int lcalcClusterLight(int index)
+{
+    int packed = ClusterIndices[index >> 3][(index >> 1) & 3];
+    return (packed >> ((index & 1) * 16)) & 0xffff;
+}
+#endif
+
 #elif @lightingMethodPerObjectUniform
 
 /* Layout: